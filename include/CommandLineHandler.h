@@ -9,11 +9,34 @@ struct CommandLineArgs {
     bool isValid     = false;
     bool testMode    = false;   // --test
     bool glueMode    = false;   // --glue
+    bool sampleMode  = false;   // --sample
+    bool likelihoodMode = false; // --likelihood
+    bool parallelMode   = false; // --parallel-runs
+    bool mergeMode      = false; // --merge
+    bool standInModel   = false; // --stand-in-model (hidden, used by the test suite)
+    bool standInGlue    = false; // --stand-in-glue (hidden, used by the test suite)
+    bool standInRWorker = false; // --stand-in-rworker (hidden, used by the test suite)
     QString cropCode;           // e.g. "WH"
     QString cultivarId;         // e.g. "IB0488"
     QString cultivarName;       // e.g. "NEWTON"
     int     runs     = 100;
     QString mode     = "both";  // phenology|growth|both
+    bool    force    = false;   // --force: ignore cached GLUE results
+    int     sets     = 1000;    // --sets: parameter sets to generate
+    QString method   = "lhs";   // --method uniform|lhs|sobol
+    quint64 seed     = 1;       // --seed
+    int     round    = 1;       // --round 1|2 (GLUEFlag 1 samples P then G)
+    QString outPath;            // --out: output file of --sample / --likelihood
+    QString setsFile;           // --sets-file: RealRandomSets_<round>.txt
+    QString evalFile;           // --eval: EvaluateFrame_<round>.txt
+    int     workers  = 0;       // --workers: parallel model processes (0 = all cores)
+    int     jobs     = 1;       // --jobs: GLUE calibrations run at once
+    bool    json     = false;   // --json: JSON-lines progress events on stdout
+    QString fromFile;           // --from: GLUE cultivar lines to merge
+    bool    converge  = false;  // --converge: check the posterior while runs finish
+    bool    stopEarly = false;  // --stop-early: stop launching runs once converged
+    int     batch     = 50;     // --batch: runs between convergence checks
+    double  tolerance = 0.01;   // --tolerance: allowed mean shift, share of prior range
 };
 
 class CommandLineHandler : public QObject
@@ -32,6 +55,25 @@ public:
 private:
     int runTests();
     int runGlue(const CommandLineArgs &a);
+    int runSample(const CommandLineArgs &a);
+    int runLikelihood(const CommandLineArgs &a);
+    int runParallel(const CommandLineArgs &a);
+    int runMerge(const CommandLineArgs &a);
+    // Mimics DSSAT's file I/O for GlueParallelDriver tests: reads the batch
+    // file and CUL in the working directory and writes Evaluate.OUT.
+    static int runStandInModel(const QStringList &args);
+    // Mimics GLUE.r for GlueJobPipeline tests: reads SimulationControl.csv
+    // in the working directory and writes ModelRunIndicator.txt and the
+    // <ModelID>.CUL with the cultivar's line to OutputD.
+    static int runStandInGlue();
+    // Mimics GlueWorker.R for GlueRWorker tests: answers JOB lines on stdin
+    // by acting out the script's lines (echo/write <text>, sleep <ms>,
+    // exit <code>, exit-once <code>) and ends each with the @@DONE marker.
+    static int runStandInRWorker();
+
+    // DSSATPRO crop lookup shared by the headless modes; prefers the primary model
+    static bool findCrop(const QString &cropCode, CropInfo &cropInfo);
+    static int glueFlagForMode(const QString &mode);
 
     static void printUsage();
 };
@@ -21,6 +21,8 @@ namespace Config {
     const QString APP_NAME    = "GeneticsEditor";
     const QString APP_VERSION = GEN2_VERSION_FULL;
     const QString ORG_NAME    = "DSSAT";
+    // Application name QSettings are kept under; the test suite swaps in its own
+    inline QString SETTINGS_APP = APP_NAME;
 
 #ifdef Q_OS_WIN
     const QString DSSAT_BASE      = "C:\\DSSAT48";
@@ -4,8 +4,18 @@
 #include <QAbstractTableModel>
 #include <QVector>
 #include <QStringList>
+#include <QBrush>
+#include <QFont>
+#include <QSet>
+#include <QHash>
+#include <QRect>
+#include <QBitArray>
 #include <optional>
 #include "CulParser.h"
+#include "TableSnapshot.h"
+#include "TableEditBatch.h"
+#include "IdentifierIndex.h"
+#include "TableUndo.h"
 
 class CulTableModel : public QAbstractTableModel
 {
@@ -16,7 +26,30 @@ public:
 
     // Load/store
     void setRows(const QVector<CulRow> &rows);
-    QVector<CulRow> rows() const { return m_rows; }
+    const QVector<CulRow> &rows() const { return m_rows; }
+    const CulRow &rowAt(int row) const { return m_rows.at(row); }
+    using const_iterator = QVector<CulRow>::const_iterator;
+    const_iterator begin() const { return m_rows.cbegin(); }
+    const_iterator end() const { return m_rows.cend(); }
+    // First row with this VAR# (trimmed, any case), or -1; no table scan
+    int rowOfVarNum(const QString &varNum) const { return m_varIndex.rowOf(varNum); }
+    const IdentifierIndex &varNumIndex() const { return m_varIndex; }
+    // Reverse index of the ECO# column: cultivar rows (not MINIMA/MAXIMA)
+    // using an ecotype, and their count per normalized ECO#
+    QVector<int> rowsUsingEco(const QString &ecoNum) const;
+    int ecoRefCount(const QString &ecoNum) const { return rowsUsingEco(ecoNum).size(); }
+    QHash<QString, int> ecoRefCounts() const;
+
+    // Columnar reads for filters over rows [first, first + count):
+    // parameter cells as numbers, everything else as text
+    void textColumn(int col, int first, int count, QVector<QString> *out) const;
+    void numberColumn(int col, int first, int count, QVector<double> *values, QBitArray *present) const;
+
+    // Rows and parameter names for a save or validation thread
+    using Snapshot = TableSnapshot<CulRow>;
+    Snapshot snapshot() const { return Snapshot(m_rows, m_paramNames, m_generation); }
+    // Bumped by every change to rows or parameter names
+    quint64 generation() const { return m_generation; }
 
     // MINIMA/MAXIMA rows for range validation
     void setMinMaxRows(const CulRow *minRow, const CulRow *maxRow);
@@ -38,6 +71,34 @@ public:
     void duplicateRow(int row);
     void deleteRow(int row);
     void setRowPreComment(int row, const QString &comment);
+    // Bulk edits: between beginBatch() and commitBatch() cell changes are
+    // collected and announced as one dataChanged over their bounding range,
+    // one violationsChanged and one dataModified. Inserted or removed rows
+    // are still announced at once, as the view requires.
+    void beginBatch();
+    void commitBatch();
+    using EditBatch = TableEditBatch<CulTableModel>;
+
+    // Undo history: every edit, or every batch, becomes one step on stack.
+    // Steps hold the changed rows before and after; loading rows or
+    // parameter names clears the stack.
+    using RowChange = TableRowChange<CulRow>;
+    void setUndoStack(QUndoStack *stack);
+
+    // Spreadsheet-style column formula, kept as value * scale + offset:
+    // "*1.05", "/2", "+0.1", "-3", "=4.5" or a bare number (set)
+    struct Formula {
+        double scale  = 1.0;
+        double offset = 0.0;
+        static bool parse(const QString &text, Formula *out, QString *errorMsg = nullptr);
+    };
+    // Applies f to parameter paramIdx of the given rows in one batch; empty
+    // cells and MINIMA/MAXIMA are left alone. Returns the cells changed.
+    int applyFormula(int paramIdx, const QVector<int> &rows, const Formula &f);
+
+    // Take a merged copy of rows() in one step: rows past the current count are
+    // inserted, changedRows are repainted, dataModified() fires once
+    void applyMerged(const QVector<CulRow> &rows, const QVector<int> &changedRows);
 
     // Column indices
     static const int COL_VARNUM  = 0;
@@ -52,7 +113,7 @@ public:
     // Column name for a given section index
     QString columnName(int col) const;
 
-    void setColumnTooltips(const QMap<QString, QString> &tips) { m_tips = tips; }
+    void setColumnTooltips(const QMap<QString, QString> &tips);
     void setCalibrationTypes(const QMap<QString, QString> &types);
     void setCalibrationTypeForParam(const QString &paramName, const QString &type);
     QMap<QString, QString> calibrationTypes() const { return m_calibTypes; }
@@ -60,6 +121,7 @@ public:
     // Validation: returns a list of violations (e.g., "CAND01: PPSEN=0.5 (range: -0.2 to -0.04)")
     struct Violation {
         int row;
+        int paramIdx;
         QString varNum;
         QString paramName;
         double value;
@@ -67,21 +129,89 @@ public:
         double maxVal;
         QString toString() const;
     };
+    // Built from the live index of out-of-range cells, in row order
     QVector<Violation> getViolations() const;
+    int violationCount() const { return m_violations.size(); }
+
+    // Render state of a parameter cell, kept up to date by every mutation
+    // so data() never re-evaluates ranges while painting
+    enum CellFlag : quint8 {
+        CellEmpty      = 0x1,
+        CellInRange    = 0x2,   // value inside MINIMA..MAXIMA, or no range known
+        CellOutOfRange = 0x4,
+        CellMinMax     = 0x8,   // cell of the MINIMA/MAXIMA rows
+    };
+    quint8 cellState(int row, int paramIdx) const;
 
 signals:
     void dataModified();
+    // The out-of-range cells changed, or the value or VAR# of one did
+    void violationsChanged(int count);
+    // Cultivars were added to, removed from or moved between these ECO#s
+    // (normalized); not emitted for setRows(), which resets the model
+    void ecoRefsChanged(const QStringList &ecoNums);
     void calibrationTypeChanged(const QString &paramName, const QString &type);
 
 private:
+    struct ParamRange {
+        double  lo = 0, hi = 0;
+        bool    valid = false;    // both bounds set and hi > lo
+        QString allowed;          // "\nAllowed: lo to hi" for tooltips
+    };
+
     bool isOutOfRange(int paramIdx, double value) const;
+    // Change notification, immediate or folded into the open batch
+    void notifyCells(int top, int left, int bottom, int right);
+    void notifyViolations();
+    void notifyModified(bool violations = false);
+    void notifyEcoRefs(const QStringList &ecoNums);
     QString generateUniqueVarNum() const;
+    static bool isRangeRow(const CulRow &row) { return row.varNum == "999991" || row.varNum == "999992"; }
+    // Row storage with caches, indexes, notification and undo kept in step
+    void insertRowAt(int row, const CulRow &r);
+    void removeRowAt(int row);
+    void replaceRow(int row, const CulRow &r);
+    void record(RowChange::Kind kind, int row, const CulRow &before, const CulRow &after);
+    void flushUndo();
+    void clearUndo();
+    friend class TableUndoCommand<CulTableModel>;
+    void replayChanges(const QVector<RowChange> &changes, bool undo);
+    // Whether a row's VAR# counts toward new numbers (not MINIMA/MAXIMA)
+    static bool isNumbered(const CulRow &row) { return !row.isMinMax && !row.varNum.startsWith("99"); }
+    // Cache maintenance: ranges from m_minParams/m_maxParams, then cell states
+    void rebuildRanges();
+    void rebuildCellStates();
+    // Returns true when a cell entered or left the violation index, or the
+    // row holds one whose value or VAR# may have changed
+    bool rebuildRowStates(int row);
+    void rebuildColumnTips();
     QVector<CulRow> m_rows;
+    quint64 m_generation = 0;
+    IdentifierIndex m_varIndex{2};        // VAR#: 2-letter institute code + 4 digits
+    IdentifierIndex m_ecoRefs{1};         // ECO# column, looked up by ecotype
     QVector<std::optional<double>> m_minParams;
     QVector<std::optional<double>> m_maxParams;
     QStringList m_paramNames;
     QMap<QString, QString> m_tips;
     QMap<QString, QString> m_calibTypes;  // paramName -> "P" | "G" | "N"
+
+    QVector<ParamRange> m_ranges;         // per parameter
+    QVector<quint8>     m_cellState;      // rowCount × m_paramNames.size(), row-major
+    QSet<qint64>        m_violations;     // m_cellState offsets of CellOutOfRange cells
+    QVector<QString>    m_colTips;        // per column
+    QVariant m_minMaxBrush;
+    QVariant m_oorBrush;
+    QVariant m_boldFont;
+
+    int   m_batchDepth = 0;
+    QRect m_batchCells;                   // x = column, y = row
+    bool  m_batchViolations = false;
+    bool  m_batchModified   = false;
+    QSet<QString> m_batchEcoRefs;
+
+    QUndoStack *m_undoStack = nullptr;
+    QVector<RowChange> m_undoPending;     // changes of the open batch
+    bool m_replaying = false;
 };
 
 #endif // CULTABLEMODEL_H
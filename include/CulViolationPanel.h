@@ -0,0 +1,39 @@
+#ifndef CULVIOLATIONPANEL_H
+#define CULVIOLATIONPANEL_H
+
+#include <QWidget>
+#include <QListWidget>
+#include <QLabel>
+#include <QTimer>
+#include "CulTableModel.h"
+
+// Lists the out-of-range cells of a CulTableModel. The list is rebuilt from
+// the model's violation index, at most once per event-loop pass and only
+// while the panel is visible; activating an entry asks to show the cell.
+class CulViolationPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit CulViolationPanel(CulTableModel *model, QWidget *parent = nullptr);
+
+signals:
+    // Source-model coordinates of the chosen violation
+    void cellActivated(int row, int column);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+
+private slots:
+    void scheduleRefresh();
+    void refresh();
+
+private:
+    CulTableModel *m_model;
+    QLabel        *m_summary;
+    QListWidget   *m_list;
+    QTimer         m_refreshTimer;
+    bool           m_stale = true;
+};
+
+#endif // CULVIOLATIONPANEL_H
@@ -4,8 +4,15 @@
 #include <QAbstractTableModel>
 #include <QVector>
 #include <QMap>
+#include <QHash>
+#include <QRect>
+#include <QBitArray>
 #include <optional>
 #include "EcoParser.h"
+#include "TableSnapshot.h"
+#include "TableEditBatch.h"
+#include "IdentifierIndex.h"
+#include "TableUndo.h"
 
 class EcoTableModel : public QAbstractTableModel
 {
@@ -15,10 +22,31 @@ public:
     explicit EcoTableModel(QObject *parent = nullptr);
 
     void setRows(const QVector<EcoRow> &rows);
-    QVector<EcoRow> rows() const { return m_rows; }
+    const QVector<EcoRow> &rows() const { return m_rows; }
+    const EcoRow &rowAt(int row) const { return m_rows.at(row); }
+    using const_iterator = QVector<EcoRow>::const_iterator;
+    const_iterator begin() const { return m_rows.cbegin(); }
+    const_iterator end() const { return m_rows.cend(); }
+    // First row with this ECO# (trimmed, any case), or -1; no table scan
+    int rowOfEcoNum(const QString &ecoNum) const { return m_ecoIndex.rowOf(ecoNum); }
+    const IdentifierIndex &ecoNumIndex() const { return m_ecoIndex; }
 
-    // Count how many CUL rows reference each ECO#
-    void setCulCrossRef(const QMap<QString, int> &refCounts) { m_refCounts = refCounts; }
+    // Columnar reads for filters over rows [first, first + count):
+    // REFS and parameter cells as numbers, everything else as text
+    void textColumn(int col, int first, int count, QVector<QString> *out) const;
+    void numberColumn(int col, int first, int count, QVector<double> *values, QBitArray *present) const;
+
+    // Rows for a save or validation thread
+    using Snapshot = TableSnapshot<EcoRow>;
+    Snapshot snapshot() const { return Snapshot(m_rows, QStringList(), m_generation); }
+    // Bumped by every change to rows
+    quint64 generation() const { return m_generation; }
+
+    // How many CUL rows reference each ECO# (keys normalized as in
+    // IdentifierIndex); repaints the whole REFS column
+    void setCulCrossRef(const QHash<QString, int> &refCounts);
+    // One ECO#'s count changed; repaints only the REFS cells of its rows
+    void setCulRefCount(const QString &ecoNum, int count);
 
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
     int columnCount(const QModelIndex &parent = QModelIndex()) const override;
@@ -35,6 +63,15 @@ public:
     void duplicateRow(int row);
     void deleteRow(int row);
 
+    // Bulk edits, as on CulTableModel: one dataChanged and one dataModified
+    void beginBatch();
+    void commitBatch();
+    using EditBatch = TableEditBatch<EcoTableModel>;
+
+    // Undo history, as on CulTableModel; setRows() clears the stack
+    using RowChange = TableRowChange<EcoRow>;
+    void setUndoStack(QUndoStack *stack);
+
     static const int COL_ECONUM  = 0;
     static const int COL_ECONAME = 1;
     static const int COL_MG      = 2;
@@ -51,9 +88,30 @@ signals:
 
 private:
     QString generateUniqueEcoNum() const;
+    int refCount(const EcoRow &row) const { return m_refCounts.value(IdentifierIndex::normalize(row.ecoNum), 0); }
+    void notifyCells(int top, int left, int bottom, int right);
+    void notifyModified();
+    // Row storage with the index, notification and undo kept in step
+    void insertRowAt(int row, const EcoRow &r);
+    void removeRowAt(int row);
+    void replaceRow(int row, const EcoRow &r);
+    void record(RowChange::Kind kind, int row, const EcoRow &before, const EcoRow &after);
+    void flushUndo();
+    friend class TableUndoCommand<EcoTableModel>;
+    void replayChanges(const QVector<RowChange> &changes, bool undo);
     QVector<EcoRow> m_rows;
-    QMap<QString, int> m_refCounts;
+    quint64 m_generation = 0;
+    IdentifierIndex m_ecoIndex{1};        // ECO#: 1-letter prefix + 4 digits
+    QHash<QString, int> m_refCounts;
     QMap<QString, QString> m_tips;
+
+    int   m_batchDepth = 0;
+    QRect m_batchCells;                   // x = column, y = row
+    bool  m_batchModified = false;
+
+    QUndoStack *m_undoStack = nullptr;
+    QVector<RowChange> m_undoPending;     // changes of the open batch
+    bool m_replaying = false;
 };
 
 #endif // ECOTABLEMODEL_H
@@ -0,0 +1,70 @@
+#ifndef GLUECONVERGENCEMONITOR_H
+#define GLUECONVERGENCEMONITOR_H
+
+#include <QString>
+#include <QVector>
+#include "GlueLikelihood.h"
+
+struct GlueConvergenceOptions {
+    int    batchSize    = 50;     // finished runs between checks
+    int    minRuns      = 100;    // no verdict before this many runs
+    double tolerance    = 0.01;   // allowed shift of a posterior mean, as a share of the prior range
+    int    stableChecks = 3;      // consecutive checks within tolerance to call it converged
+    bool   stopEarly    = false;  // stop launching runs once converged
+};
+
+struct GlueConvergenceCheck {
+    int     runs     = 0;         // finished runs when the check was made
+    int     bestSet  = -1;        // 0-based max-likelihood set
+    double  effectiveSampleSize = 0;
+    double  maxShift = 0;         // largest change since the last check (share of prior range)
+    QString driftParam;           // parameter with that change
+    bool    bestStable = false;   // max-likelihood set (or its values) unchanged
+    int     stableCount = 0;      // consecutive checks within tolerance
+    bool    converged = false;
+    QVector<GlueParamPosterior> posterior;
+
+    QString summary() const;
+};
+
+// Follows the GLUE posterior while model runs finish. Every batchSize runs
+// the likelihood of the runs so far is evaluated; the calibration has
+// converged once the max-likelihood set and every posterior mean have
+// moved less than the tolerance for stableChecks checks in a row. A run
+// that ends unconverged should get more sets next time (needsMoreRuns()).
+class GlueConvergenceMonitor
+{
+public:
+    explicit GlueConvergenceMonitor(const GlueConvergenceOptions &options = GlueConvergenceOptions());
+
+    // Prior ranges come from the sets; clears the history
+    void reset(const GlueParamMatrix &sets);
+
+    bool due(int finishedRuns) const { return finishedRuns >= m_nextCheck; }
+    // Evaluate table (rows of the finished runs) and compare with the last check
+    const GlueConvergenceCheck &check(const GlueEvalTable &table, int finishedRuns);
+
+    const GlueConvergenceOptions &options() const { return m_options; }
+    const QVector<GlueConvergenceCheck> &history() const { return m_history; }
+    bool converged() const { return !m_history.isEmpty() && m_history.last().converged; }
+    bool needsMoreRuns() const { return !m_history.isEmpty() && !converged(); }
+    // "converged after N runs" or which parameter is still moving
+    QString verdict() const;
+
+    // Run the checks over a finished round in dir (RealRandomSets_<round>.txt
+    // and EvaluateFrame_<round>.txt), taking the runs in set order
+    bool replay(const QString &dir, int round, QString *errorMsg = nullptr);
+
+    // Verdict for every round of a finished GLUE run in dir (GLWork or a
+    // snapshot), checked every tenth of `runs`; empty when nothing to read
+    static QString assessRun(const QString &dir, int runs, bool *needsMoreRuns = nullptr);
+
+private:
+    GlueConvergenceOptions m_options;
+    GlueParamMatrix m_sets;
+    QVector<double> m_range;      // max - min of each parameter over the sets
+    QVector<GlueConvergenceCheck> m_history;
+    int m_nextCheck = 0;
+};
+
+#endif // GLUECONVERGENCEMONITOR_H
@@ -0,0 +1,168 @@
+#ifndef GLUEJOBPIPELINE_H
+#define GLUEJOBPIPELINE_H
+
+#include <QObject>
+#include <QList>
+#include <QProcess>
+#include <QTimer>
+#include <QThreadPool>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include "DssatProParser.h"
+#include "GlueRunner.h"
+#include "GlueResourceSampler.h"
+
+class GlueLogBuffer;
+class GlueRWorker;
+class QSocketNotifier;
+
+struct GlueJobSpec {
+    CropInfo     cropInfo;
+    QString      cultivarId;
+    QString      cultivarName;
+    TreatmentMap treatments;
+    int          runs     = 100;
+    int          glueFlag = 1;
+    QString      ecoCalib = "N";
+    QString      snapshotDir;            // copy of the finished work dir; empty = none
+    GlueLogBuffer *log = nullptr;        // console output; the job gets its own log when null
+};
+
+struct GlueJobResult {
+    bool    ok        = false;   // R exited 0 and printed no error pattern
+    bool    cancelled = false;
+    bool    launched  = false;   // prepared and handed to R
+    int     exitCode  = 0;
+    QString culLine;             // calibrated line of <module>.CUL in the work dir
+    QString errorMsg;            // prepare/launch failure or stderr tail
+    QString workDir;             // GLUE's OutputD for the job
+    QString logFile;
+    double  wallSeconds = 0;
+    GlueResourceUsage resources;
+    QString convergence;         // GlueConvergenceMonitor verdict, filled in by jobAssessed
+    bool    needsMoreRuns = false;
+};
+
+enum class GlueJobStage { Queued, Prepared, Running, Harvested, Done, Dropped };
+
+// Runs GLUE.r jobs through five stages: prepare (batch file and
+// SimulationControl.csv), launch (Rscript or the resident worker), monitor
+// (ModelRunIndicator.txt, resources, console), harvest (exit status and the
+// calibrated CUL line) and snapshot (copy of the work dir, on a pool thread).
+// Everything is event-loop driven; nothing blocks.
+//
+// SharedLayout keeps the GUI's single GLUE_DIR/GLUE_WORK, so a job is
+// prepared just before it starts and the next one waits for its snapshot.
+// In SandboxLayout every job has GLWork/Jobs/<crop>_<cultivar>_<job id>
+// with its own SimulationControl.csv: up to `concurrency` jobs run, the
+// next ones are prepared while they do and finished jobs are copied in the
+// background.
+// Jobs can be added while the pipeline runs; finished() fires each time it
+// drains.
+class GlueJobPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Layout { SharedLayout, SandboxLayout };
+
+    explicit GlueJobPipeline(QObject *parent = nullptr);
+    ~GlueJobPipeline() override;
+
+    // Returns the job id (0, 1, … in order of adding)
+    int  addJob(const GlueJobSpec &spec);
+    // Forget a job that has not been launched yet
+    bool dropJob(int id);
+
+    void setLayout(Layout layout) { m_layout = layout; }
+    Layout layout() const { return m_layout; }
+    void setConcurrency(int jobs) { m_concurrency = qMax(1, jobs); }
+    // Let a single job write straight to this process's stdout/stderr
+    // (no copy through the pipeline); otherwise output goes to the job's log
+    void setForwardOutput(bool forward) { m_forward = forward; }
+    // Interpreter and arguments before the script; default findRTerm() --slave
+    void setProgram(const QString &program, const QStringList &arguments);
+    // Launch through one resident R interpreter (GlueRWorker), one job at a time
+    void setResidentWorker(bool enabled);
+
+    bool start(QString *errorMsg = nullptr);
+    // Stop every job, terminating each R process together with its DSSAT children
+    void cancel(const QString &reason);
+
+    // Route SIGINT/SIGTERM (console Ctrl+C/close on Windows) to cancel()
+    void catchTerminationSignals();
+
+    int  jobCount() const { return m_jobs.size(); }
+    int  failedJobs() const { return m_failed; }
+    int  pendingJobs() const;   // added, not launched
+    bool isRunning() const { return m_started; }
+    GlueJobStage stage(int id) const;
+    const GlueJobResult &result(int id) const { return m_jobs[id]->result; }
+    const GlueJobSpec &spec(int id) const { return m_jobs[id]->spec; }
+    GlueLogBuffer *log(int id) const { return m_jobs[id]->log; }
+
+signals:
+    void jobStarted(int id);
+    void jobProgress(int id, const GlueProgress &progress);
+    // Harvested: the result is final but for the convergence verdict; the
+    // assessment and the snapshot may still be running
+    void jobFinished(int id, const GlueJobResult &result);
+    void jobSnapshotted(int id, bool ok);
+    // The convergence verdict of a successful job, read in the background
+    void jobAssessed(int id, const GlueJobResult &result);
+    // {"event": "start"|"progress"|"finished"|"convergence"|"snapshot"|"cancel"|"done", "job": <cultivar>, …}
+    void event(const QJsonObject &event);
+    void finished(int exitCode);
+
+private slots:
+    void onSignalReceived();
+
+private:
+    struct Job {
+        int          id = -1;
+        GlueJobSpec  spec;
+        GlueJobStage stage = GlueJobStage::Queued;
+        QString      runDir;       // R's working directory
+        QProcess    *proc = nullptr;
+        qint64       pid  = 0;     // kept after exit: leads the job's process group
+        GlueLogBuffer *log = nullptr;
+        GlueProgress progress;
+        GlueResourceSampler sampler;
+        QElapsedTimer wall;
+        GlueJobResult result;
+    };
+
+    void schedule();
+    void scheduleLater();
+    bool prepare(Job &job, QString *errorMsg);
+    void launch(Job &job);
+    void poll();
+    void harvest(Job &job, int exitCode, QProcess::ExitStatus status, const QString &message = QString());
+    void assess(Job &job);
+    void onAssessed(int id, const QString &convergence, bool needsMoreRuns);
+    void snapshot(Job &job);
+    void onSnapshotDone(int id, bool ok);
+    void killTree(QProcess *proc);
+    void emitEvent(const QString &type, const Job *job, QJsonObject fields = QJsonObject());
+
+    QList<Job *> m_jobs;
+    Layout       m_layout = SandboxLayout;
+    QString      m_program;
+    QStringList  m_programArgs;
+    QTimer       m_pollTimer;
+    QThreadPool  m_snapshotPool;
+    GlueRWorker *m_worker = nullptr;
+    int  m_workerJob   = -1;
+    bool m_resident    = false;
+    int  m_concurrency = 1;
+    int  m_active      = 0;    // launched, not harvested
+    int  m_copying     = 0;    // snapshots and assessments in flight
+    int  m_failed      = 0;
+    bool m_started     = false;
+    bool m_scheduled   = false;
+    bool m_forward     = false;
+    bool m_cancelled   = false;
+    QSocketNotifier *m_signalNotifier = nullptr;
+};
+
+#endif // GLUEJOBPIPELINE_H
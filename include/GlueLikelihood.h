@@ -0,0 +1,73 @@
+#ifndef GLUELIKELIHOOD_H
+#define GLUELIKELIHOOD_H
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <vector>
+#include "GlueParamSampler.h"
+
+// Whitespace-separated table as written by GLUE's model-run step
+// (EvaluateFrame_<round>.txt): one header line, then one row per treatment
+// and model run. Simulated/measured pairs follow the Evaluate.OUT naming
+// (ADAPS / ADAPM); RUN is the 1-based parameter-set number; -99 is missing.
+struct GlueEvalTable {
+    QStringList columns;
+    std::vector<std::vector<double>> data;   // data[column][row]
+    int rows = 0;
+
+    int column(const QString &name) const;   // -1 if absent
+};
+
+struct GlueLikelihoodResult {
+    QStringList         variables;       // stems with both S and M columns, e.g. "ADAP"
+    QVector<double>     sigma;           // error SD used for each variable
+    std::vector<double> logLikelihood;   // per set; -inf when the run failed
+    std::vector<double> weights;         // normalized posterior weights (sum 1)
+    int    bestSet = -1;                 // 0-based max-probability set
+    double effectiveSampleSize = 0;      // 1 / Σ w²
+    QString errorMsg;
+};
+
+struct GlueParamPosterior {
+    QString name;
+    double best   = 0;   // value in the max-probability set
+    double mean   = 0;
+    double sd     = 0;
+    double q05    = 0;
+    double median = 0;
+    double q95    = 0;
+};
+
+// Native replacement for the likelihood and posterior phases of GLUE.R.
+// Each observation contributes a Gaussian log-density with the variable's
+// error SD; the SD defaults to the spread of that variable's observations.
+// Posterior weights are the likelihoods normalized with log-sum-exp.
+class GlueLikelihood
+{
+public:
+    static bool readTable(const QString &filePath, GlueEvalTable &table, QString *errorMsg = nullptr);
+    // Add the lines of text to table; the first header line sets the columns
+    static void appendRows(GlueEvalTable &table, const QByteArray &text);
+
+    // Empty variables = every S/M pair in the table.
+    static GlueLikelihoodResult evaluate(const GlueEvalTable &table, int sets,
+                                         const QStringList &variables = {});
+    // Same result as evaluate() on readTable(filePath), read in two streamed
+    // passes: memory grows with the number of sets, not with the table
+    static GlueLikelihoodResult evaluateFile(const QString &filePath, int sets,
+                                             const QStringList &variables = {});
+
+    static QVector<GlueParamPosterior> posterior(const GlueParamMatrix &paramSets,
+                                                 const GlueLikelihoodResult &result);
+
+    // Max-probability set followed by the posterior table, one parameter per line.
+    static bool writeReport(const QString &filePath,
+                            const GlueLikelihoodResult &result,
+                            const QVector<GlueParamPosterior> &stats);
+
+    static constexpr double MISSING = -99.0;
+};
+
+#endif // GLUELIKELIHOOD_H
@@ -0,0 +1,75 @@
+#ifndef GLUELOGBUFFER_H
+#define GLUELOGBUFFER_H
+
+#include <QObject>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <vector>
+
+// Console output of a GLUE run. The newest `capacity` lines are kept in a
+// ring buffer for display; every line also streams to a log file on disk,
+// so memory stays bounded however chatty R and DSSAT are.
+class GlueLogBuffer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int DEFAULT_CAPACITY = 5000;
+    static const int MAX_LINE_LENGTH  = 2000;   // longer lines are cut in memory, not on disk
+
+    explicit GlueLogBuffer(int capacity = DEFAULT_CAPACITY, QObject *parent = nullptr);
+    ~GlueLogBuffer() override;
+
+    // Start a new log; lines are also written to filePath when given
+    bool reset(const QString &filePath = QString());
+    // Raw process output, split into lines (a trailing partial line waits for more)
+    void append(const QByteArray &data, bool isError = false);
+    void appendLine(const QString &line, bool isError = false);
+    // Emit pending partial lines and flush the file
+    void flush();
+
+    // Lines are numbered from the start of the log; only
+    // [firstLine(), totalLines()) are still held in memory.
+    qint64 totalLines() const { return m_total; }
+    qint64 firstLine() const  { return m_total - qint64(m_ring.size()); }
+    QString line(qint64 index) const;
+    bool    isError(qint64 index) const;
+    QStringList tail(int count, bool errorsOnly = false) const;
+
+    int     capacity() const { return m_capacity; }
+    QString filePath() const { return m_file.fileName(); }
+
+    // Case-insensitive substrings that mark a failed run (e.g. "Error in ")
+    void setWatchPatterns(const QStringList &patterns) { m_watch = patterns; }
+    bool watchMatched() const { return m_watchMatched; }
+
+    // Fill the buffer with the last `capacity` lines of a finished job's log
+    bool loadTail(const QString &filePath);
+
+    // New per-job file under the app data directory; keeps the newest 100 logs
+    static QString jobLogPath(const QString &cropCode, const QString &cultivarId);
+
+signals:
+    // Coalesce in the view: may fire once per process read
+    void linesAppended();
+
+private:
+    struct Entry {
+        QString text;
+        bool    error = false;
+    };
+    void push(const QString &text, bool isError);
+    void splitLines(QByteArray &pending, const QByteArray &data, bool isError);
+
+    int    m_capacity;
+    std::vector<Entry> m_ring;
+    qint64 m_total = 0;
+    QByteArray m_partialOut;
+    QByteArray m_partialErr;
+    QFile  m_file;
+    QStringList m_watch;
+    bool   m_watchMatched = false;
+};
+
+#endif // GLUELOGBUFFER_H
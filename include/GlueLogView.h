@@ -0,0 +1,37 @@
+#ifndef GLUELOGVIEW_H
+#define GLUELOGVIEW_H
+
+#include <QAbstractScrollArea>
+#include <QPointer>
+#include <QTimer>
+#include "GlueLogBuffer.h"
+
+// Read-only view of a GlueLogBuffer that paints only the visible lines.
+// Updates are coalesced to a few per second; while scrolled to the bottom
+// the view follows new output.
+class GlueLogView : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    explicit GlueLogView(QWidget *parent = nullptr);
+
+    void setBuffer(GlueLogBuffer *buffer);
+    GlueLogBuffer *buffer() const { return m_buffer; }
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void contextMenuEvent(QContextMenuEvent *event) override;
+
+private:
+    void refresh();
+    int  visibleRows() const;
+
+    QPointer<GlueLogBuffer> m_buffer;
+    QTimer m_updateTimer;
+    int    m_lineHeight = 14;
+    qint64 m_shownFirst = 0;   // buffer's firstLine() at the last refresh
+};
+
+#endif // GLUELOGVIEW_H
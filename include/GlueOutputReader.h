@@ -0,0 +1,71 @@
+#ifndef GLUEOUTPUTREADER_H
+#define GLUEOUTPUTREADER_H
+
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <vector>
+
+// Reads a whitespace-separated GLUE table one row at a time: a header of
+// column names (leading '@' and R's quotes stripped), then numeric rows.
+// Text cells become NaN; an R row-name column (one token more than the
+// header) is dropped. Memory use does not depend on the file size.
+class GlueTableStream
+{
+public:
+    bool open(const QString &filePath, QString *errorMsg = nullptr);
+    bool rewind();
+    void close() { m_file.close(); }
+
+    const QStringList &columns() const { return m_columns; }
+    int  column(const QString &name) const { return m_columns.indexOf(name); }
+
+    // Advance to the next data row; false at end of file
+    bool next();
+    double value(int col) const { return m_values[col]; }
+    qint64 row() const { return m_row; }   // 0-based index of the current row
+
+private:
+    QFile   m_file;
+    qint64  m_dataStart = 0;
+    QStringList m_columns;
+    std::vector<double> m_values;
+    std::vector<int> m_tokStart, m_tokLen;   // token offsets in the current line
+    qint64  m_row = -1;
+};
+
+struct GlueParamHistogram {
+    QString name;
+    double  lo = 0, hi = 0;          // range of the sampled values
+    std::vector<double> prior;       // share of sets per bin (sums to 1)
+    std::vector<double> posterior;   // likelihood-weighted share per bin
+    double  best = 0;                // value in the most likely set (NaN when unweighted)
+    double  mean = 0, sd = 0;        // posterior moments (prior when unweighted)
+};
+
+struct GlueDistributions {
+    int     round = 0;
+    qint64  sets  = 0;
+    bool    weighted = false;
+    QString weightSource;            // file the likelihoods were taken from
+    QVector<GlueParamHistogram> params;   // sampled parameters only
+    QString errorMsg;
+};
+
+// Per-parameter prior/posterior distributions from GLUE's output tables in a
+// GLWork directory or job snapshot. RealRandomSets_<round>.txt is streamed
+// twice alongside a likelihood table (any *Likelihood*/*Posterior* file for
+// the round with a probability, likelihood or weight column and one row per
+// set). Without one, GlueLikelihood::evaluateFile() scores
+// EvaluateFrame_<round>.txt instead, also streamed.
+class GlueOutputReader
+{
+public:
+    static GlueDistributions distributions(const QString &dir, int round, int bins = 30);
+
+    // Rounds with a RealRandomSets file in dir (1, 2 or both)
+    static QList<int> availableRounds(const QString &dir);
+};
+
+#endif // GLUEOUTPUTREADER_H
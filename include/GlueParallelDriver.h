@@ -0,0 +1,100 @@
+#ifndef GLUEPARALLELDRIVER_H
+#define GLUEPARALLELDRIVER_H
+
+#include <QObject>
+#include <QList>
+#include <QProcess>
+#include <QStringList>
+#include <memory>
+#include <vector>
+#include "DssatProParser.h"
+#include "GlueRunner.h"
+#include "GlueParamSampler.h"
+#include "GlueConvergenceMonitor.h"
+
+struct GlueDriverConfig {
+    CropInfo     cropInfo;
+    QString      cultivarId;
+    QString      cultivarName;
+    TreatmentMap treatments;
+
+    QString      program;        // model executable; default DSSAT_BASE/<cropInfo.exe>
+    QStringList  programPrefix;  // arguments placed before "<ModelID> <runMode> <batch>"
+    QString      runMode = "E";  // DSSAT run mode for cultivar batch files
+    QString      scratchRoot;    // default GLWork/Parallel
+    int          workers = 0;    // 0 = QThread::idealThreadCount()
+};
+
+// Runs one DSSAT simulation per parameter set across K worker processes.
+// Every worker has its own scratch directory holding a copy of the ECO/SPE
+// files, a batch file from GlueRunner::writeBatchFile and the CUL with the
+// cultivar line replaced by the set being run. Idle workers take the next
+// unstarted set, so uneven run times do not leave cores idle. Each run's
+// Evaluate.OUT rows are kept per set and merged back in set order.
+class GlueParallelDriver : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit GlueParallelDriver(QObject *parent = nullptr);
+    ~GlueParallelDriver() override;
+
+    bool start(const GlueDriverConfig &config, const GlueParamMatrix &sets,
+               QString *errorMsg = nullptr);
+    void cancel();
+
+    // Check the posterior every options.batchSize runs (call before start());
+    // with options.stopEarly no further sets are launched once it converges
+    void setConvergence(const GlueConvergenceOptions &options);
+    const GlueConvergenceMonitor *convergence() const { return m_monitor.get(); }
+    bool stoppedEarly() const { return m_limit < m_sets.sets; }
+
+    bool isRunning() const { return m_next >= 0 && (m_active > 0 || m_next < m_limit); }
+    int  totalRuns() const { return m_sets.sets; }
+    int  completedRuns() const { return m_done; }
+    int  failedRuns() const { return m_failed; }
+    int  workerCount() const { return m_workers.size(); }
+
+    // Evaluate rows of every finished run, "@RUN" (1-based set) first,
+    // in the table format read by GlueLikelihood::readTable.
+    bool writeMerged(const QString &filePath) const;
+
+signals:
+    void progress(int done, int total);
+    void convergenceChecked(const GlueConvergenceCheck &check);
+    // success: every set to run was run and at least one produced output
+    void finished(bool success);
+
+private:
+    struct Worker {
+        QProcess *proc = nullptr;
+        QString   dir;
+        int       set  = -1;
+    };
+
+    bool prepareWorker(Worker &w, int index, QString *errorMsg);
+    void launchNext(int workerIndex);
+    void onRunFinished(int workerIndex);
+    QString culText(int set) const;
+
+    GlueDriverConfig m_config;
+    GlueParamMatrix  m_sets;
+    QList<Worker>    m_workers;
+    QString          m_culFileName;
+    QStringList      m_culLines;       // rendered CUL; the cultivar line is spliced per run
+    int              m_culRowLine = -1;
+    CulRow           m_culRow;
+    QVector<ParamFormat> m_formats;
+    std::vector<QByteArray> m_results; // Evaluate rows per set, RUN column replaced
+    QByteArray       m_header;
+    std::unique_ptr<GlueConvergenceMonitor> m_monitor;
+    GlueEvalTable    m_table;          // finished runs so far, for the monitor
+    int  m_limit  = 0;                 // sets to run; below m_sets.sets after an early stop
+    int  m_next   = 0;
+    int  m_done   = 0;
+    int  m_failed = 0;
+    int  m_active = 0;
+    bool m_cancelled = false;
+};
+
+#endif // GLUEPARALLELDRIVER_H
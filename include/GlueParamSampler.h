@@ -0,0 +1,70 @@
+#ifndef GLUEPARAMSAMPLER_H
+#define GLUEPARAMSAMPLER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <vector>
+#include "CulParser.h"
+
+enum class GlueSamplingMethod { Uniform, LatinHypercube, Sobol };
+
+// Prior box for one GLUE round: bounds from the MINIMA/MAXIMA rows (999991/999992),
+// the cultivar's current values for everything this round does not estimate.
+struct GlueParamSpace {
+    QStringList     names;     // every CUL parameter, in file order
+    QVector<double> minima;
+    QVector<double> maxima;
+    QVector<double> base;      // cultivar's current value (held fixed when !sampled)
+    QVector<bool>   sampled;   // calibrated in this round
+    int sampledCount() const;
+};
+
+// Parameter sets stored column by column: columns[p][set]
+struct GlueParamMatrix {
+    QStringList names;
+    std::vector<std::vector<double>> columns;
+    int sets = 0;
+
+    double value(int set, int param) const { return columns[param][set]; }
+};
+
+// Native replacement for the random-set generation step of GLUE.R.
+// Deterministic: the same space, method, size and seed give identical matrices.
+class GlueParamSampler
+{
+public:
+    // Parameter types calibrated by a round. GLUEFlag 1 estimates P in round 1
+    // and G in round 2; flag 2 only P; flag 3 only G.
+    static QString calibratedType(int glueFlag, int round);
+
+    // Build the prior box for cultivarId. Returns an empty space and sets
+    // errorMsg when the MINIMA/MAXIMA rows or the cultivar are missing.
+    static GlueParamSpace buildSpace(const QVector<CulRow> &rows,
+                                     const QStringList &headerLines,
+                                     const QString &cultivarId,
+                                     int glueFlag, int round,
+                                     QString *errorMsg = nullptr);
+
+    // seed = 0 with Sobol gives the plain (unscrambled) sequence; any other seed
+    // applies a random digital shift.
+    static GlueParamMatrix generate(const GlueParamSpace &space, int sets,
+                                    GlueSamplingMethod method, quint64 seed);
+
+    // Header line of parameter names, then one whitespace-separated set per line,
+    // as read by GLUE's model-run step.
+    static bool writeRandomSets(const QString &filePath, const GlueParamMatrix &matrix);
+    static bool readRandomSets(const QString &filePath, GlueParamMatrix &matrix);
+
+    // "RealRandomSets_1.txt" / "RealRandomSets_2.txt"
+    static QString randomSetsFileName(int round);
+
+    static bool parseMethod(const QString &name, GlueSamplingMethod &method);
+    static QString methodName(GlueSamplingMethod method);
+
+    // Highest dimension with built-in Sobol direction numbers; further sampled
+    // parameters fall back to Latin hypercube columns.
+    static int maxSobolDimensions();
+};
+
+#endif // GLUEPARAMSAMPLER_H
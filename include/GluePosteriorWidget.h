@@ -0,0 +1,43 @@
+#ifndef GLUEPOSTERIORWIDGET_H
+#define GLUEPOSTERIORWIDGET_H
+
+#include <QWidget>
+#include <QColor>
+#include "GlueOutputReader.h"
+
+class QPainter;
+
+// Grid of per-parameter histograms: prior share of sets in grey, the
+// likelihood-weighted posterior on top, and the most likely set marked.
+class GluePosteriorWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit GluePosteriorWidget(QWidget *parent = nullptr);
+    ~GluePosteriorWidget() override;
+
+    void setData(const GlueDistributions &data);
+    void clearData();
+
+    // Round picker over a GLUE output directory with the histograms below,
+    // showing the last round; nullptr when dir holds no parameter sets
+    static QWidget *createRoundBrowser(const QString &dir, QWidget *parent = nullptr);
+    // Modal dialog around createRoundBrowser(); warns when there is nothing to show
+    static void showForDir(QWidget *parent, const QString &dir, const QString &title);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    void paintHistogram(QPainter &painter, const QRect &cell, const GlueParamHistogram &h) const;
+
+    GlueDistributions m_data;
+    bool m_hasData = false;
+
+    static const QColor PRIOR_COLOR;
+    static const QColor POSTERIOR_COLOR;
+    static const QColor BEST_COLOR;
+};
+
+#endif // GLUEPOSTERIORWIDGET_H
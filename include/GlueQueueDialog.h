@@ -42,6 +42,7 @@ private:
     QSpinBox     *m_runsSpin;
     QComboBox    *m_modeCombo;
     QCheckBox    *m_ecoCheck;
+    QCheckBox    *m_forceCheck;
     QPushButton  *m_addBtn;
 
     GlueQueueEntry m_entry;
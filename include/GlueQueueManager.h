@@ -3,10 +3,12 @@
 
 #include <QObject>
 #include <QList>
-#include <QProcess>
-#include <QTimer>
+#include <QDateTime>
 #include "DssatProParser.h"
 #include "GlueRunner.h"
+#include "GlueScheduler.h"
+#include "GlueJobPipeline.h"
+#include "GlueLogBuffer.h"
 
 enum class GlueQueueStatus { Pending, Running, Done, Failed };
 
@@ -18,11 +20,25 @@ struct GlueQueueEntry {
     int            runs      = 500;
     int            glueFlag  = 1;   // 1=both, 2=pheno, 3=growth
     QString        ecoCalib  = "N";
+    int            priority  = 0;   // higher runs first under GlueSchedulePolicy::Priority
+    bool           forceRerun = false;  // ignore a cached result with the same inputs
 
     GlueQueueStatus status   = GlueQueueStatus::Pending;
+    double         estimatedSeconds = 0;  // set by GlueScheduler when queued
+    QDateTime      startedAt;
+    QDateTime      finishedAt;
     QString        resultCulLine;
     QString        snapshotDir;  // set after run — GLWork/BackUp/<cropCode>_<cultivarId>/
     QString        errorMsg;
+    int            progress = 0;       // 0-100 while running, from ModelRunIndicator.txt
+    QString        progressLabel;      // GLUE phase behind progress
+    QString        logFile;            // full R/DSSAT console output of the run
+    QString        fingerprint;        // GlueResultCache hash of the inputs at launch
+    bool           fromCache = false;  // result taken from an identical earlier run
+    QString        convergence;        // GlueConvergenceMonitor verdict of the finished run
+    bool           needsMoreRuns = false;  // posterior still moving at the last check
+    GlueResourceUsage resources;  // sampled from the R process tree while running
+    int            jobId = -1;         // GlueJobPipeline job once handed to the pipeline
 };
 
 class GlueQueueManager : public QObject
@@ -30,6 +46,13 @@ class GlueQueueManager : public QObject
     Q_OBJECT
 
 public:
+    // Parts of an entry reported by entryChanged()
+    enum EntryField {
+        StatusField   = 0x1,   // status, result, error, timings
+        ProgressField = 0x2,   // progress, progressLabel, resources
+        PriorityField = 0x4,
+    };
+
     explicit GlueQueueManager(QObject *parent = nullptr);
 
     void addEntry(const GlueQueueEntry &entry);
@@ -38,7 +61,31 @@ public:
     const QList<GlueQueueEntry> &entries() const { return m_entries; }
     bool isRunning() const { return m_running; }
 
+    void setSchedulePolicy(GlueSchedulePolicy policy);
+    GlueSchedulePolicy schedulePolicy() const { return m_policy; }
+    void setPriority(int index, int priority);
+
+    // Dispatch jobs to one resident R interpreter instead of starting
+    // Rscript per entry (persisted in QSettings)
+    void setResidentWorker(bool enabled);
+    bool residentWorker() const { return m_residentWorker; }
+
+    // Remaining seconds for one entry (0 when finished) and for the whole queue
+    double remainingSeconds(int index) const;
+    double queueRemainingSeconds() const;
+
+    // Console output of the running (or last) job
+    GlueLogBuffer *log() const { return m_log; }
+
+    // CSV with one line per finished job (appended by every run on this machine)
+    static QString historyFilePath();
+
 signals:
+    // Per-entry notifications for models; each is followed by queueChanged()
+    // except entryChanged(ProgressField), which fires with progressUpdated()
+    void entriesInserted(int first, int last);
+    void entryRemoved(int index);
+    void entryChanged(int index, int fields);
     void queueChanged();
     void entryStarted(int index);
     void entryFinished(int index, bool success, const QString &culLine);
@@ -49,22 +96,28 @@ public slots:
     void stop();
 
 private slots:
-    void onGlueOutput();
-    void onGlueFinished(int exitCode);
-    void onPollProgress();
+    void onJobStarted(int id);
+    void onJobProgress(int id, const GlueProgress &progress);
+    void onJobFinished(int id, const GlueJobResult &result);
+    void onJobAssessed(int id, const GlueJobResult &result);
+    void onJobSnapshotted(int id, bool ok);
 
 private:
-    void runNext();
-    void cleanup();
+    // Keep the pipeline fed: the entry the policy picks next is handed over
+    // while the current one runs, so its sandbox is ready when R exits
+    void feed();
+    void dropAhead(int index);
+    int  indexOfJob(int id) const;
+    void appendHistory(const GlueQueueEntry &entry) const;
+    bool completeFromCache(int index);
 
     QList<GlueQueueEntry> m_entries;
     int       m_currentIndex  = -1;
     bool      m_running       = false;
-    QProcess *m_process       = nullptr;
-    QTimer   *m_pollTimer     = nullptr;
-    int       m_lastLine      = 0;
-    int       m_glueRound     = 0;
-    QString   m_stderrBuf;
+    GlueJobPipeline *m_pipeline = nullptr;
+    GlueLogBuffer *m_log      = nullptr;
+    GlueSchedulePolicy m_policy = GlueSchedulePolicy::Fifo;
+    bool         m_residentWorker = false;
 };
 
 #endif // GLUEQUEUEMANAGER_H
@@ -0,0 +1,78 @@
+#ifndef GLUEQUEUEMODEL_H
+#define GLUEQUEUEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QSortFilterProxyModel>
+#include <QStyledItemDelegate>
+#include "GlueQueueManager.h"
+
+// Table over GlueQueueManager::entries(). Rows follow the manager's
+// insert/remove signals and each entryChanged() repaints only the
+// columns and roles it touches, so a long queue costs nothing per update.
+class GlueQueueModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column { COL_VARNUM, COL_NAME, COL_TREATMENTS, COL_RUNS, COL_MODE,
+                  COL_STATUS, COL_PROGRESS, COL_ETA, COL_COUNT };
+    enum Role {
+        SortRole     = Qt::UserRole + 1,   // raw value of the cell for sorting
+        StatusRole,                        // GlueQueueStatus as int
+        ProgressRole,                      // 0-100
+    };
+
+    explicit GlueQueueModel(GlueQueueManager *manager, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+    // Running rows' ETA counts down with the clock, not with queue events
+    void refreshEta();
+
+private:
+    void onInserted(int first, int last);
+    void onRemoved(int index);
+    void onChanged(int index, int fields);
+
+    GlueQueueManager *m_manager;
+    int m_rows = 0;   // rows announced to views; trails the manager between signals
+};
+
+// Shows the rows whose status is in the mask (all by default) and sorts
+// on GlueQueueModel::SortRole.
+class GlueQueueFilterProxy : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit GlueQueueFilterProxy(QObject *parent = nullptr);
+
+    static int statusBit(GlueQueueStatus status) { return 1 << static_cast<int>(status); }
+    static const int ALL_STATUSES = 0xF;
+
+    void setStatusMask(int mask);
+    int  statusMask() const { return m_mask; }
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    int m_mask = ALL_STATUSES;
+};
+
+// Paints GlueQueueModel::ProgressRole as a progress bar
+class GlueProgressDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    using QStyledItemDelegate::QStyledItemDelegate;
+    void paint(QPainter *painter, const QStyleOptionViewItem &option,
+               const QModelIndex &index) const override;
+};
+
+#endif // GLUEQUEUEMODEL_H
@@ -2,11 +2,16 @@
 #define GLUEQUEUEPANEL_H
 
 #include <QWidget>
-#include <QTableWidget>
+#include <QTableView>
 #include <QPushButton>
 #include <QProgressBar>
 #include <QLabel>
+#include <QComboBox>
+#include <QCheckBox>
+#include <QTimer>
 #include "GlueQueueManager.h"
+#include "GlueLogView.h"
+#include "GlueQueueModel.h"
 
 class GlueQueuePanel : public QWidget
 {
@@ -20,15 +25,36 @@ public:
 private slots:
     void onRemove();
     void onClearDone();
-    void onRowDoubleClicked(int row, int col);
+    void onRowDoubleClicked(const QModelIndex &index);
+    void onPolicyChanged(int index);
+    void onRaisePriority();
+    void onLowerPriority();
+    void updateEta();
+    void onExportHistory();
 
 private:
+    // Manager index of the current row, or -1
+    int currentEntry() const;
+    void selectEntry(int index);
+
     GlueQueueManager *m_manager;
-    QTableWidget     *m_table;
+    GlueQueueModel   *m_model;
+    GlueQueueFilterProxy *m_proxy;
+    QTableView       *m_table;
+    QComboBox        *m_statusFilter;
     QPushButton      *m_removeBtn;
     QPushButton      *m_clearDoneBtn;
+    QPushButton      *m_raiseBtn;
+    QPushButton      *m_lowerBtn;
+    QPushButton      *m_exportBtn;
+    QComboBox        *m_policyCombo;
+    QCheckBox        *m_residentCheck;
+    QLabel           *m_etaLabel;
+    QTimer           *m_etaTimer;
     QProgressBar     *m_progressBar;
     QLabel           *m_progressLabel;
+    QPushButton      *m_logBtn;
+    GlueLogView      *m_logView;
 };
 
 #endif // GLUEQUEUEPANEL_H
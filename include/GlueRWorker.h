@@ -0,0 +1,78 @@
+#ifndef GLUERWORKER_H
+#define GLUERWORKER_H
+
+#include <QObject>
+#include <QProcess>
+#include <QString>
+#include <QStringList>
+
+// Resident R interpreter for the GLUE queue. One Rscript stays running a small
+// loop (GlueWorker.R) that reads "JOB\t<id>\t<script>[\t<dir>]" lines on stdin,
+// sources the script in a fresh environment (in dir, else in the script's own
+// directory) and answers "@@DONE\t<id>\t<status>" on a line of its own, so
+// queued jobs skip interpreter start-up and package loading.
+//
+// If R dies while a job runs, the job is retried once on a fresh interpreter
+// when the dead one had already served earlier jobs; otherwise jobFinished()
+// reports the exit. The next submit() starts a new interpreter.
+class GlueRWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit GlueRWorker(QObject *parent = nullptr);
+    ~GlueRWorker() override;
+
+    // Queue scriptPath (normally GLUE_DIR/GLUE.r) to run in workingDir
+    // (default: the script's directory); starts R when needed.
+    // Returns false while a job is already in progress.
+    bool submit(const QString &scriptPath, const QString &workingDir = QString());
+    // Kill R and fail the running job (jobFinished(-1, "Stopped"))
+    void abort();
+    // Ask an idle interpreter to exit
+    void shutdown();
+    // Interpreter and arguments before the worker script, for interpreters
+    // started from now on; default findRTerm() --slave
+    void setProgram(const QString &program, const QStringList &arguments)
+    {
+        m_program = program;
+        m_programArgs = arguments;
+    }
+
+    bool isBusy() const { return !m_script.isEmpty(); }
+    qint64 processId() const;
+    int jobsServed() const { return m_jobsServed; }
+
+    // Bootstrap R script, written next to the GLUE run history
+    static QString scriptPath();
+
+signals:
+    void jobStarted(qint64 pid);
+    // Console output of the running job (markers removed)
+    void outputReceived(const QByteArray &data, bool isError);
+    // message: why the worker ended the job itself (crash, stop), else empty
+    void jobFinished(int exitCode, const QString &message);
+
+private:
+    bool ensureProcess();
+    void sendJob();
+    void onStdout();
+    void onStderr();
+    void onProcessFinished(int exitCode, QProcess::ExitStatus status);
+    void finishJob(int exitCode, const QString &message = QString());
+
+    QProcess  *m_proc = nullptr;
+    QString    m_program;
+    QStringList m_programArgs;
+    bool       m_ready = false;       // @@READY seen
+    QString    m_script;              // job in progress (empty = idle)
+    QString    m_workDir;
+    bool       m_sent  = false;       // job line written to R
+    bool       m_retried = false;
+    int        m_jobId = 0;
+    int        m_jobsServed = 0;      // completed by the current interpreter
+    QByteArray m_lineBuf;
+    bool       m_blankHeld = false;   // empty line that may precede @@DONE
+};
+
+#endif // GLUERWORKER_H
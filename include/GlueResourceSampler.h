@@ -0,0 +1,52 @@
+#ifndef GLUERESOURCESAMPLER_H
+#define GLUERESOURCESAMPLER_H
+
+#include <QString>
+#include <QList>
+#include <QPair>
+#include <QElapsedTimer>
+
+// Resources consumed by one GLUE job (R + every DSSAT run it spawned)
+struct GlueResourceUsage {
+    bool    available   = false;  // false when /proc is not readable (non-Linux)
+    double  cpuSeconds  = 0;      // user + system, whole process tree
+    qint64  peakRssKb   = 0;      // peak of the tree's summed resident set
+    qint64  readBytes   = 0;      // storage reads  (/proc/<pid>/io read_bytes)
+    qint64  writeBytes  = 0;      // storage writes (/proc/<pid>/io write_bytes)
+    double  wallSeconds = 0;
+    QList<QPair<QString, double>> phaseSeconds;  // GLUE phase label -> wall seconds
+
+    QString summary() const;      // one-line "CPU 12 s, peak 310 MB, …"
+};
+
+// Samples the process tree rooted at a PID from /proc, relative to start().
+// Counters of reaped children are picked up through the parents' cutime/cstime
+// and io totals, so short-lived DSSAT runs between samples are still counted.
+class GlueResourceSampler
+{
+public:
+    static bool isSupported();
+
+    void start(qint64 rootPid);
+    void sample();
+    // Close the current phase and start timing a new one
+    void markPhase(const QString &phase);
+    // Final sample; closes the last phase and returns the totals
+    GlueResourceUsage finish();
+
+    const GlueResourceUsage &usage() const { return m_usage; }
+
+private:
+    bool readTree(double &cpuSeconds, qint64 &rssKb, qint64 &readBytes, qint64 &writeBytes) const;
+
+    qint64 m_rootPid = 0;
+    double m_baseCpu = 0;       // counters at start(), subtracted from samples
+    qint64 m_baseRead = 0;
+    qint64 m_baseWrite = 0;
+    QElapsedTimer m_wall;
+    QElapsedTimer m_phaseTimer;
+    QString m_phase;
+    GlueResourceUsage m_usage;
+};
+
+#endif // GLUERESOURCESAMPLER_H
@@ -0,0 +1,46 @@
+#ifndef GLUERESULTCACHE_H
+#define GLUERESULTCACHE_H
+
+#include <QString>
+#include <QDateTime>
+
+struct GlueQueueEntry;
+
+// A finished calibration found in a snapshot directory
+struct GlueCacheHit {
+    QString   resultCulLine;
+    QString   snapshotDir;
+    QDateTime finishedAt;
+};
+
+// Content-addressed lookup of finished GLUE runs.
+// A job's fingerprint is a SHA-256 over everything GLUE reads for it: the
+// CUL/ECO/SPE files, the selected X files and treatment numbers, runs,
+// GLUEFlag and ECO calibration. "!" comment lines are ignored, and the
+// parameters of the calibrated cultivar that this GLUEFlag re-estimates are
+// left out, so applying a result (which rewrites exactly those values and
+// stamps a history comment) does not invalidate it.
+// The fingerprint is stored in a manifest next to the GLWork snapshot.
+class GlueResultCache
+{
+public:
+    // Hex SHA-256 of the job's inputs; empty if a genetics file cannot be read.
+    static QString fingerprint(const GlueQueueEntry &entry);
+
+    // True if the entry's snapshot directory holds a successful run with the
+    // same fingerprint. The entry's fingerprint is computed when it is empty.
+    static bool lookup(const GlueQueueEntry &entry, GlueCacheHit &hit);
+
+    // Record a successful run (entry.fingerprint, resultCulLine, snapshotDir).
+    static bool store(const GlueQueueEntry &entry);
+
+    // Remove the manifest so a failed or partial snapshot is never served.
+    static void invalidate(const QString &snapshotDir);
+
+    // GLWork/BackUp/<cropCode>_<cultivarId>
+    static QString snapshotDirFor(const GlueQueueEntry &entry);
+
+    static const char *MANIFEST_FILE;
+};
+
+#endif // GLUERESULTCACHE_H
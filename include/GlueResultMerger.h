@@ -0,0 +1,52 @@
+#ifndef GLUERESULTMERGER_H
+#define GLUERESULTMERGER_H
+
+#include <QString>
+#include <QStringList>
+#include <QMap>
+#include <QVector>
+#include "CulParser.h"
+#include "IdentifierIndex.h"
+
+struct GlueQueueEntry;
+
+struct GlueMergeResult {
+    int         updated   = 0;   // existing cultivars whose parameters changed
+    int         added     = 0;   // cultivars appended to the file
+    int         unchanged = 0;   // result already in the file
+    QStringList skipped;         // lines that could not be parsed or applied
+    QVector<int> changedRows;    // row indices touched (updated or added)
+    QString     backupPath;      // set by mergeFile()
+
+    int changes() const { return updated + added; }
+    QString summary() const;
+};
+
+// Applies finished GLUE cultivar lines to CUL rows in one pass.
+// An existing VAR# gets the calibrated parameter values and, above it, a
+// dated "!" comment with its old line (as the queue's auto-apply does);
+// a line already matching the row is left alone, so merging twice is
+// harmless. With addMissing, unknown cultivars are appended.
+class GlueResultMerger
+{
+public:
+    // varIndex, when given, is the VAR# index of rows (e.g. the table
+    // model's) and saves building one
+    static GlueMergeResult mergeRows(QVector<CulRow> &rows, int numParams,
+                                     const QStringList &culLines, bool addMissing = true,
+                                     const IdentifierIndex *varIndex = nullptr);
+
+    // Read culPath, merge, then one backup and one write (only if something changed)
+    static bool mergeFile(const QString &culPath, const QStringList &culLines,
+                          GlueMergeResult &result, QString *errorMsg = nullptr);
+
+    // resultCulLine of every finished entry, keyed by the entry's CUL file
+    static QMap<QString, QStringList> finishedResults(const QList<GlueQueueEntry> &entries);
+
+    // Results stored in the GLWork/BackUp snapshots of a crop (all cultivars
+    // when cultivarIds is empty)
+    static QStringList storedResults(const QString &cropCode,
+                                     const QStringList &cultivarIds = QStringList());
+};
+
+#endif // GLUERESULTMERGER_H
@@ -22,6 +22,15 @@ struct ScanResult {
     QString errorMsg;  // non-empty if fatal error (e.g. no expDir configured)
 };
 
+// Phase progress read from GLUE's ModelRunIndicator.txt. Each round has six
+// phases: round 1 maps to 0-50 %, round 2 to 50-100 %.
+struct GlueProgress {
+    int     lastLine = 0;   // complete lines already consumed
+    int     round    = 0;   // 0 = first round, 1 = second
+    int     percent  = 0;
+    QString label;          // latest meaningful indicator line
+};
+
 // Pure logic shared between GlueWizard (GUI) and CommandLineHandler (headless)
 class GlueRunner
 {
@@ -46,19 +55,27 @@ public:
                                       const QString  &cultivarId,
                                       bool includeTreatmentNames = true);
 
-    // Write DSSBatch file to GLWork.
+    // Write DSSBatch file to GLWork (or to dir, e.g. a parallel worker's scratch directory).
     // Returns the path written, or empty on failure.
     static QString writeBatchFile(const CropInfo &cropInfo,
                                   const QString  &cultivarId,
                                   const QString  &cultivarName,
-                                  const TreatmentMap &selected);
+                                  const TreatmentMap &selected,
+                                  const QString  &dir = QString());
 
-    // Update SimulationControl.csv with run parameters.
+    // Update SimulationControl.csv with run parameters, or write the job's copy
+    // to targetPath (e.g. a sandbox) leaving the shared file untouched.
     // glueFlag: 1=both, 2=phenology only, 3=growth parameters
     static bool updateSimControl(const CropInfo &cropInfo,
                                  const QString  &cultivarId,
                                  int runs, int glueFlag,
-                                 const QString  &ecoCalib);
+                                 const QString  &ecoCalib,
+                                 const QString  &targetPath = QString(),
+                                 QString        *errorMsg   = nullptr);
+
+    // Consume lines appended to indicatorFile since the last call.
+    // Returns true when a new phase label was read.
+    static bool readProgress(const QString &indicatorFile, GlueProgress &progress);
 };
 
 #endif // GLUERUNNER_H
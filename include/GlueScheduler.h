@@ -0,0 +1,43 @@
+#ifndef GLUESCHEDULER_H
+#define GLUESCHEDULER_H
+
+#include <QString>
+#include <QList>
+#include "DssatProParser.h"
+
+struct GlueQueueEntry;
+
+// Order in which pending queue entries are started. Priority runs higher
+// priorities first and equal priorities shortest first.
+enum class GlueSchedulePolicy { Fifo, ShortestFirst, Priority };
+
+// Cost model + ordering for the GLUE queue.
+// A job's cost is (treatments × runs × rounds) model runs multiplied by the
+// seconds-per-model-run measured on this machine for the same crop module and
+// GLUE flag. Measurements are kept in QSettings so estimates improve over time.
+class GlueScheduler
+{
+public:
+    // Number of DSSAT model runs a job performs (GLUEFlag 1 runs two rounds).
+    static qint64 modelRunCount(const GlueQueueEntry &entry);
+
+    // Learned seconds per model run; falls back to the machine-wide average,
+    // then to a conservative default when nothing has been recorded yet.
+    static double secondsPerModelRun(const CropInfo &cropInfo, int glueFlag);
+
+    // Estimated wall time of the whole job in seconds.
+    static double estimateSeconds(const GlueQueueEntry &entry);
+
+    // Record a finished job's wall time so future estimates learn from it.
+    static void recordRun(const GlueQueueEntry &entry, double wallSeconds);
+
+    // Index of the next Pending entry under the given policy, or -1.
+    static int pickNext(const QList<GlueQueueEntry> &entries, GlueSchedulePolicy policy);
+
+    // "45 s", "12 min", "1 h 05 min"
+    static QString formatDuration(double seconds);
+
+    static QString policyName(GlueSchedulePolicy policy);
+};
+
+#endif // GLUESCHEDULER_H
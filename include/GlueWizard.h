@@ -12,11 +12,11 @@
 #include <QComboBox>
 #include <QCheckBox>
 #include <QTextEdit>
-#include <QProcess>
 #include <QStringList>
 #include <QProgressBar>
-#include <QTimer>
 #include "DssatProParser.h"
+#include "GlueLogView.h"
+#include "GlueJobPipeline.h"
 
 class GlueWizard : public QDialog
 {
@@ -40,9 +40,9 @@ private slots:
     void onRunGlue();
     void onStopGlue();
     void onStartOver();
-    void onGlueOutput();
-    void onGlueFinished(int exitCode);
-    void onPollProgress();
+    void onGlueStarted();
+    void onGlueProgress(int id, const GlueProgress &progress);
+    void onGlueFinished(int id, const GlueJobResult &result);
 
 private:
     void setupTreatmentPage();
@@ -82,17 +82,17 @@ private:
     QPushButton  *m_outCoeffBtn;
     QPushButton  *m_outDevBtn;
     QPushButton  *m_outYieldBtn;
-    QTextEdit    *m_logEdit;
+    QPushButton  *m_outPostBtn;
+    GlueLogView  *m_logView;
+    GlueLogBuffer *m_log;
     QProgressBar *m_progressBar;
     QLabel       *m_progressLabel;
 
-    // Process
-    QProcess     *m_glueProcess = nullptr;
-    QTimer       *m_pollTimer   = nullptr;
+    // Run
+    GlueJobPipeline *m_pipeline;
+    TreatmentMap  m_selected;
     QStringList   m_selectedFiles;
-    int           m_lastIndicatorLine = 0;
     int           m_totalRuns = 0;
-    int           m_glueRound = 0;
 };
 
 #endif // GLUEWIZARD_H
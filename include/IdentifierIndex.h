@@ -0,0 +1,56 @@
+#ifndef IDENTIFIERINDEX_H
+#define IDENTIFIERINDEX_H
+
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QMap>
+
+// Index over the identifier column of the CUL/ECO tables (VAR#, ECO#).
+// Identifiers are <prefix><4-digit suffix>, e.g. IB0001, compared trimmed
+// and upper-cased. Lookups go through a hash of identifier -> rows; new
+// identifiers come from an ordered set of suffixes per prefix, so neither
+// scans the table. Appending and renaming are O(1); inserting or removing
+// above the end shifts the stored row numbers.
+class IdentifierIndex
+{
+public:
+    explicit IdentifierIndex(int prefixLength = 2) : m_prefixLength(prefixLength) {}
+
+    // numbered: whether a row takes part in numbering (not MINIMA/MAXIMA);
+    // every row does when it is empty
+    void reset(const QVector<QString> &ids, const QVector<bool> &numbered = QVector<bool>());
+    void insert(int row, const QString &id, bool numbered = true);
+    void remove(int row);
+    void rename(int row, const QString &id, bool numbered = true);
+
+    int  rowCount() const { return m_ids.size(); }
+    // First row holding id, or -1
+    int  rowOf(const QString &id) const;
+    bool contains(const QString &id) const { return m_rows.contains(normalize(id)); }
+    // Every row holding id, ascending
+    QVector<int> rowsOf(const QString &id) const { return m_rows.value(normalize(id)); }
+    // Distinct identifiers, normalized
+    QStringList ids() const { return m_rows.keys(); }
+    // Highest suffix in use under prefix, 0 when none
+    int  maxSuffix(const QString &prefix) const;
+    // Prefix of the last numbered row (fallbackPrefix if there is none) and
+    // the next suffix after the highest one, skipping identifiers in use
+    QString nextId(const QString &fallbackPrefix) const;
+
+    static QString normalize(const QString &id) { return id.trimmed().toUpper(); }
+
+private:
+    bool split(const QString &key, QString *prefix, int *suffix) const;
+    void addKey(int row);
+    void dropKey(int row);
+
+    int m_prefixLength;
+    QVector<QString> m_ids;                     // normalized, per row
+    QVector<bool>    m_numbered;
+    QHash<QString, QVector<int>> m_rows;        // id -> rows holding it, ascending
+    QHash<QString, QMap<int, int>> m_suffixes;  // prefix -> suffix -> numbered rows using it
+};
+
+#endif // IDENTIFIERINDEX_H
@@ -0,0 +1,103 @@
+#ifndef INDEXEDFILTERPROXY_H
+#define INDEXEDFILTERPROXY_H
+
+#include <QSortFilterProxyModel>
+#include <QTimer>
+#include <QVector>
+#include <QBitArray>
+#include "TextSearchIndex.h"
+#include "TableQuery.h"
+
+// Sort/filter proxy driven by a selection bitmap over the source rows.
+// Plain search text goes through a TextSearchIndex over a few source
+// columns; text with operators or keywords is compiled into a TableQuery
+// and evaluated column by column. The index and the bitmap follow the
+// source model's resets, inserts, removals and edits, and typing is
+// debounced so only the last text of a burst is looked up.
+//
+// Sorting compares precomputed integer ranks: the sort column is read once
+// as typed keys (numbers or text), sorted, and every row gets its position,
+// so lessThan() never touches QVariant. Removed rows are cut out of the
+// ranks; inserted and edited rows compare by key until one queued rebuild
+// per event-loop pass ranks them. Pinned rows stay on top in either
+// direction.
+class IndexedFilterProxy : public QSortFilterProxyModel, protected TableQuery::Reader
+{
+    Q_OBJECT
+
+public:
+    explicit IndexedFilterProxy(QObject *parent = nullptr);
+
+    // Source columns whose display text is searched; set before the source model
+    void setSearchColumns(const QVector<int> &columns) { m_columns = columns; }
+    void setSearchDelay(int ms) { m_debounce.setInterval(ms); }
+    // Rows whose text in column is one of values sort above all others
+    void setPinnedRows(int column, const QStringList &values) { m_pinColumn = column; m_pinValues = values; }
+    // Applied after the search delay; clearing the text applies at once
+    void setSearchText(const QString &text);
+    void flushSearch();
+    QString searchText() const { return m_text; }
+    QString queryError() const { return m_error; }
+
+    void setSourceModel(QAbstractItemModel *model) override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+    const TextSearchIndex &searchIndex() const { return m_index; }
+    const QBitArray &selection() const { return m_selection; }
+
+signals:
+    // The search text was applied; error is set when the query did not compile
+    void searchApplied(int matches, const QString &error);
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+
+    // Column names and flags a query may use; the default reads the header
+    virtual TableQuery::Schema querySchema() const;
+    // Narrow a freshly computed selection (e.g. "Show Used"); default keeps it
+    virtual void restrictRows(int first, int count, QBitArray *selection) const;
+    // Recompute the whole bitmap and re-filter, after restrictRows() changed
+    void reselect();
+
+    // TableQuery::Reader, through sourceModel()->data() unless overridden
+    void readText(int col, int first, int count, QVector<QString> *out) const override;
+    void readNumbers(int col, int first, int count,
+                     QVector<double> *values, QBitArray *present) const override;
+    QBitArray readFlag(const QString &flag, int first, int count) const override;
+    QBitArray readSearch(const QString &text, int first, int count) const override;
+
+private:
+    QString rowKey(int row) const;
+    QBitArray select(int first, int count) const;
+    void compileQuery();
+    void rebuildIndex();
+    void applySearch();
+    void onRowsInserted(int first, int last);
+    void onRowsRemoved(int first, int last);
+    void onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void rebuildRanks(int column);
+    void scheduleRanks();
+    QBitArray pinnedRows(int first, int count) const;
+    bool keyLess(int a, int b) const;
+
+    QList<QMetaObject::Connection> m_sourceConnections;
+    QVector<int>    m_columns;
+    TextSearchIndex m_index;
+    QTimer          m_debounce;
+    QString         m_pending;
+    QString         m_text;        // applied search text
+    bool            m_structured = false;
+    TableQuery      m_query;
+    QString         m_error;
+    QBitArray       m_selection;   // one bit per source row
+
+    int             m_pinColumn = -1;
+    QStringList     m_pinValues;
+    int             m_rankColumn = -1; // column m_rank was built for
+    bool            m_rankNumeric = false;
+    bool            m_ranksQueued = false;
+    QVector<int>    m_rank;            // per source row; equal keys share a rank, -1 = not ranked yet
+    QBitArray       m_pinned;
+};
+
+#endif // INDEXEDFILTERPROXY_H
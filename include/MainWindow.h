@@ -15,6 +15,7 @@
 #include <QCheckBox>
 #include <QSortFilterProxyModel>
 #include <QTimer>
+#include <QThreadPool>
 #include <QMap>
 #include <QStringList>
 #include <memory>
@@ -58,8 +59,11 @@ private slots:
     void onCulShowUsed(bool checked);
     void onCulSearch(const QString &text);
     void onCulPasteGlue();
+    void onCulMergeGlue();
     void onCulCopyRow();
     void onCulHeaderContextMenu(const QPoint &pos);
+    // Formula on one parameter column of the selected rows; -1 = current column
+    void onCulApplyFormula(int column = -1);
 
     // ECO tab buttons
     void onEcoAdd();
@@ -68,6 +72,8 @@ private slots:
     void onEcoSave();
     void onEcoSearch(const QString &text);
     void onEcoCopyRow();
+    // Cultivars using the current ecotype, from the CUL model's ECO# index
+    void onEcoShowCultivars();
 
     // SPE tab buttons
     void onSpeSave();
@@ -78,6 +84,11 @@ private slots:
 
     // Auto-save
     void autoSaveAll();
+    // Write model snapshots on m_savePool; the flag is only cleared when
+    // nothing changed after the snapshot was taken
+    void saveCulInBackground();
+    void saveEcoInBackground();
+    void onBackgroundSaved(const QString &path, quint64 generation, bool ok);
 
 private:
     void setupUI();
@@ -86,6 +97,7 @@ private:
     void setupCulTab(QWidget *tab);
     void setupEcoTab(QWidget *tab);
     void setupSpeTab(QWidget *tab);
+    void setupViolationDock();
     void connectSignals();
 
     void loadDssatConfig(const QString &dssatDir);
@@ -119,8 +131,9 @@ private:
     QLineEdit  *m_ecoSearch;
     QTableView *m_ecoView;
     EcoTableModel *m_ecoModel;
-    QSortFilterProxyModel *m_ecoProxy = nullptr;
+    class EcoSortProxy *m_ecoProxy = nullptr;
     QPushButton *m_ecoAddBtn, *m_ecoDelBtn, *m_ecoDupBtn, *m_ecoSaveBtn;
+    QPushButton *m_ecoUsersBtn = nullptr;
     bool        m_ecoDirty = false;
 
     // SPE tab
@@ -137,9 +150,17 @@ private:
 
     // Auto-save timer
     QTimer *m_autoSaveTimer = nullptr;
+    QThreadPool m_savePool;   // one writer; explicit saves and reloads wait for it
+
+    // Undo history per table; the Edit menu follows the current tab
+    class QUndoGroup *m_undoGroup = nullptr;
+    class QUndoStack *m_culUndo = nullptr;
+    class QUndoStack *m_ecoUndo = nullptr;
 
     // Status bar
     QLabel *m_statusLabel;
+    QLabel *m_violationLabel = nullptr;   // out-of-range count in the status bar
+    class QDockWidget *m_violationDock = nullptr;
 
     // Data
     QMap<QString, CropInfo>  m_crops;
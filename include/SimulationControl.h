@@ -0,0 +1,53 @@
+#ifndef SIMULATIONCONTROL_H
+#define SIMULATIONCONTROL_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "DssatProParser.h"
+
+// Typed model of GLUE's SimulationControl.csv ("Key,Value" lines).
+// Keys this editor does not use, comments and line order are kept and
+// rendered back unchanged, so a job's copy differs from the shared file
+// only in the fields it sets.
+class SimulationControl
+{
+public:
+    int     numberOfModelRun = 0;
+    int     glueFlag         = 1;   // 1=both, 2=phenology only, 3=growth parameters
+    QString ecotypeCalibration = "N";
+    QString cultivarBatchFile;      // "<cultivarId>.<cropCode>C"
+    QString modelId;
+    QString outputDir;              // OutputD — GLUE's working directory (GLWork)
+
+    // Parse filePath. Returns false and sets errorMsg when it cannot be read.
+    static bool load(const QString &filePath, SimulationControl &sc, QString *errorMsg = nullptr);
+
+    // Parsed copy of filePath, re-read only when its size or modification
+    // time changes. Safe to call from several threads.
+    static bool cached(const QString &filePath, SimulationControl &sc, QString *errorMsg = nullptr);
+
+    // Set the five per-job fields the way GLUE expects them
+    void configureJob(const CropInfo &cropInfo, const QString &cultivarId,
+                      int runs, int glueFlag, const QString &ecoCalib);
+
+    // Value of a key this class does not type (empty if absent)
+    QString value(const QString &key) const;
+    void setValue(const QString &key, const QString &value);
+
+    // Problems that would make GLUE fail or misbehave; empty when valid
+    QStringList validate() const;
+
+    QString render() const;
+    // Atomic write (QSaveFile); refreshes the cache entry for filePath
+    bool writeTo(const QString &filePath, QString *errorMsg = nullptr) const;
+
+private:
+    struct Line {
+        QString key;    // empty for comments/blank lines
+        QString text;   // raw text for untyped lines, value for other keys
+    };
+    QVector<Line> m_lines;
+};
+
+#endif // SIMULATIONCONTROL_H
@@ -0,0 +1,30 @@
+#ifndef TABLEEDITBATCH_H
+#define TABLEEDITBATCH_H
+
+#include <QtGlobal>
+
+// Scoped beginBatch()/commitBatch() on a table model: the cell edits made
+// while it lives reach views as one dataChanged, listeners (auto-save)
+// as one dataModified and the undo history as one step. Batches nest; the
+// outermost one commits.
+template <typename Model>
+class TableEditBatch
+{
+public:
+    explicit TableEditBatch(Model *model) : m_model(model) { m_model->beginBatch(); }
+    ~TableEditBatch() { commit(); }
+
+    // Commit early; the destructor then does nothing
+    void commit()
+    {
+        if (!m_model) return;
+        m_model->commitBatch();
+        m_model = nullptr;
+    }
+
+private:
+    Q_DISABLE_COPY(TableEditBatch)
+    Model *m_model;
+};
+
+#endif // TABLEEDITBATCH_H
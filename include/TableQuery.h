@@ -0,0 +1,69 @@
+#ifndef TABLEQUERY_H
+#define TABLEQUERY_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QBitArray>
+
+// Structured filter for the CUL/ECO search boxes, e.g.
+//   ECO#=IB0001 AND PPSEN>0.3 AND used
+//   (VRNAME~maize OR VRNAME~corn) AND NOT P1<=200
+// Terms are `column op value` (= != < <= > >= ~), a flag name such as
+// `used`, or a bare word searched like the plain filter. Terms combine with
+// AND (or just a space), OR, NOT and parentheses; values with spaces are
+// quoted. compile() turns the text into a small expression tree, and
+// evaluate() runs it one column at a time over a row range, producing a
+// selection bitmap: each comparison reads its column once into a flat
+// array and the tree combines the resulting bitmaps.
+class TableQuery
+{
+public:
+    struct Schema {
+        QStringList columns;            // column names, matched case-insensitively
+        int         firstNumeric = 0;   // columns from here on hold numbers
+        QStringList flags;              // bare words naming a row set, e.g. "used"
+    };
+
+    // Column reads over rows [first, first + count)
+    class Reader {
+    public:
+        virtual ~Reader() = default;
+        virtual void readText(int col, int first, int count, QVector<QString> *out) const = 0;
+        virtual void readNumbers(int col, int first, int count,
+                                 QVector<double> *values, QBitArray *present) const = 0;
+        virtual QBitArray readFlag(const QString &flag, int first, int count) const = 0;
+        // Rows whose searched columns contain text (any case)
+        virtual QBitArray readSearch(const QString &text, int first, int count) const = 0;
+    };
+
+    // True when text uses operators, parentheses, quotes, AND/OR/NOT or a flag name;
+    // anything else is better served as one plain substring search
+    static bool isStructured(const QString &text, const Schema &schema);
+
+    bool compile(const QString &text, const Schema &schema, QString *errorMsg = nullptr);
+    bool isValid() const { return m_root >= 0; }
+    QBitArray evaluate(const Reader &reader, int first, int count) const;
+
+private:
+    enum Kind { And, Or, Not, Compare, Flag, Search };
+    enum Op { Eq, Ne, Lt, Le, Gt, Ge, Contains };
+    struct Node {
+        Kind    kind    = Search;
+        int     lhs     = -1;       // child nodes
+        int     rhs     = -1;
+        int     column  = -1;
+        Op      op      = Eq;
+        bool    numeric = false;
+        double  number  = 0;
+        QString text;               // lowered for text comparisons
+    };
+    friend class TableQueryParser;
+
+    QBitArray eval(int node, const Reader &reader, int first, int count) const;
+
+    QVector<Node> m_nodes;
+    int m_root = -1;
+};
+
+#endif // TABLEQUERY_H
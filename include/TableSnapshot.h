@@ -0,0 +1,39 @@
+#ifndef TABLESNAPSHOT_H
+#define TABLESNAPSHOT_H
+
+#include <QVector>
+#include <QStringList>
+
+// Read-only copy of a table model's rows that another thread can hold while
+// the GUI keeps editing. Taking one only bumps a reference count; the model's
+// next edit copies its row array once (the strings and values inside stay
+// shared), so neither side ever waits for the other.
+template <typename Row>
+class TableSnapshot
+{
+public:
+    using const_iterator = typename QVector<Row>::const_iterator;
+
+    TableSnapshot() = default;
+    TableSnapshot(const QVector<Row> &rows, const QStringList &paramNames, quint64 generation)
+        : m_rows(rows), m_paramNames(paramNames), m_generation(generation) {}
+
+    const QVector<Row> &rows() const { return m_rows; }
+    const Row &at(int row) const { return m_rows.at(row); }
+    int  size() const { return m_rows.size(); }
+    bool isEmpty() const { return m_rows.isEmpty(); }
+    const_iterator begin() const { return m_rows.cbegin(); }
+    const_iterator end() const { return m_rows.cend(); }
+
+    const QStringList &paramNames() const { return m_paramNames; }
+    // Model generation the rows were taken at; compare with generation()
+    // on the model to tell whether an edit happened since
+    quint64 generation() const { return m_generation; }
+
+private:
+    QVector<Row> m_rows;
+    QStringList  m_paramNames;
+    quint64      m_generation = 0;
+};
+
+#endif // TABLESNAPSHOT_H
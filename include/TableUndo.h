@@ -0,0 +1,66 @@
+#ifndef TABLEUNDO_H
+#define TABLEUNDO_H
+
+#include <QUndoCommand>
+#include <QUndoStack>
+#include <QVector>
+#include <QSet>
+#include <QString>
+
+// One change to a row of a table model. Rows are implicitly shared values,
+// so before and after share every field the edit left alone: a cell edit
+// keeps the changed field twice, not a copy of the row or of the table.
+template <typename Row>
+struct TableRowChange {
+    enum Kind { Replace, Insert, Remove };
+    Kind kind = Replace;
+    int  row  = -1;
+    Row  before;    // Replace, Remove
+    Row  after;     // Replace, Insert
+};
+
+// Undo step for one edit or one batch of a model that declares
+// `using RowChange = TableRowChange<Row>` and replayChanges(changes, undo).
+// The model applied the changes before pushing, so the first redo() is a no-op.
+template <typename Model>
+class TableUndoCommand : public QUndoCommand
+{
+public:
+    using Change = typename Model::RowChange;
+
+    TableUndoCommand(Model *model, const QVector<Change> &changes)
+        : m_model(model), m_changes(changes)
+    {
+        setText(describe(changes));
+    }
+
+    void undo() override { m_model->replayChanges(m_changes, true); }
+    void redo() override
+    {
+        if (m_applied) { m_applied = false; return; }
+        m_model->replayChanges(m_changes, false);
+    }
+
+private:
+    static QString describe(const QVector<Change> &changes)
+    {
+        QSet<int> rows;
+        int inserted = 0, removed = 0;
+        for (const Change &c : changes) {
+            rows.insert(c.row);
+            if (c.kind == Change::Insert) ++inserted;
+            if (c.kind == Change::Remove) ++removed;
+        }
+        if (inserted == changes.size())
+            return inserted == 1 ? QString("add row") : QString("add %1 rows").arg(inserted);
+        if (removed == changes.size())
+            return removed == 1 ? QString("delete row") : QString("delete %1 rows").arg(removed);
+        return rows.size() == 1 ? QString("edit row") : QString("edit %1 rows").arg(rows.size());
+    }
+
+    Model *m_model;
+    QVector<Change> m_changes;
+    bool m_applied = true;
+};
+
+#endif // TABLEUNDO_H
@@ -0,0 +1,36 @@
+#ifndef TEXTSEARCHINDEX_H
+#define TEXTSEARCHINDEX_H
+
+#include <QVector>
+#include <QString>
+#include <QHash>
+
+// Case-insensitive substring index over one text key per row. Queries of
+// three or more characters intersect trigram posting lists and confirm the
+// candidates with contains(); shorter ones scan the lowered keys.
+class TextSearchIndex
+{
+public:
+    void reset(const QVector<QString> &keys);
+    void setKey(int row, const QString &key);
+    void insertRows(int first, const QVector<QString> &keys);
+    void removeRows(int first, int count);
+
+    int  rowCount() const { return m_keys.size(); }
+    // Rows whose key contains text, ascending; every row for empty text
+    QVector<int> find(const QString &text) const;
+    // text must already be lower case
+    bool matches(int row, const QString &loweredText) const;
+
+private:
+    using Trigram = quint64;
+    // Unique trigrams of an already lowered string, sorted
+    static QVector<Trigram> trigrams(const QString &lowered);
+    void addPostings(int row);
+    void dropPostings(int row);
+
+    QVector<QString> m_keys;                    // lowered
+    QHash<Trigram, QVector<int>> m_postings;    // ascending row ids
+};
+
+#endif // TEXTSEARCHINDEX_H
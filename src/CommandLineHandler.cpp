@@ -3,6 +3,27 @@
 #include "EcoParser.h"
 #include "DssatProParser.h"
 #include "GlueRunner.h"
+#include "GlueResourceSampler.h"
+#include "GlueResultCache.h"
+#include "GlueQueueManager.h"
+#include "GlueScheduler.h"
+#include "GlueParamSampler.h"
+#include "GlueLikelihood.h"
+#include "GlueParallelDriver.h"
+#include "GlueOutputReader.h"
+#include "SimulationControl.h"
+#include "GlueLogBuffer.h"
+#include "GlueJobPipeline.h"
+#include "GlueRWorker.h"
+#include "GlueQueueModel.h"
+#include "GlueResultMerger.h"
+#include "GlueConvergenceMonitor.h"
+#include "CulTableModel.h"
+#include "EcoTableModel.h"
+#include "TextSearchIndex.h"
+#include "IndexedFilterProxy.h"
+#include "TableQuery.h"
+#include "IdentifierIndex.h"
 #include "Config.h"
 
 #include <QCoreApplication>
@@ -12,9 +33,23 @@
 #include <QTemporaryDir>
 #include <QTextStream>
 #include <QProcess>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QThread>
+#include <QTimer>
+#include <QUndoStack>
+#include <QSettings>
+#include <QStandardPaths>
 #include <QDebug>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
 
 #include <cstdio>
+#include <cmath>
+#ifndef Q_OS_WIN
+#include <signal.h>
+#endif
 
 // ── tiny test harness ─────────────────────────────────────────────────────────
 
@@ -32,6 +67,21 @@ static void check(bool ok, const char *desc)
     fflush(stdout); fflush(stderr);
 }
 
+// CUL row fixture for the table model sections; the name defaults to var
+static CulRow makeCulRow(const QString &var, const QVector<std::optional<double>> &params,
+                         const QString &eco = "DFAULT", bool minMax = false,
+                         const QString &name = QString())
+{
+    CulRow r;
+    r.varNum    = var;
+    r.vrName    = name.isEmpty() ? var : name;
+    r.ecoNum    = eco;
+    r.params    = params;
+    r.paramStrs = QVector<QString>(params.size());
+    r.isMinMax  = minMax;
+    return r;
+}
+
 // ── CommandLineHandler ────────────────────────────────────────────────────────
 
 CommandLineHandler::CommandLineHandler(QObject *parent) : QObject(parent) {}
@@ -57,6 +107,63 @@ CommandLineArgs CommandLineHandler::parseArgs(const QStringList &args)
             r.runs = args[++i].toInt();
         } else if (a == "--mode" && i+1 < args.size()) {
             r.mode = args[++i].toLower();
+        } else if (a == "--force") {
+            r.force = true;
+        } else if (a == "--sample") {
+            r.sampleMode = true;
+            r.isValid    = true;
+        } else if (a == "--sets" && i+1 < args.size()) {
+            r.sets = args[++i].toInt();
+        } else if (a == "--method" && i+1 < args.size()) {
+            r.method = args[++i].toLower();
+        } else if (a == "--seed" && i+1 < args.size()) {
+            r.seed = args[++i].toULongLong();
+        } else if (a == "--round" && i+1 < args.size()) {
+            r.round = args[++i].toInt();
+        } else if (a == "--out" && i+1 < args.size()) {
+            r.outPath = args[++i];
+        } else if (a == "--likelihood") {
+            r.likelihoodMode = true;
+            r.isValid        = true;
+        } else if (a == "--sets-file" && i+1 < args.size()) {
+            r.setsFile = args[++i];
+        } else if (a == "--eval" && i+1 < args.size()) {
+            r.evalFile = args[++i];
+        } else if (a == "--parallel-runs") {
+            r.parallelMode = true;
+            r.isValid      = true;
+        } else if (a == "--workers" && i+1 < args.size()) {
+            r.workers = args[++i].toInt();
+        } else if (a == "--jobs" && i+1 < args.size()) {
+            r.jobs = args[++i].toInt();
+        } else if (a == "--json") {
+            r.json = true;
+        } else if (a == "--merge") {
+            r.mergeMode = true;
+            r.isValid   = true;
+        } else if (a == "--from" && i+1 < args.size()) {
+            r.fromFile = args[++i];
+        } else if (a == "--converge") {
+            r.converge = true;
+        } else if (a == "--stop-early") {
+            r.converge  = true;
+            r.stopEarly = true;
+        } else if (a == "--batch" && i+1 < args.size()) {
+            r.batch = args[++i].toInt();
+        } else if (a == "--tolerance" && i+1 < args.size()) {
+            r.tolerance = args[++i].toDouble();
+        } else if (a == "--stand-in-glue") {
+            r.standInGlue = true;
+            r.isValid     = true;
+            break;   // remaining arguments are R's: --slave --file=GLUE.r
+        } else if (a == "--stand-in-rworker") {
+            r.standInRWorker = true;
+            r.isValid        = true;
+            break;   // remaining argument is the worker script
+        } else if (a == "--stand-in-model") {
+            r.standInModel = true;
+            r.isValid      = true;
+            break;   // remaining arguments are the model's: <ModelID> <mode> <batch>
         }
     }
     return r;
@@ -67,11 +174,40 @@ int CommandLineHandler::run(const QStringList &args)
     CommandLineArgs a = parseArgs(args);
     if (!a.isValid) return -1; // no CLI flags — show GUI
 
+    if (a.standInModel) return runStandInModel(args);
+    if (a.standInGlue) return runStandInGlue();
+    if (a.standInRWorker) return runStandInRWorker();
+
     if (a.testMode) return runTests();
     if (a.glueMode) return runGlue(a);
+    if (a.sampleMode) return runSample(a);
+    if (a.likelihoodMode) return runLikelihood(a);
+    if (a.parallelMode) return runParallel(a);
+    if (a.mergeMode) return runMerge(a);
     return -1;
 }
 
+bool CommandLineHandler::findCrop(const QString &cropCode, CropInfo &cropInfo)
+{
+    QMap<QString, CropInfo> crops = DssatProParser::discoverCrops(Config::DSSATPRO_FILE);
+    cropInfo = CropInfo();
+    for (const CropInfo &c : crops) {
+        if (c.cropCode.compare(cropCode, Qt::CaseInsensitive) != 0) continue;
+        // Prefer the DSSATPRO-designated primary model; fall back to any match
+        if (cropInfo.cropCode.isEmpty() || c.isPrimary)
+            cropInfo = c;
+    }
+    return !cropInfo.cropCode.isEmpty();
+}
+
+// Map --mode string to GLUEFlag integer: 1=both, 2=phenology, 3=growth
+int CommandLineHandler::glueFlagForMode(const QString &mode)
+{
+    if (mode == "phenology") return 2;
+    if (mode == "growth")    return 3;
+    return 1;
+}
+
 // ── Test suite ────────────────────────────────────────────────────────────────
 
 int CommandLineHandler::runTests()
@@ -89,6 +225,10 @@ int CommandLineHandler::runTests()
         fprintf(stderr, "Cannot create temp dir\n");
         return 1;
     }
+    // Queue preferences, run history and estimates go to a scratch scope
+    QStandardPaths::setTestModeEnabled(true);
+    Config::SETTINGS_APP = Config::APP_NAME + "Tests";
+    QSettings(Config::ORG_NAME, Config::SETTINGS_APP).clear();
 
     // ── 1. CulParser: dollar-sign header preserved ────────────────────────────
     fprintf(stdout, "[ CulParser: header lines ]\n");
@@ -293,7 +433,1467 @@ int CommandLineHandler::runTests()
         check(bad == 0, "all expNo variants produce space at pos 29");
     }
 
+    // ── 10. GlueResourceSampler: own process ─────────────────────────────────
+    fprintf(stdout, "\n[ GlueResourceSampler ]\n");
+    if (GlueResourceSampler::isSupported()) {
+        GlueResourceSampler sampler;
+        sampler.start(QCoreApplication::applicationPid());
+        volatile double sink = 0;
+        for (int i = 0; i < 20000000; ++i) sink = sink + i * 0.5;
+        sampler.markPhase("busy");
+        GlueResourceUsage u = sampler.finish();
+        check(u.available, "sampling available");
+        check(u.peakRssKb > 0, "peak RSS recorded");
+        check(u.cpuSeconds > 0, "CPU time recorded");
+        check(u.phaseSeconds.size() == 2 && u.phaseSeconds[1].first == "busy",
+              "phases closed in order");
+    } else {
+        GlueResourceSampler sampler;
+        sampler.start(QCoreApplication::applicationPid());
+        check(!sampler.finish().available, "sampling reported unavailable");
+    }
+
+    // ── 11. GlueResultCache: fingerprint ─────────────────────────────────────
+    fprintf(stdout, "\n[ GlueResultCache: fingerprint ]\n");
+    {
+        auto writeText = [](const QString &path, const QString &text) {
+            QFile f(path);
+            if (f.open(QIODevice::WriteOnly | QIODevice::Text)) f.write(text.toLatin1());
+        };
+        auto culRow = [](const QString &var, double a, double b, double c) {
+            return QString("%1 %2     . DFAULT%3%4%5\n")
+                .arg(var).arg("TEST", -16)
+                .arg(a, 6, 'f', 2).arg(b, 6, 'f', 2).arg(c, 6, 'f', 2);
+        };
+        // IB0001 is calibrated; P1 is a P parameter, P2 a G parameter
+        auto writeCul = [&](double ib1p1, double ib1p2, double ib2p1, const QString &comment) {
+            writeText(tmp.filePath("TSTST048.CUL"),
+                "*TEST CULTIVAR COEFFICIENTS\n"
+                "!Calibration     P     G     N\n"
+                "@VAR#  VRNAME.......... EXPNO   ECO#    P1    P2    P3\n"
+                + culRow("999991", 0.10, 0.10, 0.10)
+                + culRow("999992", 9.90, 9.90, 9.90)
+                + comment
+                + culRow("IB0001", ib1p1, ib1p2, 1.00)
+                + culRow("IB0002", ib2p1, 2.00, 2.00));
+        };
+        writeCul(1.00, 2.00, 3.00, QString());
+        writeText(tmp.filePath("TSTST048.ECO"), "*ECO\n@ECO#  ECONAME.........\nDFAULT DEFAULT\n");
+        writeText(tmp.filePath("TSTST048.SPE"), "*SPE\n! note\n  1.0  2.0\n");
+        writeText(tmp.filePath("TEST0001.TSX"), "*EXP.DETAILS: TEST0001TS\n");
+
+        GlueQueueEntry e;
+        e.cultivarId       = "IB0001";
+        e.cropInfo.module  = "TSTST048";
+        e.cropInfo.culFile = tmp.filePath("TSTST048.CUL");
+        e.cropInfo.ecoFile = tmp.filePath("TSTST048.ECO");
+        e.cropInfo.speFile = tmp.filePath("TSTST048.SPE");
+        e.selectedTreatments[tmp.filePath("TEST0001.TSX")] = {TreatmentEntry{2, {}}, TreatmentEntry{1, {}}};
+        e.runs     = 100;
+        e.glueFlag = 2;
+
+        QString fp0 = GlueResultCache::fingerprint(e);
+        check(fp0.size() == 64, "fingerprint is a SHA-256 hex digest");
+
+        writeCul(1.50, 2.00, 3.00, "! 2026-01-01 00:00 previous line\n");
+        check(GlueResultCache::fingerprint(e) == fp0,
+              "applying a phenology result + history comment keeps the fingerprint");
+
+        writeCul(1.00, 2.50, 3.00, QString());
+        check(GlueResultCache::fingerprint(e) != fp0, "uncalibrated parameter change invalidates");
+
+        writeCul(1.00, 2.00, 3.50, QString());
+        check(GlueResultCache::fingerprint(e) != fp0, "other cultivar change invalidates");
+
+        writeCul(1.00, 2.00, 3.00, QString());
+        e.selectedTreatments[tmp.filePath("TEST0001.TSX")] = {TreatmentEntry{1, {}}, TreatmentEntry{2, {}}};
+        check(GlueResultCache::fingerprint(e) == fp0, "treatment order does not matter");
+
+        e.runs = 200;
+        check(GlueResultCache::fingerprint(e) != fp0, "runs are part of the fingerprint");
+    }
+
+    // ── 12. GlueParamSampler ─────────────────────────────────────────────────
+    fprintf(stdout, "\n[ GlueParamSampler ]\n");
+    {
+        QString culPath = tmp.filePath("SMPLR048.CUL");
+        QFile f(culPath);
+        if (f.open(QIODevice::WriteOnly | QIODevice::Text))
+            f.write("*SAMPLER TEST\n"
+                    "!Calibration     P     G     N\n"
+                    "@VAR#  VRNAME.......... EXPNO   ECO#    P1    P2    P3\n"
+                    "999991 MINIMA               . DFAULT  1.00 10.00  0.10\n"
+                    "999992 MAXIMA               . DFAULT  3.00 20.00  0.90\n"
+                    "IB0001 TEST                 . DFAULT  2.00 15.00  0.50\n");
+        f.close();
+
+        QStringList hdr;
+        QVector<CulRow> rows = CulParser::parse(culPath, hdr);
+        GlueParamSpace r1 = GlueParamSampler::buildSpace(rows, hdr, "IB0001", 1, 1);
+        GlueParamSpace r2 = GlueParamSampler::buildSpace(rows, hdr, "IB0001", 1, 2);
+        check(r1.sampledCount() == 1 && r1.sampled.value(0), "round 1 of GLUEFlag 1 samples the P parameter");
+        check(r2.sampledCount() == 1 && r2.sampled.value(1), "round 2 of GLUEFlag 1 samples the G parameter");
+
+        QString err;
+        GlueParamSampler::buildSpace(rows, hdr, "XX9999", 1, 1, &err);
+        check(!err.isEmpty(), "unknown cultivar reported");
+
+        const int n = 1000;
+        GlueParamMatrix lhs = GlueParamSampler::generate(r1, n, GlueSamplingMethod::LatinHypercube, 42);
+        QVector<int> strata(n, 0);
+        bool inBox = true, fixedOk = true;
+        for (int i = 0; i < n; ++i) {
+            double v = lhs.value(i, 0);
+            inBox = inBox && v >= 1.0 && v < 3.0;
+            strata[qBound(0, int((v - 1.0) / 2.0 * n), n - 1)]++;
+            fixedOk = fixedOk && lhs.value(i, 1) == 15.0 && lhs.value(i, 2) == 0.5;
+        }
+        check(inBox, "LHS values inside MINIMA/MAXIMA");
+        check(!strata.contains(0), "LHS hits every stratum exactly once");
+        check(fixedOk, "unsampled parameters keep the cultivar's values");
+
+        GlueParamMatrix again = GlueParamSampler::generate(r1, n, GlueSamplingMethod::LatinHypercube, 42);
+        GlueParamMatrix other = GlueParamSampler::generate(r1, n, GlueSamplingMethod::LatinHypercube, 43);
+        check(again.columns == lhs.columns, "same seed reproduces the design");
+        check(other.columns != lhs.columns, "different seed changes the design");
+
+        GlueParamMatrix sob = GlueParamSampler::generate(r1, 1024, GlueSamplingMethod::Sobol, 0);
+        check(sob.value(0, 0) == 2.0 && sob.value(1, 0) == 2.5 && sob.value(2, 0) == 1.5,
+              "Sobol starts 0.5, 0.75, 0.25 of the range");
+        QVector<int> bins(1024, 0);
+        for (int i = 0; i < 1024; ++i) bins[int((sob.value(i, 0) - 1.0) / 2.0 * 1024)]++;
+        check(!bins.contains(0), "first 1024 Sobol points fill 1024 bins");
+
+        QString setsPath = tmp.filePath(GlueParamSampler::randomSetsFileName(1));
+        check(GlueParamSampler::writeRandomSets(setsPath, lhs), "writeRandomSets() returned true");
+        QFile sf(setsPath);
+        QList<QByteArray> lines;
+        if (sf.open(QIODevice::ReadOnly)) lines = sf.readAll().split('\n');
+        check(lines.size() == n + 2 && lines[0] == "P1 P2 P3",
+              "random-set file has a header and one line per set");
+    }
+
+    // ── 13. GlueLikelihood: posterior from GLUE-format fixtures ──────────────
+    fprintf(stdout, "\n[ GlueLikelihood ]\n");
+    {
+        auto writeText = [](const QString &path, const QByteArray &text) {
+            QFile f(path);
+            if (f.open(QIODevice::WriteOnly | QIODevice::Text)) f.write(text);
+        };
+        writeText(tmp.filePath("Sets.txt"), "P1 P2\n1 10\n2 20\n3 30\n");
+        // Set 2 reproduces the observations; set 3 failed to simulate HWAM in treatment 2
+        writeText(tmp.filePath("EvaluateFrame_1.txt"),
+            "@RUN EXCODE    TN  ADAPS  ADAPM  HWAMS  HWAMM\n"
+            "   1 UFGA8101   1     54     50   3100   3000\n"
+            "   1 UFGA8101   2     63     60   3300   3500\n"
+            "   2 UFGA8101   1     50     50   3000   3000\n"
+            "   2 UFGA8101   2     60     60   3500   3500\n"
+            "   3 UFGA8101   1     51     50   2900   3000\n"
+            "   3 UFGA8101   2     61     60    -99   3500\n");
+
+        GlueParamMatrix sets;
+        GlueEvalTable table;
+        check(GlueParamSampler::readRandomSets(tmp.filePath("Sets.txt"), sets) && sets.sets == 3,
+              "parameter sets read");
+        check(GlueLikelihood::readTable(tmp.filePath("EvaluateFrame_1.txt"), table) && table.rows == 6,
+              "evaluate table read");
+
+        GlueLikelihoodResult res = GlueLikelihood::evaluate(table, sets.sets);
+        check(res.errorMsg.isEmpty() && res.variables == QStringList({"ADAP", "HWAM"}),
+              "S/M pairs detected");
+        check(res.bestSet == 1, "max-probability set is the exact match");
+        check(res.weights.size() == 3 && res.weights[2] == 0.0, "failed run gets zero weight");
+        check(std::fabs(res.weights[0] + res.weights[1] - 1.0) < 1e-12, "weights are normalized");
+        const GlueLikelihoodResult streamed =
+            GlueLikelihood::evaluateFile(tmp.filePath("EvaluateFrame_1.txt"), sets.sets);
+        check(streamed.errorMsg.isEmpty() && streamed.bestSet == res.bestSet && streamed.sigma == res.sigma &&
+              streamed.weights.size() == 3 && std::fabs(streamed.weights[0] - res.weights[0]) < 1e-12 &&
+              streamed.weights[2] == 0.0, "streamed evaluation matches the in-memory table");
+
+        // Normalizing constants cancel in the ratio of two sets
+        double d2 = (16.0 + 9.0) / (res.sigma[0] * res.sigma[0])
+                  + (10000.0 + 40000.0) / (res.sigma[1] * res.sigma[1]);
+        check(std::fabs(res.weights[0] / res.weights[1] - std::exp(-0.5 * d2)) < 1e-9,
+              "weight ratio matches the Gaussian likelihood");
+
+        QVector<GlueParamPosterior> post = GlueLikelihood::posterior(sets, res);
+        check(post.size() == 2 && post[0].best == 2.0 && post[1].best == 20.0,
+              "posterior reports the max-probability set");
+        double mean = res.weights[0] * 1.0 + res.weights[1] * 2.0;
+        check(std::fabs(post[0].mean - mean) < 1e-12, "posterior mean is weight-averaged");
+
+        QString report = tmp.filePath("GluePosterior.txt");
+        check(GlueLikelihood::writeReport(report, res, post), "writeReport() returned true");
+    }
+
+    // ── 14. GlueParallelDriver: stand-in model across workers ────────────────
+    fprintf(stdout, "\n[ GlueParallelDriver ]\n");
+    {
+        QString dir = tmp.filePath("parallel");
+        QDir().mkpath(dir);
+        QFile cf(dir + "/STNDN048.CUL");
+        if (cf.open(QIODevice::WriteOnly | QIODevice::Text))
+            cf.write("*STAND-IN CULTIVARS\n"
+                     "!Calibration     P     G     N\n"
+                     "@VAR#  VRNAME.......... EXPNO   ECO#    P1    P2    P3\n"
+                     "999991 MINIMA               . DFAULT  1.00 10.00  0.10\n"
+                     "999992 MAXIMA               . DFAULT  3.00 20.00  0.90\n"
+                     "IB0001 TEST                 . DFAULT  2.60 15.00  0.50\n");
+        cf.close();
+
+        GlueDriverConfig cfg;
+        cfg.cropInfo.cropCode = "SN";
+        cfg.cropInfo.module   = "STNDN048";
+        cfg.cropInfo.culFile  = dir + "/STNDN048.CUL";
+        cfg.cultivarId        = "IB0001";
+        cfg.cultivarName      = "TEST";
+        cfg.treatments[dir + "/STND0001.SNX"] = {TreatmentEntry{1, {}}, TreatmentEntry{2, {}}};
+        cfg.program       = QCoreApplication::applicationFilePath();
+        cfg.programPrefix = QStringList{"--stand-in-model"};
+        cfg.scratchRoot   = dir + "/scratch";
+        cfg.workers       = 3;
+
+        GlueParamMatrix sets;
+        sets.names = QStringList{"P1"};
+        sets.sets  = 9;
+        sets.columns.resize(1);
+        for (int i = 0; i < sets.sets; ++i) sets.columns[0].push_back(1.0 + 0.25 * i);  // set 5 = 2.0
+
+        GlueParallelDriver driver;
+        QEventLoop loop;
+        bool ok = false;
+        QObject::connect(&driver, &GlueParallelDriver::finished, &loop, [&](bool s) { ok = s; loop.quit(); });
+        QString err;
+        bool started = driver.start(cfg, sets, &err);
+        check(started, qPrintable("driver started " + err));
+        if (started) loop.exec();
+        check(ok && driver.completedRuns() == 9 && driver.failedRuns() == 0, "all runs produced output");
+
+        QString merged = dir + "/EvaluateFrame_1.txt";
+        check(driver.writeMerged(merged), "writeMerged() returned true");
+
+        GlueEvalTable table;
+        GlueLikelihood::readTable(merged, table);
+        bool ordered = table.rows == 18;
+        int runCol = table.column("RUN");
+        for (int r = 0; ordered && r < table.rows; ++r)
+            ordered = runCol >= 0 && int(table.data[runCol][r]) == r / 2 + 1;
+        check(ordered, "merged rows are in set order, one per treatment");
+
+        GlueLikelihoodResult res = GlueLikelihood::evaluate(table, sets.sets);
+        check(res.bestSet == 4, "likelihood recovers the stand-in's true parameter");
+
+        // A model that never starts fails every run, and so the batch
+        cfg.program       = dir + "/no-such-model";
+        cfg.programPrefix = QStringList();
+        GlueParallelDriver broken;
+        ok = true;
+        QObject::connect(&broken, &GlueParallelDriver::finished, &loop, [&](bool s) { ok = s; loop.quit(); });
+        started = broken.start(cfg, sets, &err);
+        if (started) loop.exec();
+        check(started && !ok && broken.completedRuns() == 9 && broken.failedRuns() == 9,
+              "batch without any output reports failure");
+    }
+
+    // ── 15. GlueOutputReader: streamed prior/posterior histograms ─────────────
+    fprintf(stdout, "\n[ GlueOutputReader ]\n");
+    {
+        QString dir = tmp.filePath("glueout");
+        QDir().mkpath(dir);
+        QFile sf(dir + "/" + GlueParamSampler::randomSetsFileName(1));
+        QFile lf(dir + "/LikelihoodMatrix_1.txt");
+        if (sf.open(QIODevice::WriteOnly | QIODevice::Text) &&
+            lf.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            QTextStream ss(&sf), ls(&lf);
+            ss << "P1 P2 P3\n";
+            ls << "\"Probability\"\n";   // R write.table layout: row names, quoted header
+            for (int i = 0; i < 200; ++i) {
+                ss << QString("%1 %2 0.5\n").arg(1.0 + i * 0.01).arg(10.0 + (i % 10));
+                ls << QString("\"%1\" %2\n").arg(i + 1).arg(i == 50 ? 1.0 : 0.0);
+            }
+        }
+        sf.close();
+        lf.close();
+
+        GlueDistributions d = GlueOutputReader::distributions(dir, 1, 20);
+        check(d.errorMsg.isEmpty() && d.sets == 200, "all 200 sets streamed");
+        check(d.params.size() == 2, "fixed parameter (P3) is not plotted");
+        check(d.weighted && d.weightSource == "LikelihoodMatrix_1.txt", "weights taken from likelihood table");
+        if (d.params.size() == 2) {
+            const GlueParamHistogram &p1 = d.params[0];
+            double priorSum = 0, postMax = 0;
+            for (double c : p1.prior) priorSum += c;
+            for (double c : p1.posterior) postMax = qMax(postMax, c);
+            check(std::fabs(priorSum - 1.0) < 1e-9, "prior shares sum to 1");
+            check(std::fabs(postMax - 1.0) < 1e-9, "posterior mass in the bin of the only likely set");
+            check(std::fabs(p1.best - 1.5) < 1e-9 && std::fabs(p1.mean - 1.5) < 1e-9,
+                  "max-probability value and posterior mean");
+        }
+
+        // A likelihood table that does not line up with the sets is ignored
+        if (lf.open(QIODevice::WriteOnly | QIODevice::Text)) lf.write("PROBABILITY\n1.0\n");
+        lf.close();
+        d = GlueOutputReader::distributions(dir, 1, 20);
+        check(!d.weighted && d.params.size() == 2, "mismatched likelihood table falls back to prior only");
+
+        // Without a likelihood table the EvaluateFrame is scored; set 121 fits best
+        lf.remove();
+        QFile ef(dir + "/EvaluateFrame_1.txt");
+        if (ef.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            QTextStream es(&ef);
+            es << "@RUN TN ADAPS ADAPM\n";
+            for (int i = 0; i < 200; ++i)
+                for (int t = 1; t <= 2; ++t)
+                    es << QString("%1 %2 %3 50\n").arg(i + 1).arg(t).arg(50 + qAbs(i - 120));
+        }
+        ef.close();
+        d = GlueOutputReader::distributions(dir, 1, 20);
+        check(d.weighted && d.weightSource.startsWith("EvaluateFrame_1.txt") && d.params.size() == 2 &&
+              std::fabs(d.params[0].best - 2.2) < 1e-9, "EvaluateFrame scored when no weights are written");
+
+        // Rows wider than any fixed buffer keep every column
+        QFile wf(dir + "/Wide.txt");
+        if (wf.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            QStringList names, values;
+            for (int c = 0; c < 300; ++c) { names << QString("C%1").arg(c); values << QString::number(c); }
+            wf.write((names.join(' ') + '\n' + values.join(' ') + '\n').toLatin1());
+        }
+        wf.close();
+        GlueTableStream wide;
+        check(wide.open(wf.fileName()) && wide.next() && wide.value(299) == 299.0, "300-column row read whole");
+    }
+
+    // ── 16. SimulationControl: typed fields, validation, render, cache ────────
+    fprintf(stdout, "\n[ SimulationControl ]\n");
+    {
+        QString path = tmp.filePath("SimulationControl.csv");
+        QFile f(path);
+        if (f.open(QIODevice::WriteOnly | QIODevice::Text))
+            f.write("Name,Value\n"
+                    "NumberOfModelRun,100\n"
+                    "GLUEFlag,1\n"
+                    "EcotypeCalibration,N\n"
+                    "CultivarBatchFile,IB0001.WHC\n"
+                    "ModelID,WHCER048\n"
+                    "OutputD,/tmp/GLWork\n"
+                    "GLUED,/tmp/GLUE\n");
+        f.close();
+
+        SimulationControl sc;
+        check(SimulationControl::cached(path, sc), "cached() parses the file");
+        check(sc.numberOfModelRun == 100 && sc.glueFlag == 1 && sc.outputDir == "/tmp/GLWork",
+              "typed fields read");
+        check(sc.value("GLUED") == "/tmp/GLUE", "untyped keys kept");
+
+        CropInfo ci;
+        ci.cropCode = "MZ";
+        ci.module   = "MZCER048";
+        sc.configureJob(ci, "IB0171", 5000, 2, "N");
+        check(sc.validate().isEmpty(), "configured job validates");
+        QString job = tmp.filePath("job1/SimulationControl.csv");
+        QDir().mkpath(QFileInfo(job).absolutePath());
+        check(sc.writeTo(job), "writeTo() a job sandbox");
+
+        SimulationControl back;
+        SimulationControl::load(job, back);
+        check(back.numberOfModelRun == 5000 && back.glueFlag == 2 &&
+              back.cultivarBatchFile == "IB0171.MZC" && back.modelId == "MZCER048",
+              "rendered job round-trips");
+        check(back.render().startsWith("Name,Value\nNumberOfModelRun,5000\n") &&
+              back.render().endsWith("GLUED,/tmp/GLUE\n"), "line order and other lines preserved");
+
+        SimulationControl shared;
+        SimulationControl::cached(path, shared);
+        check(shared.numberOfModelRun == 100, "shared file untouched by job render");
+
+        sc.glueFlag = 7;
+        sc.modelId  = "MZ";
+        check(sc.validate().size() == 2, "validate() reports bad GLUEFlag and ModelID");
+
+        // Cache follows changes on disk
+        if (f.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate))
+            f.write("NumberOfModelRun,250\nOutputD,/tmp/GLWork\n");
+        f.close();
+        SimulationControl changed;
+        SimulationControl::cached(path, changed);
+        check(changed.numberOfModelRun == 250, "cache re-reads a modified file");
+    }
+
+    // ── 17. GlueLogBuffer: bounded ring, partial lines, per-job file ──────────
+    fprintf(stdout, "\n[ GlueLogBuffer ]\n");
+    {
+        QString path = tmp.filePath("logs/job.log");
+        GlueLogBuffer log(4);
+        log.setWatchPatterns({"Error in "});
+        check(log.reset(path), "reset() opens the job log file");
+
+        log.append("line 0\nline", false);
+        log.append(" 1\r\nline 2\n", false);
+        check(log.totalLines() == 3 && log.line(1) == "line 1", "partial line joined across reads");
+        log.append("Error in foo()\n", true);
+        log.appendLine("line 4\nline 5");
+        check(log.totalLines() == 6 && log.firstLine() == 2, "ring keeps the newest capacity lines");
+        check(log.line(0).isEmpty() && log.line(5) == "line 5", "evicted lines no longer held");
+        check(log.tail(10, true) == QStringList{"Error in foo()"}, "tail() of error lines");
+        check(log.watchMatched(), "watch pattern matched");
+
+        log.append("no newline", false);
+        log.flush();
+        check(log.totalLines() == 7 && log.line(6) == "no newline", "flush() emits pending partial line");
+
+        log.appendLine(QString(GlueLogBuffer::MAX_LINE_LENGTH + 50, 'x'));
+        check(log.line(7).size() == GlueLogBuffer::MAX_LINE_LENGTH + 1, "long line cut in memory");
+        log.flush();
+
+        QFile f(path);
+        int onDisk = 0;
+        if (f.open(QIODevice::ReadOnly | QIODevice::Text))
+            onDisk = QString::fromUtf8(f.readAll()).split('\n', Qt::SkipEmptyParts).size();
+        check(onDisk == 8, "every line written to the log file");
+
+        GlueLogBuffer old(3);
+        check(old.loadTail(path) && old.totalLines() == 8 && old.line(5) == "line 5",
+              "loadTail() keeps only the last lines");
+        check(old.filePath() == path, "loaded buffer names the full log");
+    }
+
+    // ── 18. GlueJobPipeline: sandboxes, stages, events, cancel ────────────────
+    fprintf(stdout, "\n[ GlueJobPipeline ]\n");
+    {
+        const QString savedDir = GlueRunner::GLUE_DIR, savedWork = GlueRunner::GLUE_WORK;
+        GlueRunner::GLUE_DIR  = tmp.filePath("headless/GLUE");
+        GlueRunner::GLUE_WORK = tmp.filePath("headless/GLWork");
+        QDir().mkpath(GlueRunner::GLUE_DIR);
+        QDir().mkpath(GlueRunner::GLUE_WORK);
+        QFile f(GlueRunner::GLUE_DIR + "/SimulationControl.csv");
+        if (f.open(QIODevice::WriteOnly | QIODevice::Text))
+            f.write(QString("Name,Value\nNumberOfModelRun,1\nGLUEFlag,1\nEcotypeCalibration,N\n"
+                            "CultivarBatchFile,IB0001.SNC\nModelID,STNDN048\nOutputD,%1\n")
+                        .arg(GlueRunner::GLUE_WORK).toUtf8());
+        f.close();
+
+        // Progress parsing shared with the queue
+        QFile ind(GlueRunner::GLUE_WORK + "/ModelRunIndicator.txt");
+        if (ind.open(QIODevice::WriteOnly | QIODevice::Text))
+            ind.write("GLUE Flag: 1\nModel runs are starting.\n");
+        ind.close();
+        GlueProgress gp;
+        check(GlueRunner::readProgress(ind.fileName(), gp) && gp.percent == 16 &&
+              gp.label.startsWith("Model runs"), "readProgress() maps phase to percent");
+        check(!GlueRunner::readProgress(ind.fileName(), gp), "readProgress() consumes only new lines");
+        auto appendIndicator = [&ind](const QByteArray &text) {
+            if (ind.open(QIODevice::Append | QIODevice::Text)) ind.write(text);
+            ind.close();
+        };
+        appendIndicator("Likelihood calculation is starting.\n");
+        check(GlueRunner::readProgress(ind.fileName(), gp) && gp.percent == 25 &&
+              gp.label.startsWith("Likelihood calculation is starting"), "first appended line seen");
+        appendIndicator("Likelihood calculation is finished.");
+        check(!GlueRunner::readProgress(ind.fileName(), gp), "partial last line left for the next poll");
+        appendIndicator("\n");
+        check(GlueRunner::readProgress(ind.fileName(), gp) && gp.percent == 33 &&
+              gp.label.startsWith("Likelihood calculation is finished"), "completed line read once whole");
+
+        auto makeJob = [](const QString &id, int runs) {
+            GlueJobSpec job;
+            job.cropInfo.cropCode = "SN";
+            job.cropInfo.module   = "STNDN048";
+            job.cultivarId        = id;
+            job.cultivarName      = "TEST";
+            job.treatments["STND0001.SNX"] = {TreatmentEntry{1, {}}};
+            job.runs              = runs;
+            return job;
+        };
+        auto runAll = [](GlueJobPipeline &runner, QList<QJsonObject> &events) {
+            QEventLoop loop;
+            int code = -1;
+            QObject::connect(&runner, &GlueJobPipeline::event,
+                             [&events](const QJsonObject &e) { events << e; });
+            QObject::connect(&runner, &GlueJobPipeline::finished, &loop, [&](int c) {
+                code = c;
+                loop.quit();
+            });
+            if (runner.start()) loop.exec();
+            return code;
+        };
+
+        GlueJobPipeline runner;
+        runner.setProgram(QCoreApplication::applicationFilePath(), {"--stand-in-glue"});
+        runner.setConcurrency(2);
+        for (const QString &id : {"IB0001", "IB0002", "FAIL01"}) runner.addJob(makeJob(id, 20));
+        QList<QJsonObject> events;
+        int code = runAll(runner, events);
+
+        int active = 0, maxActive = 0, ok = 0, failed = 0;
+        bool failureReported = false;
+        for (const QJsonObject &e : events) {
+            const QString type = e["event"].toString();
+            if (type == "start") maxActive = qMax(maxActive, ++active);
+            if (type != "finished") continue;
+            --active;
+            if (e["status"].toString() == "ok") ++ok;
+            if (e["status"].toString() == "failed") {
+                ++failed;
+                failureReported = e["errors"].toArray().size() > 0 &&
+                                  e["errors"].toArray()[0].toString().startsWith("Error in");
+            }
+        }
+        check(code == 1 && ok == 2 && failed == 1, "two jobs succeed, failing job sets exit code 1");
+        check(maxActive == 2, "no more than --jobs calibrations at once");
+        check(failureReported, "failed job event carries its stderr tail");
+        check(!events.isEmpty() && events.last()["event"].toString() == "done", "done event closes the stream");
+
+        SimulationControl sandbox, shared;
+        SimulationControl::load(runner.result(1).workDir + "/SimulationControl.csv", sandbox);
+        SimulationControl::load(GlueRunner::GLUE_DIR + "/SimulationControl.csv", shared);
+        check(sandbox.cultivarBatchFile == "IB0002.SNC" && sandbox.numberOfModelRun == 20 &&
+              QDir::fromNativeSeparators(sandbox.outputDir).endsWith("Jobs/SN_IB0002_1"),
+              "each job runs in its own sandbox");
+        check(shared.numberOfModelRun == 1, "shared SimulationControl.csv untouched");
+        check(QFile::exists(runner.result(0).workDir + "/ModelRunIndicator.txt"),
+              "GLUE output lands in the sandbox");
+
+        // Two entries for one cultivar run side by side in their own sandboxes
+        GlueJobPipeline twins;
+        twins.setProgram(QCoreApplication::applicationFilePath(), {"--stand-in-glue"});
+        twins.setConcurrency(2);
+        twins.addJob(makeJob("IB0005", 20));
+        twins.addJob(makeJob("IB0005", 10));
+        events.clear();
+        code = runAll(twins, events);
+        SimulationControl first, second;
+        SimulationControl::load(twins.result(0).workDir + "/SimulationControl.csv", first);
+        SimulationControl::load(twins.result(1).workDir + "/SimulationControl.csv", second);
+        check(code == 0 && twins.result(0).workDir != twins.result(1).workDir,
+              "same cultivar twice gets two sandboxes");
+        check(first.numberOfModelRun == 20 && second.numberOfModelRun == 10 &&
+              QFile::exists(twins.result(0).workDir + "/ModelRunIndicator.txt") &&
+              twins.result(0).culLine.startsWith("IB0005") && twins.result(1).culLine.startsWith("IB0005"),
+              "preparing the second job leaves the running one intact");
+
+        // Cancelling stops a long job without waiting for it
+        GlueJobPipeline slow;
+        slow.setProgram(QCoreApplication::applicationFilePath(), {"--stand-in-glue"});
+        slow.addJob(makeJob("IB0003", 5000));
+        slow.addJob(makeJob("IB0004", 5000));
+        connect(&slow, &GlueJobPipeline::event, &slow, [&slow](const QJsonObject &e) {
+            if (e["event"].toString() == "start")
+                QTimer::singleShot(200, &slow, [&slow] { slow.cancel("test"); });
+        });
+        QList<QJsonObject> slowEvents;
+        QElapsedTimer elapsed;
+        elapsed.start();
+        code = runAll(slow, slowEvents);
+        int starts = 0;
+        for (const QJsonObject &e : slowEvents) starts += e["event"].toString() == "start";
+        check(code == 130 && elapsed.elapsed() < 10000, "cancel() ends the run with code 130");
+        check(starts == 1, "queued jobs are not started after cancel()");
+
+        // Stages: the next sandbox is prepared ahead, results are harvested
+        // and snapshots copied in the background
+        GlueJobPipeline staged;
+        staged.setProgram(QCoreApplication::applicationFilePath(), {"--stand-in-glue"});
+        const QString snapDir = tmp.filePath("headless/Snap");
+        for (const QString &id : {"IB0011", "IB0012", "IB0013"}) {
+            GlueJobSpec job = makeJob(id, 10);
+            job.snapshotDir = snapDir + "/" + id;
+            staged.addJob(job);
+        }
+        check(staged.dropJob(2) && staged.pendingJobs() == 2, "dropJob() forgets a queued job");
+        bool preparedAhead = false, snapshotAfterHarvest = true;
+        QList<int> harvested;
+        connect(&staged, &GlueJobPipeline::jobFinished, &staged, [&](int id) {
+            harvested << id;
+            // The next sandbox was written while this job ran
+            if (id == 0)
+                preparedAhead = staged.stage(1) == GlueJobStage::Prepared &&
+                                QFile::exists(staged.result(1).workDir + "/SimulationControl.csv");
+        });
+        connect(&staged, &GlueJobPipeline::jobSnapshotted, &staged, [&](int id, bool ok) {
+            if (!ok || !harvested.contains(id)) snapshotAfterHarvest = false;
+        });
+        QList<int> assessed;
+        connect(&staged, &GlueJobPipeline::jobAssessed, &staged, [&](int id) {
+            if (harvested.contains(id)) assessed << id;
+        });
+        events.clear();
+        code = runAll(staged, events);
+        check(code == 0 && harvested == QList<int>({0, 1}), "pipeline drains its jobs in order");
+        check(preparedAhead, "next job prepared while the current one runs");
+        check(staged.stage(2) == GlueJobStage::Dropped && !staged.dropJob(0),
+              "dropped job never starts; finished jobs cannot be dropped");
+        check(staged.result(0).culLine.startsWith("IB0011") && staged.result(0).launched,
+              "calibrated CUL line harvested from the work dir");
+        check(snapshotAfterHarvest && staged.stage(1) == GlueJobStage::Done &&
+              QFile::exists(snapDir + "/IB0012/STNDN048.CUL") &&
+              QFile::exists(snapDir + "/IB0012/GlueRun.log"),
+              "snapshot copied after harvest, with the run log");
+        check(assessed == QList<int>({0, 1}), "convergence assessed in the background after harvest");
+
+        // The shared layout works in GLUE_DIR/GLWork like the wizard
+        GlueJobPipeline single;
+        single.setProgram(QCoreApplication::applicationFilePath(), {"--stand-in-glue"});
+        single.setLayout(GlueJobPipeline::SharedLayout);
+        single.addJob(makeJob("IB0014", 1));
+        events.clear();
+        code = runAll(single, events);
+        SimulationControl::load(GlueRunner::GLUE_DIR + "/SimulationControl.csv", shared);
+        check(code == 0 && single.result(0).workDir == GlueRunner::GLUE_WORK &&
+              single.result(0).culLine.startsWith("IB0014") &&
+              shared.cultivarBatchFile == "IB0014.SNC",
+              "shared layout runs in the GUI's GLUE directory");
+
+        GlueRunner::GLUE_DIR  = savedDir;
+        GlueRunner::GLUE_WORK = savedWork;
+    }
+
+    // ── 19. GlueQueueModel: row signals, fine-grained dataChanged, filter ─────
+    fprintf(stdout, "\n[ GlueQueueModel ]\n");
+    {
+        // No SimulationControl.csv here, so every job fails before R is started
+        const QString savedDir = GlueRunner::GLUE_DIR, savedWork = GlueRunner::GLUE_WORK;
+        GlueRunner::GLUE_DIR  = tmp.filePath("queue/GLUE");
+        GlueRunner::GLUE_WORK = tmp.filePath("queue/GLWork");
+
+        GlueQueueManager manager;
+        GlueQueueModel model(&manager);
+        int inserted = 0, removed = 0;
+        QList<QPair<int, int>> changedCols;
+        connect(&model, &QAbstractItemModel::rowsInserted, &model, [&] { ++inserted; });
+        connect(&model, &QAbstractItemModel::rowsRemoved,  &model, [&] { ++removed; });
+        connect(&model, &QAbstractItemModel::dataChanged, &model,
+                [&](const QModelIndex &tl, const QModelIndex &br) {
+            changedCols << qMakePair(tl.column(), br.column());
+        });
+
+        for (const QString &id : {"IB0001", "IB0002", "IB0003"}) {
+            GlueQueueEntry e;
+            e.cultivarId = id;
+            e.cropInfo.cropCode = "SN";
+            e.cropInfo.module   = "STNDN048";
+            e.forceRerun = true;
+            if (id == QLatin1String("IB0003")) {
+                e.selectedTreatments["A.SNX"] = {TreatmentEntry{1, {}}, TreatmentEntry{2, {}}};
+                e.selectedTreatments["B.SNX"] = {TreatmentEntry{1, {}}};
+            }
+            manager.addEntry(e);
+        }
+        // The pipeline prepares jobs from the event loop
+        QElapsedTimer drain;
+        drain.start();
+        while (manager.isRunning() && drain.elapsed() < 5000)
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+        check(inserted == 3 && model.rowCount() == 3, "one rowsInserted per queued entry");
+        check(model.data(model.index(0, GlueQueueModel::COL_STATUS), GlueQueueModel::StatusRole).toInt()
+                  == static_cast<int>(GlueQueueStatus::Failed), "failed job reported through the model");
+        const QModelIndex treatments = model.index(2, GlueQueueModel::COL_TREATMENTS);
+        check(model.data(treatments).toString() == "3 treatment(s)" &&
+              model.data(treatments, GlueQueueModel::SortRole).toInt() == 3,
+              "treatments counted over all experiment files");
+
+        bool onlyStatusCols = !changedCols.isEmpty();
+        for (const auto &c : changedCols)
+            if (c.first < GlueQueueModel::COL_STATUS) onlyStatusCols = false;
+        check(onlyStatusCols, "status changes repaint status columns only");
+
+        changedCols.clear();
+        manager.setPriority(1, 2);
+        check(changedCols.size() == 1 && changedCols[0] == qMakePair(int(GlueQueueModel::COL_MODE),
+                                                                     int(GlueQueueModel::COL_MODE)),
+              "priority change repaints one cell");
+        check(model.data(model.index(1, GlueQueueModel::COL_MODE)).toString().endsWith("[prio +2]"),
+              "mode cell shows priority");
+
+        GlueQueueFilterProxy proxy;
+        proxy.setSourceModel(&model);
+        proxy.setStatusMask(GlueQueueFilterProxy::statusBit(GlueQueueStatus::Pending));
+        check(proxy.rowCount() == 0, "status filter hides other rows");
+        proxy.setStatusMask(GlueQueueFilterProxy::statusBit(GlueQueueStatus::Failed));
+        proxy.sort(GlueQueueModel::COL_MODE, Qt::AscendingOrder);
+        check(proxy.rowCount() == 3 &&
+              proxy.data(proxy.index(0, GlueQueueModel::COL_VARNUM)).toString() == "IB0002",
+              "sort on raw values (highest priority first within a mode)");
+
+        manager.removeEntry(0);
+        manager.clearDone();
+        check(removed == 3 && model.rowCount() == 0 && proxy.rowCount() == 0,
+              "removals reach model and proxy");
+
+        GlueRunner::GLUE_DIR  = savedDir;
+        GlueRunner::GLUE_WORK = savedWork;
+    }
+
+    // ── 20. GlueResultMerger: batch merge, one backup, idempotent ────────────
+    fprintf(stdout, "\n[ GlueResultMerger ]\n");
+    {
+        QString dir = tmp.filePath("merge");
+        QDir().mkpath(dir);
+        QString culPath = dir + "/MRGTS048.CUL";
+        QFile cf(culPath);
+        if (cf.open(QIODevice::WriteOnly | QIODevice::Text))
+            cf.write("*MERGE CULTIVARS\n"
+                     "@VAR#  VRNAME.......... EXPNO   ECO#    P1    P2    P3\n"
+                     "999991 MINIMA               . DFAULT  1.00 10.00  0.10\n"
+                     "999992 MAXIMA               . DFAULT  3.00 20.00  0.90\n"
+                     "IB0001 FIRST                . DFAULT  2.00 15.00  0.50\n"
+                     "IB0002 SECOND               . DFAULT  2.50 12.00  0.40\n");
+        cf.close();
+
+        const QStringList results = {
+            "IB0001 FIRST                . DFAULT 2.213 16.40 0.512",
+            "IB0002 SECOND               . DFAULT  2.50 12.00  0.40",
+            "IB0003 THIRD                . DFAULT 1.750 11.10 0.333",
+            "not a cultivar line",
+        };
+
+        QStringList hdr;
+        QVector<CulRow> rows = CulParser::parse(culPath, hdr);
+        GlueMergeResult r = GlueResultMerger::mergeRows(rows, 3, results);
+        check(r.updated == 1 && r.added == 1 && r.unchanged == 1 && r.skipped.size() == 1,
+              "one update, one add, one unchanged, one skipped");
+        check(rows.size() == 5 && rows[2].params.value(0).value_or(0) == 2.213 &&
+              rows[2].paramStrs.value(0) == "2.213", "calibrated values and their text applied");
+        check(rows[2].preComment.startsWith("! ") && rows[2].preComment.contains("2.00"),
+              "old line kept as dated comment");
+        GlueMergeResult again = GlueResultMerger::mergeRows(rows, 3, results);
+        check(again.changes() == 0 && again.unchanged == 3, "merging the same results again changes nothing");
+        QVector<CulRow> noAdd = CulParser::parse(culPath, hdr);
+        check(GlueResultMerger::mergeRows(noAdd, 3, results, false).added == 0 && noAdd.size() == 4,
+              "addMissing=false leaves unknown cultivars out");
+
+        GlueMergeResult fr;
+        QString err;
+        bool ok = GlueResultMerger::mergeFile(culPath, results, fr, &err);
+        QStringList baks = QDir(dir).entryList({"MRGTS048.*.bak"}, QDir::Files);
+        check(ok && fr.changes() == 2 && baks.size() == 1 && !fr.backupPath.isEmpty(),
+              "mergeFile writes once with a single backup");
+        QStringList hdr2;
+        QVector<CulRow> written = CulParser::parse(culPath, hdr2);
+        check(written.size() == 5 && written[4].varNum == "IB0003", "merged file holds the added cultivar");
+        GlueMergeResult fr2;
+        GlueResultMerger::mergeFile(culPath, results, fr2, &err);
+        check(fr2.changes() == 0 && fr2.backupPath.isEmpty(), "no-op merge leaves the file and backups alone");
+
+        QList<GlueQueueEntry> entries;
+        GlueQueueEntry done, pending;
+        done.status = GlueQueueStatus::Done;
+        done.resultCulLine = results[0];
+        done.cropInfo.culFile = culPath;
+        pending.resultCulLine = results[2];
+        pending.cropInfo.culFile = culPath;
+        entries << done << pending;
+        auto byFile = GlueResultMerger::finishedResults(entries);
+        check(byFile.size() == 1 && byFile.value(culPath) == QStringList{results[0]},
+              "only finished entries are collected");
+    }
+
+    // ── 21. GlueConvergenceMonitor: batch checks, early stop, replay ─────────
+    fprintf(stdout, "\n[ GlueConvergenceMonitor ]\n");
+    {
+        QString dir = tmp.filePath("converge");
+        QDir().mkpath(dir);
+        // Stand-in model output for P1: ADAPS = 30 + 10*P1 + TRNO against ADAPM = 50 + TRNO
+        auto writeRound = [&](const QString &sub, const std::vector<double> &p1) {
+            QDir().mkpath(dir + "/" + sub);
+            GlueParamMatrix m;
+            m.names = QStringList{"P1"};
+            m.sets  = int(p1.size());
+            m.columns = {p1};
+            GlueParamSampler::writeRandomSets(dir + "/" + sub + "/" + GlueParamSampler::randomSetsFileName(1), m);
+            QFile ef(dir + "/" + sub + "/EvaluateFrame_1.txt");
+            if (ef.open(QIODevice::WriteOnly | QIODevice::Text)) {
+                QTextStream ts(&ef);
+                ts << "@RUN TRNO ADAPS ADAPM\n";
+                for (int i = 0; i < m.sets; ++i)
+                    for (int t = 1; t <= 2; ++t)
+                        ts << i + 1 << ' ' << t << ' ' << 30 + 10 * p1[i] + t << ' ' << 50 + t << '\n';
+            }
+        };
+
+        // The same nine values repeat: the posterior is settled after the first batch
+        std::vector<double> cyclic, creeping;
+        for (int i = 0; i < 90; ++i) cyclic.push_back(1.0 + 0.25 * (i % 9));
+        // Values approach the truth (2.0) run after run: the best set never settles
+        for (int i = 0; i < 90; ++i) creeping.push_back(1.0 + i / 90.0);
+        writeRound("cyclic", cyclic);
+        writeRound("creeping", creeping);
+
+        GlueConvergenceOptions opt;
+        opt.batchSize = 9;
+        opt.minRuns = 18;
+        opt.stableChecks = 2;
+        GlueConvergenceMonitor settled(opt), moving(opt);
+        check(settled.replay(dir + "/cyclic", 1) && settled.history().size() == 10,
+              "replay checks every batch of runs");
+        check(settled.converged() && settled.verdict() == "converged after 27 runs",
+              "stable posterior converges after stableChecks checks");
+        check(std::fabs(settled.history().last().posterior.value(0).mean - 2.0) < 0.01,
+              "posterior mean follows the weighted runs");
+        check(moving.replay(dir + "/creeping", 1) && moving.needsMoreRuns() &&
+              moving.verdict().startsWith("needs more runs"), "drifting posterior is flagged");
+        bool flagged = false;
+        QString verdict = GlueConvergenceMonitor::assessRun(dir + "/creeping", 90, &flagged);
+        check(flagged && verdict.contains("needs more runs"), "assessRun flags a finished run");
+
+        // Early stop in the parallel driver with the stand-in model
+        QFile cf(dir + "/STNDN048.CUL");
+        if (cf.open(QIODevice::WriteOnly | QIODevice::Text))
+            cf.write("*STAND-IN CULTIVARS\n"
+                     "!Calibration     P     G     N\n"
+                     "@VAR#  VRNAME.......... EXPNO   ECO#    P1    P2    P3\n"
+                     "999991 MINIMA               . DFAULT  1.00 10.00  0.10\n"
+                     "999992 MAXIMA               . DFAULT  3.00 20.00  0.90\n"
+                     "IB0001 TEST                 . DFAULT  2.60 15.00  0.50\n");
+        cf.close();
+        GlueDriverConfig cfg;
+        cfg.cropInfo.cropCode = "SN";
+        cfg.cropInfo.module   = "STNDN048";
+        cfg.cropInfo.culFile  = dir + "/STNDN048.CUL";
+        cfg.cultivarId        = "IB0001";
+        cfg.cultivarName      = "TEST";
+        cfg.treatments[dir + "/STND0001.SNX"] = {TreatmentEntry{1, {}}, TreatmentEntry{2, {}}};
+        cfg.program       = QCoreApplication::applicationFilePath();
+        cfg.programPrefix = QStringList{"--stand-in-model"};
+        cfg.scratchRoot   = dir + "/scratch";
+        cfg.workers       = 3;
+
+        GlueParamMatrix sets;
+        sets.names = QStringList{"P1"};
+        sets.sets  = int(cyclic.size());
+        sets.columns = {cyclic};
+
+        opt.stopEarly = true;
+        GlueParallelDriver driver;
+        driver.setConvergence(opt);
+        int checks = 0;
+        QEventLoop loop;
+        bool ok = false;
+        QObject::connect(&driver, &GlueParallelDriver::convergenceChecked, &loop,
+                         [&](const GlueConvergenceCheck &) { ++checks; });
+        QObject::connect(&driver, &GlueParallelDriver::finished, &loop, [&](bool s) { ok = s; loop.quit(); });
+        QString err;
+        bool started = driver.start(cfg, sets, &err);
+        check(started, qPrintable("driver started " + err));
+        if (started) loop.exec();
+        check(ok && driver.stoppedEarly() && driver.completedRuns() < sets.sets,
+              "converged run stops launching sets");
+        check(checks == 3 && driver.convergence()->converged(), "driver checks once per batch");
+    }
+
+    // ── 22. CulTableModel: cached cell state, violation index ────────────────
+    fprintf(stdout, "\n[ CulTableModel cell state ]\n");
+    {
+        CulTableModel model;
+        int lastCount = -1, emitted = 0;
+        connect(&model, &CulTableModel::violationsChanged, &model, [&](int n) { lastCount = n; ++emitted; });
+        model.setParamNames({"P1", "P2"});
+        model.setRows({makeCulRow("999991", {1.0, 10.0}, "DFAULT", true),
+                       makeCulRow("999992", {3.0, 20.0}, "DFAULT", true),
+                       makeCulRow("IB0001", {2.0, 25.0}), makeCulRow("IB0002", {std::nullopt, 15.0})});
+
+        check(model.cellState(2, 0) == CulTableModel::CellInRange &&
+              model.cellState(2, 1) == CulTableModel::CellOutOfRange &&
+              model.cellState(3, 0) == CulTableModel::CellEmpty &&
+              (model.cellState(0, 0) & CulTableModel::CellMinMax), "states computed on load");
+        const int c1 = CulTableModel::COL_PARAM0 + 1;
+        check(model.data(model.index(2, c1), Qt::ToolTipRole).toString().contains("Allowed: 10 to 20"),
+              "out-of-range tooltip shows the cached range");
+        check(model.data(model.index(2, c1), Qt::BackgroundRole).value<QBrush>().color() == Config::OOR_COLOR,
+              "out-of-range cell painted");
+
+        check(model.violationCount() == 1 && lastCount == 1, "violation index filled on load");
+
+        model.setData(model.index(2, c1), "12");
+        check(model.cellState(2, 1) == CulTableModel::CellInRange &&
+              !model.data(model.index(2, c1), Qt::BackgroundRole).isValid(), "setData() refreshes the cell");
+        check(model.violationCount() == 0 && lastCount == 0, "fixed value leaves the index");
+        emitted = 0;
+        model.setData(model.index(2, c1), "13");
+        check(emitted == 0, "edits inside the range do not touch the index");
+        model.setData(model.index(3, CulTableModel::COL_PARAM0), "5");
+        check(model.getViolations().size() == 1 && model.getViolations()[0].varNum == "IB0002",
+              "violations read from the state bitmap");
+        emitted = 0;
+        model.setData(model.index(3, CulTableModel::COL_PARAM0), "6");
+        check(emitted == 1 && model.getViolations()[0].value == 6.0,
+              "new out-of-range value reported though the set is unchanged");
+        model.setData(model.index(3, CulTableModel::COL_VARNUM), "IB0009");
+        check(emitted == 2 && model.getViolations()[0].varNum == "IB0009", "renamed VAR# reported");
+        model.setData(model.index(3, CulTableModel::COL_VARNUM), "IB0002");
+
+        model.deleteRow(2);
+        check(model.cellState(2, 0) == CulTableModel::CellOutOfRange, "states follow removed rows");
+        check(model.getViolations().size() == 1 && model.getViolations()[0].row == 2 &&
+              model.getViolations()[0].paramIdx == 0, "violation index follows removed rows");
+        model.addRow();
+        check(model.cellState(3, 0) == CulTableModel::CellEmpty, "added row gets its states");
+
+        const CulRow minRow = model.rows()[0], wideMax = makeCulRow("999992", {6.0, 20.0}, "DFAULT", true);
+        model.setMinMaxRows(&minRow, &wideMax);
+        check(model.cellState(2, 0) == CulTableModel::CellInRange && model.violationCount() == 0 &&
+              lastCount == 0, "new MAXIMA recomputes the states and the index");
+    }
+
+    // ── 23. Table models: reference access, snapshots ───────────────────────
+    fprintf(stdout, "\n[ Table model row access ]\n");
+    {
+        CulTableModel model;
+        model.setParamNames({"P1"});
+        model.setRows({makeCulRow("IB0001", {1.0}), makeCulRow("IB0002", {2.0})});
+
+        check(&model.rows() == &model.rows() && &model.rowAt(1) == &model.rows()[1],
+              "rows() and rowAt() return references into the model");
+        QStringList seen;
+        for (const CulRow &r : model)
+            seen << r.varNum;
+        check(seen == QStringList({"IB0001", "IB0002"}), "range-for walks the rows in order");
+
+        const quint64 before = model.generation();
+        const CulTableModel::Snapshot snap = model.snapshot();
+        check(snap.rows().constData() == model.rows().constData(), "taking a snapshot copies nothing");
+        model.setData(model.index(0, CulTableModel::COL_PARAM0), "7");
+        check(model.generation() > before && snap.generation() == before, "edits bump the generation");
+        check(snap.at(0).params[0].value() == 1.0 && model.rowAt(0).params[0].value() == 7.0,
+              "snapshot keeps its rows while the model is edited");
+        check(snap.paramNames() == QStringList({"P1"}), "snapshot carries the parameter names");
+
+        int total = 0;
+        QThread *reader = QThread::create([&] { for (const CulRow &r : snap) total += r.varNum.size(); });
+        reader->start();
+        model.deleteRow(1);
+        reader->wait();
+        delete reader;
+        check(total == 12 && snap.size() == 2 && model.rowCount() == 1,
+              "snapshot read on another thread during an edit");
+
+        EcoTableModel eco;
+        EcoRow e;
+        e.ecoNum = "IB0001";
+        eco.setRows({e});
+        const EcoTableModel::Snapshot ecoSnap = eco.snapshot();
+        eco.addRow();
+        check(ecoSnap.size() == 1 && eco.rowCount() == 2 && ecoSnap.generation() < eco.generation(),
+              "ECO snapshot unaffected by added rows");
+    }
+
+    // ── 24. Table models: batched edits, column formulas ────────────────────
+    fprintf(stdout, "\n[ Table model batches ]\n");
+    {
+        CulTableModel model;
+        model.setParamNames({"P1", "P2"});
+        model.setRows({makeCulRow("999991", {0.0, 0.0}, "DFAULT", true),
+                       makeCulRow("999992", {10.0, 10.0}, "DFAULT", true),
+                       makeCulRow("IB0001", {1.0, 2.0}), makeCulRow("IB0002", {3.0, std::nullopt}),
+                       makeCulRow("IB0003", {5.0, 6.0})});
+        int modified = 0, changes = 0, violationSignals = 0;
+        QModelIndex first, last;
+        connect(&model, &CulTableModel::dataModified, &model, [&] { ++modified; });
+        connect(&model, &CulTableModel::violationsChanged, &model, [&] { ++violationSignals; });
+        connect(&model, &QAbstractItemModel::dataChanged, &model,
+                [&](const QModelIndex &tl, const QModelIndex &br) { ++changes; first = tl; last = br; });
+
+        {
+            CulTableModel::EditBatch batch(&model);
+            model.setData(model.index(2, CulTableModel::COL_VRNAME), "ONE");
+            model.setData(model.index(4, CulTableModel::COL_PARAM0 + 1), "60");
+            model.setData(model.index(3, CulTableModel::COL_PARAM0), "4");
+            check(modified == 0 && changes == 0 && violationSignals == 0, "batched edits hold back notifications");
+        }
+        check(modified == 1 && changes == 1 && violationSignals == 1, "commit emits each signal once");
+        check(first == model.index(2, CulTableModel::COL_VRNAME) &&
+              last == model.index(4, CulTableModel::COL_PARAM0 + 1), "commit covers the bounding range");
+
+        modified = changes = 0;
+        {
+            CulTableModel::EditBatch outer(&model);
+            CulTableModel::EditBatch inner(&model);
+            model.addRow();
+            inner.commit();
+            check(modified == 0, "nested batch commits with the outermost");
+        }
+        check(modified == 1 && model.rowCount() == 6, "rows added inside a batch");
+
+        CulTableModel::Formula f;
+        QString err;
+        check(CulTableModel::Formula::parse("*1.5", &f, &err) && f.scale == 1.5 && f.offset == 0.0, "formula: scale");
+        check(CulTableModel::Formula::parse("- 2", &f) && f.scale == 1.0 && f.offset == -2.0, "formula: shift");
+        check(CulTableModel::Formula::parse("7", &f) && f.scale == 0.0 && f.offset == 7.0, "formula: bare number sets");
+        check(!CulTableModel::Formula::parse("/0", &f, &err) && err.contains("zero") &&
+              !CulTableModel::Formula::parse("*abc", &f), "formula: bad input rejected");
+
+        modified = changes = 0;
+        CulTableModel::Formula::parse("*2", &f);
+        const int changed = model.applyFormula(0, {0, 2, 3, 4, 5}, f);
+        check(changed == 3 && model.rowAt(2).params[0].value() == 2.0 && model.rowAt(3).params[0].value() == 8.0 &&
+              model.rowAt(4).params[0].value() == 10.0, "formula scales the selected cells");
+        check(model.rowAt(0).params[0].value() == 0.0 && !model.rowAt(5).params[0].has_value(),
+              "formula skips MINIMA and empty cells");
+        check(modified == 1 && changes == 1, "formula is one change and one save");
+        check(model.applyFormula(0, {2}, f) == 1 && model.applyFormula(5, {2}, f) == 0, "formula checks the column");
+    }
+
+    // ── 25. Search index and indexed filter proxy ───────────────────────────
+    fprintf(stdout, "\n[ Search index ]\n");
+    {
+        TextSearchIndex index;
+        index.reset({"IB0001\nMaize Hybrid\nIB0101", "IB0002\nSweet Corn\nIB0102", "KY0001\nHybrid X\nDFAULT"});
+        check(index.find("hybrid") == QVector<int>({0, 2}), "trigram lookup, case-insensitive");
+        check(index.find("ib") == QVector<int>({0, 1}) && index.find("").size() == 3, "short queries scan the keys");
+        check(index.find("rid m").isEmpty() && index.find("ib00001").isEmpty(),
+              "shared trigrams still need the whole substring");
+        index.setKey(1, "IB0002\nHybrid Corn\nIB0102");
+        check(index.find("hybrid") == QVector<int>({0, 1, 2}) && index.find("sweet").isEmpty(), "edited key reindexed");
+        index.removeRows(0, 1);
+        check(index.find("hybrid") == QVector<int>({0, 1}) && index.find("ky00") == QVector<int>({1}),
+              "removed row shifts the postings");
+        index.insertRows(0, {"AB1234\nHybrid Y\nAB0001"});
+        check(index.find("hybrid") == QVector<int>({0, 1, 2}) && index.find("ky00") == QVector<int>({2}),
+              "inserted row shifts the postings");
+
+        CulTableModel model;
+        model.setParamNames({"P1"});
+        model.setRows({makeCulRow("IB0001", {1.0}, "IB0101", false, "MAIZE ONE"),
+                       makeCulRow("IB0002", {1.0}, "IB0102", false, "CORN TWO"),
+                       makeCulRow("IB0003", {1.0}, "IB0101", false, "MAIZE THREE")});
+        IndexedFilterProxy proxy;
+        proxy.setSearchColumns({CulTableModel::COL_VARNUM, CulTableModel::COL_VRNAME, CulTableModel::COL_ECONUM});
+        proxy.setSourceModel(&model);
+        proxy.setSearchText("maize");
+        check(proxy.rowCount() == 3, "search waits for the debounce");
+        proxy.flushSearch();
+        check(proxy.rowCount() == 2, "debounced search filters rows");
+        model.setData(model.index(1, CulTableModel::COL_VRNAME), "MAIZE TWO");
+        check(proxy.rowCount() == 3, "edited row enters the filter");
+        model.deleteRow(0);
+        model.addRowWithData("SWEET MAIZE", "", "IB0101");
+        check(proxy.rowCount() == 3 && proxy.searchIndex().rowCount() == 3, "index follows removed and added rows");
+        proxy.setSearchText("ib0102");
+        proxy.flushSearch();
+        check(proxy.rowCount() == 1, "ECO# is searched");
+        proxy.setSearchText("");
+        check(proxy.rowCount() == 3, "clearing the search applies at once");
+    }
+
+    // ── 26. Structured table queries ────────────────────────────────────────
+    fprintf(stdout, "\n[ Table queries ]\n");
+    {
+        CulTableModel model;
+        model.setParamNames({"P1", "PPSEN"});
+        model.setRows({makeCulRow("IB0001", {200, 0.5}, "IB0001", false, "MAIZE ONE"),
+                       makeCulRow("IB0002", {300, 0.2}, "IB0001", false, "CORN TWO"),
+                       makeCulRow("IB0003", {250, std::nullopt}, "IB0002", false, "MAIZE THREE"),
+                       makeCulRow("IB0004", {150, 0.35}, "IB0001", false, "SWEET CORN")});
+
+        // Reads straight from the model's columns; "used" = IB0001 and IB0004
+        struct ModelReader : TableQuery::Reader {
+            const CulTableModel *m;
+            explicit ModelReader(const CulTableModel *model) : m(model) {}
+            void readText(int col, int first, int count, QVector<QString> *out) const override {
+                m->textColumn(col, first, count, out);
+            }
+            void readNumbers(int col, int first, int count, QVector<double> *v, QBitArray *present) const override {
+                m->numberColumn(col, first, count, v, present);
+            }
+            QBitArray readFlag(const QString &, int first, int count) const override {
+                QBitArray rows(count);
+                for (int i = 0; i < count; ++i)
+                    rows.setBit(i, first + i == 0 || first + i == 3);
+                return rows;
+            }
+            QBitArray readSearch(const QString &text, int first, int count) const override {
+                QVector<QString> names;
+                m->textColumn(CulTableModel::COL_VRNAME, first, count, &names);
+                QBitArray rows(count);
+                for (int i = 0; i < count; ++i)
+                    rows.setBit(i, names[i].contains(text, Qt::CaseInsensitive));
+                return rows;
+            }
+        } reader(&model);
+
+        TableQuery::Schema schema;
+        for (int c = 0; c < model.columnCount(); ++c)
+            schema.columns << model.columnName(c);
+        schema.firstNumeric = CulTableModel::COL_PARAM0;
+        schema.flags << "used";
+        auto run = [&](const QString &text) {
+            TableQuery q;
+            QString err;
+            if (!q.compile(text, schema, &err)) return QString("error: " + err);
+            const QBitArray bits = q.evaluate(reader, 0, model.rowCount());
+            QString out;
+            for (int i = 0; i < bits.size(); ++i)
+                out += bits.testBit(i) ? '1' : '0';
+            return out;
+        };
+        check(run("ECO#=IB0001 AND PPSEN>0.3 AND used") == "1001", "AND of text, number and flag terms");
+        check(run("ppsen<0.4") == "0101", "empty cells never match a comparison");
+        check(run("VRNAME~maize OR P1>=300") == "1110", "OR and contains");
+        check(run("NOT (ECO#=IB0001 AND used)") == "0110", "NOT and parentheses");
+        check(run("corn used") == "0001", "bare words search and AND by default");
+        check(run("VRNAME=\"sweet corn\"") == "0001", "quoted values");
+        check(run("XYZ=1").contains("unknown column") && run("P1>abc").contains("not one") &&
+              run("P1~2").contains("text column") && run("(P1>1").contains("missing ')'") &&
+              run("P1>").contains("needs a value"), "errors name the problem");
+        check(TableQuery::isStructured("P1>2", schema) && TableQuery::isStructured("used", schema) &&
+              !TableQuery::isStructured("maize one", schema), "plain text stays a substring search");
+        TableQuery q;
+        q.compile("P1>100", schema);
+        check(q.evaluate(reader, 2, 2).size() == 2 && q.evaluate(reader, 2, 2).count(true) == 2,
+              "evaluation over a row range");
+
+        IndexedFilterProxy proxy;
+        proxy.setSearchColumns({CulTableModel::COL_VARNUM, CulTableModel::COL_VRNAME});
+        proxy.setSourceModel(&model);
+        int applied = -1;
+        QString applyError;
+        connect(&proxy, &IndexedFilterProxy::searchApplied, &proxy,
+                [&](int matches, const QString &error) { applied = matches; applyError = error; });
+        proxy.setSearchText("VRNAME~maize AND NOT VAR#=IB0003");
+        proxy.flushSearch();
+        check(proxy.rowCount() == 1 && applied == 1 && applyError.isEmpty(), "query drives the selection bitmap");
+        model.setData(model.index(1, CulTableModel::COL_VRNAME), "MAIZE TWO");
+        check(proxy.rowCount() == 2 && proxy.selection().testBit(1), "edited row re-evaluated");
+        proxy.setSearchText("VRNAME~");
+        proxy.flushSearch();
+        check(!applyError.isEmpty() && proxy.rowCount() == 4, "bad query reports and shows all rows");
+    }
+
+    // ── 27. Precomputed sort ranks ──────────────────────────────────────────
+    fprintf(stdout, "\n[ Sort ranks ]\n");
+    {
+        CulTableModel model;
+        model.setParamNames({"P1"});
+        model.setRows({makeCulRow("IB0002", {300}, "IB0001"), makeCulRow("999991", {10}, "IB0001"),
+                       makeCulRow("ib0001", {50}, "IB0001"), makeCulRow("999992", {999}, "IB0001"),
+                       makeCulRow("IB0003", {std::nullopt}, "IB0001")});
+
+        // Parameter columns hold numbers, as in the CUL table
+        struct RankProxy : IndexedFilterProxy {
+            TableQuery::Schema querySchema() const override {
+                TableQuery::Schema schema = IndexedFilterProxy::querySchema();
+                schema.firstNumeric = CulTableModel::COL_PARAM0;
+                return schema;
+            }
+        } proxy;
+        proxy.setPinnedRows(CulTableModel::COL_VARNUM, {"999991", "999992"});
+        proxy.setSourceModel(&model);
+        auto order = [&]() {
+            QStringList vars;
+            for (int r = 0; r < proxy.rowCount(); ++r)
+                vars << proxy.data(proxy.index(r, CulTableModel::COL_VARNUM)).toString();
+            return vars.join(',');
+        };
+
+        proxy.sort(CulTableModel::COL_PARAM0, Qt::AscendingOrder);
+        check(order() == "999991,999992,IB0003,ib0001,IB0002", "numeric ranks, empty cells first, pins on top");
+        proxy.sort(CulTableModel::COL_PARAM0, Qt::DescendingOrder);
+        check(order() == "999992,999991,IB0002,ib0001,IB0003", "pins stay on top when descending");
+        proxy.setSortCaseSensitivity(Qt::CaseInsensitive);
+        proxy.sort(CulTableModel::COL_VARNUM, Qt::AscendingOrder);
+        check(order().endsWith("ib0001,IB0002,IB0003"), "case-folded text ranks");
+        proxy.sort(CulTableModel::COL_PARAM0, Qt::AscendingOrder);
+        model.setData(model.index(2, CulTableModel::COL_PARAM0), "400");
+        check(order() == "999991,999992,IB0003,IB0002,ib0001", "edit in the sort column re-ranks");
+        model.deleteRow(0);
+        check(order() == "999991,999992,IB0003,ib0001", "ranks follow removed rows");
+        // 9 sorts before 400 as a number, after it as text
+        model.addRowWithFullData("ADDED", ".", "IB0001", {9.0});
+        const QString added = model.data(model.index(model.rowCount() - 1, CulTableModel::COL_VARNUM)).toString();
+        check(order() == "999991,999992,IB0003," + added + ",ib0001", "inserted row placed before its rank is built");
+        QCoreApplication::processEvents();
+        proxy.sort(CulTableModel::COL_PARAM0, Qt::DescendingOrder);
+        check(order() == "999992,999991,ib0001," + added + ",IB0003", "queued rebuild ranks the inserted row");
+    }
+
+    // ── 28. Identifier index ────────────────────────────────────────────────
+    fprintf(stdout, "\n[ Identifier index ]\n");
+    {
+        IdentifierIndex ids(1);
+        ids.reset({"G0001", "G0002", "D0009"}, {true, false, true});
+        check(ids.maxSuffix("G") == 1 && ids.maxSuffix("D") == 9 && ids.maxSuffix("X") == 0,
+              "max suffix per prefix, unnumbered rows left out");
+        check(ids.nextId("ECO") == "D0010", "prefix of the last numbered row");
+        ids.rename(2, "G0005");
+        check(ids.nextId("ECO") == "G0006" && ids.rowOf("d0009") == -1, "rename moves the suffix");
+        ids.rename(2, "G0001");
+        check(ids.nextId("ECO") == "G0003", "numbers in use are skipped");
+        ids.insert(0, " g0042 ");
+        check(ids.rowOf("G0042") == 0 && ids.rowOf("G0002") == 2 && ids.maxSuffix("G") == 42,
+              "insert shifts rows, keys trimmed and upper-cased");
+        ids.remove(0);
+        check(ids.rowOf("G0042") == -1 && ids.rowOf("G0002") == 1 && ids.maxSuffix("G") == 1,
+              "remove drops the key and shifts rows back");
+        check(IdentifierIndex().nextId("NEW") == "NEW0001", "fallback prefix when empty");
+
+        CulTableModel model;
+        model.setParamNames({"P1", "P2", "P3"});
+        const QVector<std::optional<double>> empty(3);
+        model.setRows({makeCulRow("999991", empty, "DFAULT", true), makeCulRow("IB0003", empty),
+                       makeCulRow("UF0007", empty), makeCulRow("IB0001", empty)});
+        model.addRow();
+        check(model.rowAt(4).varNum == "IB0004", "new VAR# from the last cultivar's code");
+        check(model.rowOfVarNum(" ib0003 ") == 1 && model.rowOfVarNum("IB0009") == -1, "VAR# lookup");
+        model.setData(model.index(1, CulTableModel::COL_VARNUM), "IB0010");
+        model.addRow();
+        check(model.rowOfVarNum("IB0003") == -1 && model.rowAt(5).varNum == "IB0011",
+              "renamed VAR# followed");
+        model.deleteRow(1);
+        check(model.rowOfVarNum("IB0010") == -1 && model.rowOfVarNum("IB0011") == 4,
+              "deleted row dropped, later rows shifted");
+
+        QVector<CulRow> rows = model.rows();
+        GlueMergeResult merged = GlueResultMerger::mergeRows(
+            rows, 3, {"IB0001 FIRST                . DFAULT 2.213 16.40 0.512",
+                      "IB0020 NEW                  . DFAULT  1.00  2.00  0.30"},
+            true, &model.varNumIndex());
+        check(merged.updated == 1 && merged.added == 1 && merged.changedRows == QVector<int>({2, 5}),
+              "merge looks rows up through the model's index");
+        model.applyMerged(rows, merged.changedRows);
+        check(model.rowOfVarNum("IB0020") == 5 && model.varNumIndex().rowCount() == 6 &&
+              model.varNumIndex().maxSuffix("IB") == 20, "merged rows indexed");
+
+        EcoTableModel eco;
+        EcoRow minRow;
+        minRow.ecoNum = "999991"; minRow.isMinMax = true;
+        EcoRow g;
+        g.ecoNum = "G0005"; g.params = QVector<std::optional<double>>(16);
+        eco.setRows({minRow, g});
+        eco.addRow();
+        check(eco.rowAt(2).ecoNum == "G0006" && eco.rowOfEcoNum("g0006") == 2, "new ECO# and lookup");
+    }
+
+    // ── 29. ECO# reference counts ───────────────────────────────────────────
+    fprintf(stdout, "\n[ ECO references ]\n");
+    {
+        CulTableModel cul;
+        cul.setParamNames({"P1"});
+        const QVector<std::optional<double>> empty(1);
+        cul.setRows({makeCulRow("999991", empty, "DFAULT", true), makeCulRow("IB0001", empty, "G00001"),
+                     makeCulRow("IB0002", empty, "G00001"), makeCulRow("IB0003", empty, "G00002")});
+        check(cul.ecoRefCount("g00001") == 2 && cul.ecoRefCount("DFAULT") == 0 &&
+              cul.rowsUsingEco("G00001") == QVector<int>({1, 2}), "reverse index, MINIMA/MAXIMA left out");
+        check(cul.ecoRefCounts().size() == 2 && cul.ecoRefCounts().value("G00002") == 1, "counts per ECO#");
+
+        EcoTableModel eco;
+        EcoRow e1, e2, e3;
+        e1.ecoNum = "G00001"; e2.ecoNum = "G00002"; e3.ecoNum = "G00003";
+        for (EcoRow *e : {&e1, &e2, &e3}) e->params = QVector<std::optional<double>>(16);
+        eco.setRows({e1, e2, e3});
+        eco.setCulCrossRef(cul.ecoRefCounts());
+        auto refsCell = [&](int row) { return eco.data(eco.index(row, EcoTableModel::COL_REFS)).toInt(); };
+        check(refsCell(0) == 2 && refsCell(1) == 1 && refsCell(2) == 0, "REFS column from the counts");
+
+        QStringList changed;
+        QVector<int> repainted;
+        connect(&cul, &CulTableModel::ecoRefsChanged, &cul, [&](const QStringList &ecoNums) {
+            changed << ecoNums;
+            for (const QString &e : ecoNums)
+                eco.setCulRefCount(e, cul.ecoRefCount(e));
+        });
+        connect(&eco, &QAbstractItemModel::dataChanged, &eco,
+                [&](const QModelIndex &tl, const QModelIndex &br) {
+                    if (tl.column() == EcoTableModel::COL_REFS && br.column() == EcoTableModel::COL_REFS)
+                        repainted << tl.row();
+                });
+        cul.setData(cul.index(2, CulTableModel::COL_ECONUM), "G00003");
+        changed.sort();
+        check(changed == QStringList({"G00001", "G00003"}) && refsCell(0) == 1 && refsCell(2) == 1,
+              "ECO# edit moves one reference");
+        std::sort(repainted.begin(), repainted.end());
+        check(repainted == QVector<int>({0, 2}), "only the affected REFS cells repainted");
+
+        changed.clear();
+        {
+            CulTableModel::EditBatch batch(&cul);
+            cul.deleteRow(3);
+            cul.addRowWithData("NEW", "       ", "G00002");
+            cul.duplicateRow(1);
+            check(changed.isEmpty(), "batched reference changes held back");
+        }
+        changed.sort();
+        check(changed == QStringList({"G00001", "G00002"}) && refsCell(0) == 2 && refsCell(1) == 1,
+              "one notification per batch");
+        check(cul.rowsUsingEco("G00001") == QVector<int>({1, 4}) && cul.rowsUsingEco("G00003") == QVector<int>({2}),
+              "rows shifted after a delete");
+    }
+
+    // ── 30. Undo history ────────────────────────────────────────────────────
+    fprintf(stdout, "\n[ Undo history ]\n");
+    {
+        CulTableModel model;
+        QUndoStack stack;
+        model.setUndoStack(&stack);
+        model.setParamNames({"P1", "P2"});
+        model.setRows({makeCulRow("999991", {0, 1.0}, "DFAULT", true),
+                       makeCulRow("999992", {10, 1.0}, "DFAULT", true),
+                       makeCulRow("IB0001", {5, 1.0}, "G00001"), makeCulRow("IB0002", {7, 1.0}, "G00002")});
+        auto p1 = [&](int row) { return model.rowAt(row).params[0].value_or(-1); };
+
+        model.setData(model.index(2, CulTableModel::COL_PARAM0), "20");
+        check(stack.count() == 1 && model.violationCount() == 1, "cell edit is one step");
+        stack.undo();
+        check(p1(2) == 5 && model.rowAt(2).paramStrs[0].isEmpty() && model.violationCount() == 0,
+              "undo restores the value, its text and the violation index");
+        stack.redo();
+        check(p1(2) == 20 && model.violationCount() == 1, "redo reapplies");
+
+        CulTableModel::Formula twice;
+        CulTableModel::Formula::parse("*2", &twice);
+        model.applyFormula(0, {2, 3}, twice);
+        check(stack.count() == 2 && p1(2) == 40 && p1(3) == 14, "formula over a batch is one step");
+        stack.undo();
+        check(p1(2) == 20 && p1(3) == 7, "batch undone at once");
+
+        model.deleteRow(2);
+        check(model.rowCount() == 3 && model.rowOfVarNum("IB0001") == -1, "row deleted");
+        stack.undo();
+        check(model.rowCount() == 4 && model.rowOfVarNum("IB0001") == 2 && p1(2) == 20 &&
+              model.ecoRefCount("G00001") == 1 && model.violationCount() == 1,
+              "undo puts the row back in place with its indexes");
+        model.addRow();
+        stack.undo();
+        check(model.rowCount() == 4 && stack.canRedo(), "added row undone");
+
+        // A step keeps the edited row, sharing the fields it did not change
+        model.setData(model.index(3, CulTableModel::COL_VRNAME), "RENAMED");
+        const QVector<std::optional<double>> params = model.rowAt(3).params;
+        stack.undo();
+        check(model.rowAt(3).vrName == "IB0002" && model.rowAt(3).params.constData() == params.constData(),
+              "untouched fields shared with the history");
+
+        model.setRows(model.rows());
+        check(stack.count() == 0, "loading rows clears the history");
+
+        EcoTableModel eco;
+        QUndoStack ecoStack;
+        eco.setUndoStack(&ecoStack);
+        EcoRow e;
+        e.ecoNum = "G00001"; e.ecoName = "FIRST"; e.params = QVector<std::optional<double>>(16);
+        eco.setRows({e});
+        {
+            EcoTableModel::EditBatch batch(&eco);
+            eco.setData(eco.index(0, EcoTableModel::COL_ECONAME), "CHANGED");
+            eco.duplicateRow(0);
+        }
+        check(ecoStack.count() == 1 && eco.rowCount() == 2, "ECO batch is one step");
+        ecoStack.undo();
+        check(eco.rowCount() == 1 && eco.rowAt(0).ecoName == "FIRST" && eco.rowOfEcoNum("G00001") == 0,
+              "ECO batch undone");
+    }
+
+    // ── 31. GlueScheduler: policies, durations, estimates ───────────────────
+    fprintf(stdout, "\n[ GlueScheduler ]\n");
+    {
+        auto makeEntry = [](int priority, double seconds, GlueQueueStatus status = GlueQueueStatus::Pending) {
+            GlueQueueEntry e;
+            e.priority = priority;
+            e.estimatedSeconds = seconds;
+            e.status = status;
+            return e;
+        };
+        QList<GlueQueueEntry> queue{makeEntry(5, 10, GlueQueueStatus::Running),
+                                    makeEntry(0, 30), makeEntry(1, 60), makeEntry(1, 20),
+                                    makeEntry(0, 20), makeEntry(1, 20)};
+        check(GlueScheduler::pickNext(queue, GlueSchedulePolicy::Fifo) == 1, "FIFO takes the first pending entry");
+        check(GlueScheduler::pickNext(queue, GlueSchedulePolicy::ShortestFirst) == 3,
+              "shortest first; equal estimates keep queue order");
+        check(GlueScheduler::pickNext(queue, GlueSchedulePolicy::Priority) == 3,
+              "highest priority, then shortest, then queue order");
+        const QList<GlueQueueEntry> equal{makeEntry(2, 40), makeEntry(2, 40)};
+        check(GlueScheduler::pickNext(equal, GlueSchedulePolicy::ShortestFirst) == 0 &&
+              GlueScheduler::pickNext(equal, GlueSchedulePolicy::Priority) == 0, "full ties stay FIFO");
+        check(GlueScheduler::pickNext({makeEntry(0, 1, GlueQueueStatus::Done)}, GlueSchedulePolicy::Fifo) == -1 &&
+              GlueScheduler::pickNext({}, GlueSchedulePolicy::Priority) == -1, "nothing pending gives -1");
+
+        check(GlueScheduler::formatDuration(45) == "45 s" && GlueScheduler::formatDuration(-3) == "0 s",
+              "seconds under a minute");
+        check(GlueScheduler::formatDuration(59.6) == "1 min" && GlueScheduler::formatDuration(720) == "12 min",
+              "minutes, rounded");
+        check(GlueScheduler::formatDuration(3900) == "1 h 05 min", "hours with padded minutes");
+        check(GlueScheduler::formatDuration(3570) == "1 h 00 min" &&
+              GlueScheduler::formatDuration(3599) == "1 h 00 min", "minutes that round up to an hour");
+
+        GlueQueueEntry job;
+        job.cropInfo.module = "ZZTEST01";
+        job.selectedTreatments["A.SNX"] = {TreatmentEntry{1, {}}, TreatmentEntry{2, {}}};
+        job.selectedTreatments["B.SNX"] = {TreatmentEntry{1, {}}};
+        job.runs = 100;
+        job.glueFlag = 1;
+        check(GlueScheduler::modelRunCount(job) == 600, "treatments x runs x two rounds");
+        job.glueFlag = 2;
+        check(GlueScheduler::modelRunCount(job) == 300, "single round for flag 2");
+
+        GlueScheduler::recordRun(job, 600);
+        check(qAbs(GlueScheduler::secondsPerModelRun(job.cropInfo, 2) - 2.0) < 1e-9 &&
+              qAbs(GlueScheduler::estimateSeconds(job) - 600) < 1e-6, "first run sets seconds per model run");
+        GlueScheduler::recordRun(job, 1500);
+        check(qAbs(GlueScheduler::secondsPerModelRun(job.cropInfo, 2) - 2.9) < 1e-9,
+              "later runs move the estimate by a moving average");
+    }
+
+    // ── 32. GlueRWorker: done marker, dying interpreter, retry ──────────────
+    fprintf(stdout, "\n[ GlueRWorker ]\n");
+    {
+        const QString savedDir = GlueRunner::GLUE_DIR;
+        GlueRunner::GLUE_DIR = tmp.filePath("rworker");
+        QDir().mkpath(GlueRunner::GLUE_DIR);
+        auto writeScript = [](const QString &name, const QByteArray &body) {
+            QFile f(GlueRunner::GLUE_DIR + "/" + name);
+            if (f.open(QIODevice::WriteOnly | QIODevice::Text)) f.write(body);
+            return f.fileName();
+        };
+        QByteArray out, err;
+        QString message;
+        auto run = [&](GlueRWorker &worker, const QString &script) {
+            out.clear(); err.clear(); message.clear();
+            int code = -99;
+            QEventLoop loop;
+            const QMetaObject::Connection c = connect(&worker, &GlueRWorker::jobFinished, &loop,
+                [&](int exitCode, const QString &m) { code = exitCode; message = m; loop.quit(); });
+            QTimer::singleShot(10000, &loop, &QEventLoop::quit);
+            worker.submit(script);
+            if (code == -99) loop.exec();
+            disconnect(c);
+            return code;
+        };
+        auto makeWorker = [&](GlueRWorker &worker) {
+            worker.setProgram(QCoreApplication::applicationFilePath(), {"--stand-in-rworker"});
+            connect(&worker, &GlueRWorker::outputReceived, &worker,
+                    [&](const QByteArray &data, bool isError) { (isError ? err : out) += data; });
+        };
+
+        GlueRWorker worker;
+        makeWorker(worker);
+        check(run(worker, writeScript("tail.R", "echo first\nwrite no newline\n")) == 0 &&
+              out == "first\nno newline\n", "output without a final newline still ends the job");
+        const qint64 pid = worker.processId();
+        check(run(worker, writeScript("full.R", "echo full\n")) == 0 && out == "full\n" &&
+              worker.jobsServed() == 2 && worker.processId() == pid,
+              "interpreter reused; the marker's own newline is not logged");
+        check(run(worker, writeScript("flaky.R", "echo try\nexit-once 3\n")) == 0 &&
+              err.contains("retrying") && worker.jobsServed() == 1 && worker.processId() != pid,
+              "job that kills a used interpreter is retried on a fresh one");
+
+        GlueRWorker fresh;
+        makeWorker(fresh);
+        check(run(fresh, writeScript("dies.R", "echo bye\nexit 3\n")) == 3 && out == "bye\n",
+              "exit of a fresh interpreter ends the job with its code");
+#ifndef Q_OS_WIN
+        GlueRWorker killed;
+        makeWorker(killed);
+        connect(&killed, &GlueRWorker::outputReceived, &killed, [&killed](const QByteArray &data) {
+            if (data.contains("started")) ::kill(pid_t(killed.processId()), SIGKILL);
+        });
+        run(killed, writeScript("slow.R", "echo started\nsleep 20000\n"));
+        check(message == "R worker crashed", "killed interpreter fails the job");
+        check(run(killed, writeScript("after.R", "echo again\n")) == 0 && out == "again\n",
+              "next job starts a new interpreter");
+#endif
+        GlueRunner::GLUE_DIR = savedDir;
+    }
+
     // ── Summary ───────────────────────────────────────────────────────────────
+    QSettings(Config::ORG_NAME, Config::SETTINGS_APP).clear();
     fprintf(stdout, "\n================================\n");
     fprintf(stdout, "Results: %d passed, %d failed\n", s_pass, s_fail);
     fprintf(stdout, "================================\n\n");
@@ -307,131 +1907,553 @@ int CommandLineHandler::runTests()
 int CommandLineHandler::runGlue(const CommandLineArgs &a)
 {
     if (a.cropCode.isEmpty() || a.cultivarId.isEmpty()) {
-        fprintf(stderr, "Usage: GeneticsEditor.exe --glue --crop WH --cultivar IB0488 "
-                        "--name NEWTON [--runs 100] [--mode phenology|growth|both]\n");
+        fprintf(stderr, "Usage: GeneticsEditor.exe --glue --crop WH --cultivar IB0488[,IB0171…] "
+                        "--name NEWTON[,…] [--runs 100] [--mode phenology|growth|both] "
+                        "[--jobs N] [--json]\n");
         return 1;
     }
+    // With --json stdout carries only the event stream; human messages go to stderr
+    FILE *info = a.json ? stderr : stdout;
+    auto emitJson = [](const QJsonObject &event) {
+        QByteArray line = QJsonDocument(event).toJson(QJsonDocument::Compact);
+        line += '\n';
+        fwrite(line.constData(), 1, size_t(line.size()), stdout);
+        fflush(stdout);
+    };
 
-    fprintf(stdout, "GLUE: crop=%s  cultivar=%s  name=%s  runs=%d  mode=%s\n",
+    const QStringList ids   = a.cultivarId.split(',', Qt::SkipEmptyParts);
+    const QStringList names = a.cultivarName.split(',');
+    fprintf(info, "GLUE: crop=%s  cultivar=%s  name=%s  runs=%d  mode=%s  jobs=%d\n",
             qPrintable(a.cropCode), qPrintable(a.cultivarId),
-            qPrintable(a.cultivarName), a.runs, qPrintable(a.mode));
-    fflush(stdout);
+            qPrintable(a.cultivarName), a.runs, qPrintable(a.mode), qMax(1, a.jobs));
+    fflush(info);
 
     // ── 1. Resolve CropInfo ───────────────────────────────────────────────────
-    QMap<QString, CropInfo> crops = DssatProParser::discoverCrops(Config::DSSATPRO_FILE);
+    GlueRunner::resolvePaths(Config::DSSATPRO_FILE);
     CropInfo cropInfo;
-    for (const CropInfo &c : crops) {
-        if (c.cropCode.compare(a.cropCode, Qt::CaseInsensitive) != 0) continue;
-        // Prefer the DSSATPRO-designated primary model; fall back to any match
-        if (cropInfo.cropCode.isEmpty() || c.isPrimary)
-            cropInfo = c;
-    }
-    if (cropInfo.cropCode.isEmpty()) {
+    if (!findCrop(a.cropCode, cropInfo)) {
         fprintf(stderr, "ERROR: crop '%s' not found in DSSATPRO.v48\n",
                 qPrintable(a.cropCode));
         return 1;
     }
-    fprintf(stdout, "Crop: %s  Module: %s  ExpDir: %s\n",
+    fprintf(info, "Crop: %s  Module: %s  ExpDir: %s\n",
             qPrintable(cropInfo.cropCode), qPrintable(cropInfo.module),
             qPrintable(cropInfo.expDir));
-    fflush(stdout);
+    fflush(info);
 
-    // ── 2. Scan experiments ───────────────────────────────────────────────────
-    fprintf(stdout, "Scanning experiments in: %s\n", qPrintable(cropInfo.expDir));
-    fflush(stdout);
+    const int glueFlag = glueFlagForMode(a.mode);
+    GlueJobPipeline runner;
+    QMap<int, GlueQueueEntry> cacheEntries;   // job id -> what to record once snapshotted
+    int rejected = 0;
 
-    ScanResult scan = GlueRunner::scanExperiments(cropInfo, a.cultivarId, false);
-    if (!scan.errorMsg.isEmpty()) {
-        fprintf(stderr, "ERROR: %s\n", qPrintable(scan.errorMsg));
+    for (int c = 0; c < ids.size(); ++c) {
+        const QString cultivarId   = ids[c].trimmed();
+        const QString cultivarName = c < names.size() ? names[c].trimmed() : QString();
+        auto reject = [&](const QString &msg) {
+            fprintf(stderr, "ERROR: %s\n", qPrintable(msg));
+            if (a.json) emitJson({{"event", "finished"}, {"job", cultivarId}, {"crop", a.cropCode},
+                                  {"status", "failed"}, {"error", msg}});
+            ++rejected;
+        };
+
+        // ── 2. Scan experiments ───────────────────────────────────────────────
+        fprintf(info, "Scanning experiments for %s in: %s\n",
+                qPrintable(cultivarId), qPrintable(cropInfo.expDir));
+        fflush(info);
+
+        ScanResult scan = GlueRunner::scanExperiments(cropInfo, cultivarId, false);
+        if (!scan.errorMsg.isEmpty()) { reject(scan.errorMsg); continue; }
+        if (scan.filesScanned == 0) {
+            reject(QString("No .%1X experiment files found in: %2").arg(a.cropCode, cropInfo.expDir));
+            continue;
+        }
+        if (scan.treatments.isEmpty()) {
+            reject(QString("Cultivar %1 not found in any of %2 experiment file(s)")
+                       .arg(cultivarId).arg(scan.filesScanned));
+            continue;
+        }
+
+        int totalTreatments = 0;
+        for (const auto &list : scan.treatments) totalTreatments += list.size();
+        fprintf(info, "Found %d treatment(s) across %d file(s)\n",
+                totalTreatments, int(scan.treatments.size()));
+        for (auto it = scan.treatments.begin(); it != scan.treatments.end(); ++it) {
+            for (const TreatmentEntry &e : it.value())
+                fprintf(info, "  %s  trt %d\n",
+                        qPrintable(QDir::toNativeSeparators(it.key())), e.number);
+        }
+        fflush(info);
+
+        // ── 3. An identical earlier calibration makes the run unnecessary ─────
+        GlueQueueEntry probe;
+        probe.cultivarId         = cultivarId;
+        probe.cultivarName       = cultivarName;
+        probe.cropInfo           = cropInfo;
+        probe.selectedTreatments = scan.treatments;
+        probe.runs               = a.runs;
+        probe.glueFlag           = glueFlag;
+        if (!a.force) {
+            GlueCacheHit hit;
+            if (GlueResultCache::lookup(probe, hit)) {
+                fprintf(info, "Cached result (inputs unchanged since %s; use --force to rerun):\n%s\n",
+                        qPrintable(hit.finishedAt.toString(Qt::ISODate)), qPrintable(hit.resultCulLine));
+                fflush(info);
+                if (a.json) emitJson({{"event", "cached"}, {"job", cultivarId}, {"crop", a.cropCode},
+                                      {"finishedAt", hit.finishedAt.toString(Qt::ISODate)},
+                                      {"cul", hit.resultCulLine}});
+                continue;
+            }
+        }
+
+        GlueJobSpec job;
+        job.cropInfo     = cropInfo;
+        job.cultivarId   = cultivarId;
+        job.cultivarName = cultivarName;
+        job.treatments   = scan.treatments;
+        job.runs         = a.runs;
+        job.glueFlag     = glueFlag;
+        job.snapshotDir  = GlueResultCache::snapshotDirFor(probe);
+        probe.fingerprint = GlueResultCache::fingerprint(probe);
+        probe.snapshotDir = job.snapshotDir;
+        cacheEntries.insert(runner.addJob(job), probe);
+    }
+    if (runner.jobCount() == 0) return rejected > 0 ? 1 : 0;
+
+    // ── 4. Run GLUE.r; batch files and SimulationControl.csv are written per job ──
+    // One job keeps the layout the GUI uses (shared SimulationControl.csv and
+    // GLWork); several get a sandbox each. A single job in text mode hands R
+    // the console directly instead of relaying it
+    const bool forward = !a.json && runner.jobCount() == 1;
+    runner.setLayout(runner.jobCount() == 1 ? GlueJobPipeline::SharedLayout
+                                            : GlueJobPipeline::SandboxLayout);
+    runner.setConcurrency(a.jobs);
+    runner.setForwardOutput(forward);
+    runner.catchTerminationSignals();
+    fprintf(info, "RTerm: %s\n", qPrintable(GlueRunner::findRTerm()));
+    if (forward) fprintf(info, "--- GLUE output ---\n");
+    fflush(info);
+
+    QEventLoop loop;
+    int code = 0;
+    // Finished results become cache hits for the GUI queue and later runs
+    connect(&runner, &GlueJobPipeline::jobSnapshotted, [&](int id, bool ok) {
+        const GlueJobResult &r = runner.result(id);
+        if (!ok || !r.ok || r.culLine.isEmpty()) return;
+        GlueQueueEntry &entry = cacheEntries[id];
+        entry.resultCulLine = r.culLine;
+        entry.finishedAt    = QDateTime::currentDateTime();
+        GlueResultCache::store(entry);
+    });
+    connect(&runner, &GlueJobPipeline::event, [&](const QJsonObject &e) {
+        if (a.json) { emitJson(e); return; }
+        const QString type = e["event"].toString();
+        const QByteArray job = e["job"].toString().toLocal8Bit();
+        if (type == "start" && !forward) {
+            fprintf(stdout, "[%s] started in %s (log: %s)\n", job.constData(),
+                    qPrintable(e["dir"].toString()), qPrintable(e["log"].toString()));
+        } else if (type == "progress" && !forward) {
+            fprintf(stdout, "[%s] Round %d/2 — %s (%d%%)\n", job.constData(), e["round"].toInt(),
+                    qPrintable(e["phase"].toString()), e["percent"].toInt());
+        } else if (type == "finished") {
+            if (forward)
+                fprintf(stdout, "\n--- GLUE finished (exit code %d) ---\n", e["exitCode"].toInt());
+            else
+                fprintf(stdout, "[%s] %s (exit code %d)\n", job.constData(),
+                        qPrintable(e["status"].toString()), e["exitCode"].toInt());
+            if (e.contains("error"))
+                fprintf(stderr, "ERROR: %s\n", qPrintable(e["error"].toString()));
+            for (const QJsonValue &line : e["errors"].toArray())
+                fprintf(stderr, "  %s\n", qPrintable(line.toString()));
+            if (e.contains("resources"))
+                fprintf(stdout, "Resources: %s\n", qPrintable(e["resources"].toString()));
+        } else if (type == "convergence") {
+            if (!forward) fprintf(stdout, "[%s] ", job.constData());
+            fprintf(stdout, "Posterior: %s%s\n", qPrintable(e["convergence"].toString()),
+                    e["needsMoreRuns"].toBool() ? " — rerun with a larger --runs" : "");
+        } else if (type == "cancel") {
+            fprintf(stderr, "\nCancelled (%s): stopping R and its model runs\n",
+                    qPrintable(e["reason"].toString()));
+        }
+        fflush(stdout);
+    });
+    connect(&runner, &GlueJobPipeline::finished, &loop, [&](int exitCode) {
+        code = exitCode;
+        loop.quit();
+    });
+
+    QString err;
+    if (!runner.start(&err)) {
+        fprintf(stderr, "ERROR: %s\n", qPrintable(err));
         return 1;
     }
-    if (scan.filesScanned == 0) {
-        fprintf(stderr, "ERROR: No .%sX experiment files found in: %s\n",
-                qPrintable(a.cropCode), qPrintable(cropInfo.expDir));
+    loop.exec();
+    return code == 0 && rejected > 0 ? 1 : code;
+}
+
+// ── Headless parameter-set generation ─────────────────────────────────────────
+
+int CommandLineHandler::runSample(const CommandLineArgs &a)
+{
+    GlueSamplingMethod method;
+    if (a.cropCode.isEmpty() || a.cultivarId.isEmpty() || a.sets <= 0
+        || !GlueParamSampler::parseMethod(a.method, method)) {
+        printUsage();
         return 1;
     }
-    if (scan.treatments.isEmpty()) {
-        fprintf(stderr, "ERROR: Cultivar %s not found in any of %d experiment file(s)\n",
-                qPrintable(a.cultivarId), scan.filesScanned);
+
+    CropInfo cropInfo;
+    if (!findCrop(a.cropCode, cropInfo)) {
+        fprintf(stderr, "ERROR: crop '%s' not found in DSSATPRO.v48\n", qPrintable(a.cropCode));
         return 1;
     }
 
-    // Count total treatments
-    int totalTreatments = 0;
-    for (const auto &list : scan.treatments) totalTreatments += list.size();
-    fprintf(stdout, "Found %d treatment(s) across %d file(s)\n",
-            totalTreatments, scan.treatments.size());
-    for (auto it = scan.treatments.begin(); it != scan.treatments.end(); ++it) {
-        for (const TreatmentEntry &e : it.value())
-            fprintf(stdout, "  %s  trt %d\n",
-                    qPrintable(QDir::toNativeSeparators(it.key())), e.number);
+    QStringList headers;
+    QVector<CulRow> rows = CulParser::parse(cropInfo.culFile, headers);
+    QString err;
+    GlueParamSpace space = GlueParamSampler::buildSpace(
+        rows, headers, a.cultivarId, glueFlagForMode(a.mode), a.round, &err);
+    if (space.names.isEmpty()) {
+        fprintf(stderr, "ERROR: %s (%s)\n", qPrintable(err), qPrintable(cropInfo.culFile));
+        return 1;
     }
-    fflush(stdout);
 
-    // ── 3. Write DSSBatch file ────────────────────────────────────────────────
-    QString batchPath = GlueRunner::writeBatchFile(
-        cropInfo, a.cultivarId, a.cultivarName, scan.treatments);
-    if (batchPath.isEmpty()) {
-        fprintf(stderr, "ERROR: Cannot write batch file to %s\n",
-                qPrintable(GlueRunner::GLUE_WORK));
+    QElapsedTimer timer;
+    timer.start();
+    GlueParamMatrix m = GlueParamSampler::generate(space, a.sets, method, a.seed);
+    qint64 genMs = timer.restart();
+
+    QString out = a.outPath;
+    if (out.isEmpty()) {
+        GlueRunner::resolvePaths(Config::DSSATPRO_FILE);
+        if (GlueRunner::GLUE_WORK.isEmpty()) {
+            fprintf(stderr, "ERROR: GLUE directory not found; pass --out\n");
+            return 1;
+        }
+        out = GlueRunner::GLUE_WORK + "/" + GlueParamSampler::randomSetsFileName(a.round);
+    }
+    if (!GlueParamSampler::writeRandomSets(out, m)) {
+        fprintf(stderr, "ERROR: Cannot write %s\n", qPrintable(out));
         return 1;
     }
-    fprintf(stdout, "Batch file: %s\n", qPrintable(QDir::toNativeSeparators(batchPath)));
+
+    QStringList sampled;
+    for (int i = 0; i < space.names.size(); ++i)
+        if (space.sampled[i]) sampled << space.names[i];
+    fprintf(stdout, "%d %s sets of %s (round %d): %s\n", m.sets,
+            qPrintable(GlueParamSampler::methodName(method)), qPrintable(a.cultivarId),
+            a.round, qPrintable(sampled.join(' ')));
+    fprintf(stdout, "Generated in %lld ms, written in %lld ms: %s\n",
+            genMs, timer.elapsed(), qPrintable(QDir::toNativeSeparators(out)));
     fflush(stdout);
+    return 0;
+}
+
+// ── Headless likelihood / posterior ───────────────────────────────────────────
+
+int CommandLineHandler::runLikelihood(const CommandLineArgs &a)
+{
+    if (a.setsFile.isEmpty() || a.evalFile.isEmpty()) {
+        printUsage();
+        return 1;
+    }
 
-    // ── 4. Update SimulationControl.csv ──────────────────────────────────────
-    // Map --mode string to GLUEFlag integer: 1=both, 2=phenology, 3=growth
-    int glueFlag = 1;
-    if (a.mode == "phenology") glueFlag = 2;
-    else if (a.mode == "growth") glueFlag = 3;
+    QElapsedTimer timer;
+    timer.start();
+
+    GlueParamMatrix sets;
+    if (!GlueParamSampler::readRandomSets(a.setsFile, sets)) {
+        fprintf(stderr, "ERROR: Cannot read parameter sets from %s\n", qPrintable(a.setsFile));
+        return 1;
+    }
+    GlueEvalTable table;
+    QString err;
+    if (!GlueLikelihood::readTable(a.evalFile, table, &err)) {
+        fprintf(stderr, "ERROR: %s\n", qPrintable(err));
+        return 1;
+    }
+    qint64 readMs = timer.restart();
+
+    GlueLikelihoodResult res = GlueLikelihood::evaluate(table, sets.sets);
+    if (!res.errorMsg.isEmpty()) {
+        fprintf(stderr, "ERROR: %s\n", qPrintable(res.errorMsg));
+        return 1;
+    }
+    QVector<GlueParamPosterior> post = GlueLikelihood::posterior(sets, res);
+    qint64 calcMs = timer.elapsed();
 
-    if (!GlueRunner::updateSimControl(cropInfo, a.cultivarId, a.runs, glueFlag, "N")) {
-        fprintf(stderr, "ERROR: Cannot update %s/SimulationControl.csv\n",
-                qPrintable(GlueRunner::GLUE_DIR));
+    QString out = a.outPath.isEmpty()
+        ? QFileInfo(a.evalFile).absolutePath() + "/GluePosterior.txt" : a.outPath;
+    if (!GlueLikelihood::writeReport(out, res, post)) {
+        fprintf(stderr, "ERROR: Cannot write %s\n", qPrintable(out));
         return 1;
     }
-    fprintf(stdout, "SimulationControl.csv updated (runs=%d, glueFlag=%d)\n",
-            a.runs, glueFlag);
+
+    fprintf(stdout, "%d sets, %d rows, variables %s\n", sets.sets, table.rows,
+            qPrintable(res.variables.join(' ')));
+    fprintf(stdout, "Max-probability set %d (effective sample size %.1f)\n",
+            res.bestSet + 1, res.effectiveSampleSize);
+    for (const GlueParamPosterior &p : post)
+        fprintf(stdout, "  %-8s best %-10.5g mean %-10.5g sd %.4g\n",
+                qPrintable(p.name), p.best, p.mean, p.sd);
+    fprintf(stdout, "Read in %lld ms, computed in %lld ms: %s\n",
+            readMs, calcMs, qPrintable(QDir::toNativeSeparators(out)));
     fflush(stdout);
+    return 0;
+}
+
+// ── Headless merge of GLUE results ────────────────────────────────────────────
+
+int CommandLineHandler::runMerge(const CommandLineArgs &a)
+{
+    if (a.cropCode.isEmpty() && (a.fromFile.isEmpty() || a.outPath.isEmpty())) {
+        printUsage();
+        return 1;
+    }
+
+    GlueRunner::resolvePaths(Config::DSSATPRO_FILE);
+    QString culPath = a.outPath;
+    if (culPath.isEmpty()) {
+        CropInfo cropInfo;
+        if (!findCrop(a.cropCode, cropInfo)) {
+            fprintf(stderr, "ERROR: crop '%s' not found in DSSATPRO.v48\n", qPrintable(a.cropCode));
+            return 1;
+        }
+        culPath = cropInfo.culFile;
+    }
+
+    QStringList lines;
+    if (!a.fromFile.isEmpty()) {
+        QFile f(a.fromFile);
+        if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            fprintf(stderr, "ERROR: Cannot read %s\n", qPrintable(a.fromFile));
+            return 1;
+        }
+        lines = QString::fromLocal8Bit(f.readAll()).split('\n', Qt::SkipEmptyParts);
+    } else {
+        QStringList ids = a.cultivarId.split(',', Qt::SkipEmptyParts);
+        for (QString &id : ids) id = id.trimmed();
+        lines = GlueResultMerger::storedResults(a.cropCode, ids);
+    }
+    if (lines.isEmpty()) {
+        fprintf(stderr, "ERROR: No GLUE results to merge\n");
+        return 1;
+    }
 
-    // ── 5. Launch RTerm ───────────────────────────────────────────────────────
-    QString rterm = GlueRunner::findRTerm();
-    fprintf(stdout, "RTerm: %s\n", qPrintable(rterm));
-    fprintf(stdout, "--- GLUE output ---\n");
+    GlueMergeResult res;
+    QString err;
+    if (!GlueResultMerger::mergeFile(culPath, lines, res, &err)) {
+        fprintf(stderr, "ERROR: %s\n", qPrintable(err));
+        return 1;
+    }
+    for (const QString &s : res.skipped)
+        fprintf(stderr, "Skipped: %s\n", qPrintable(s));
+    fprintf(stdout, "%s: %s\n", qPrintable(QDir::toNativeSeparators(culPath)), qPrintable(res.summary()));
+    if (!res.backupPath.isEmpty())
+        fprintf(stdout, "Backup: %s\n", qPrintable(QDir::toNativeSeparators(res.backupPath)));
     fflush(stdout);
+    return 0;
+}
 
-    QProcess proc;
-    proc.setWorkingDirectory(GlueRunner::GLUE_DIR);
-    proc.setProgram(rterm);
-    proc.setArguments({"--slave", "--file=" + GlueRunner::GLUE_DIR + "/GLUE.r"});
-    proc.setProcessChannelMode(QProcess::MergedChannels);
+// ── Headless parallel model runs ──────────────────────────────────────────────
 
-    proc.start();
-    if (!proc.waitForStarted(5000)) {
-        fprintf(stderr, "ERROR: Failed to start RTerm\n");
+int CommandLineHandler::runParallel(const CommandLineArgs &a)
+{
+    if (a.cropCode.isEmpty() || a.cultivarId.isEmpty() || a.setsFile.isEmpty()) {
+        printUsage();
         return 1;
     }
+    GlueRunner::resolvePaths(Config::DSSATPRO_FILE);
 
-    while (proc.state() != QProcess::NotRunning) {
-        proc.waitForReadyRead(500);
-        QByteArray out = proc.readAll();
-        if (!out.isEmpty()) {
-            fprintf(stdout, "%s", out.constData());
+    GlueDriverConfig cfg;
+    if (!findCrop(a.cropCode, cfg.cropInfo)) {
+        fprintf(stderr, "ERROR: crop '%s' not found in DSSATPRO.v48\n", qPrintable(a.cropCode));
+        return 1;
+    }
+    ScanResult scan = GlueRunner::scanExperiments(cfg.cropInfo, a.cultivarId, false);
+    if (scan.treatments.isEmpty()) {
+        fprintf(stderr, "ERROR: Cultivar %s not found in any experiment file\n", qPrintable(a.cultivarId));
+        return 1;
+    }
+    cfg.cultivarId   = a.cultivarId;
+    cfg.cultivarName = a.cultivarName;
+    cfg.treatments   = scan.treatments;
+    cfg.workers      = a.workers;
+
+    GlueParamMatrix sets;
+    if (!GlueParamSampler::readRandomSets(a.setsFile, sets)) {
+        fprintf(stderr, "ERROR: Cannot read parameter sets from %s\n", qPrintable(a.setsFile));
+        return 1;
+    }
+
+    GlueParallelDriver driver;
+    QEventLoop loop;
+    bool ok = false;
+    connect(&driver, &GlueParallelDriver::progress, [](int done, int total) {
+        if (done == total || done % 50 == 0) {
+            fprintf(stdout, "\r%d / %d model runs", done, total);
             fflush(stdout);
         }
-        QCoreApplication::processEvents();
+    });
+    connect(&driver, &GlueParallelDriver::finished, &loop, [&](bool success) {
+        ok = success;
+        loop.quit();
+    });
+    if (a.converge) {
+        GlueConvergenceOptions opt;
+        opt.batchSize = qMax(1, a.batch);
+        opt.minRuns   = qMax(2 * opt.batchSize, opt.minRuns);
+        opt.tolerance = a.tolerance;
+        opt.stopEarly = a.stopEarly;
+        driver.setConvergence(opt);
+        connect(&driver, &GlueParallelDriver::convergenceChecked, [](const GlueConvergenceCheck &c) {
+            fprintf(stdout, "\r%s\n", qPrintable(c.summary()));
+            fflush(stdout);
+        });
     }
 
-    QByteArray remaining = proc.readAll();
-    if (!remaining.isEmpty()) {
-        fprintf(stdout, "%s", remaining.constData());
-        fflush(stdout);
+    QElapsedTimer timer;
+    timer.start();
+    QString err;
+    if (!driver.start(cfg, sets, &err)) {
+        fprintf(stderr, "ERROR: %s\n", qPrintable(err));
+        return 1;
     }
+    fprintf(stdout, "%d sets on %d worker(s)\n", sets.sets, driver.workerCount());
+    loop.exec();
 
-    int code = proc.exitCode();
-    fprintf(stdout, "\n--- GLUE finished (exit code %d) ---\n", code);
+    // An empty EvaluateFrame would only fail later, in the likelihood step
+    if (driver.failedRuns() == driver.completedRuns()) {
+        fprintf(stderr, "\nERROR: No model run produced output (%d of %d sets run)\n",
+                driver.completedRuns(), sets.sets);
+        return 1;
+    }
+    QString out = a.outPath.isEmpty()
+        ? QFileInfo(a.setsFile).absolutePath() + "/EvaluateFrame_" + QString::number(a.round) + ".txt"
+        : a.outPath;
+    if (!driver.writeMerged(out)) {
+        fprintf(stderr, "\nERROR: Cannot write %s\n", qPrintable(out));
+        return 1;
+    }
+    fprintf(stdout, "\n%d runs (%d without output) in %.1f s: %s\n",
+            driver.completedRuns(), driver.failedRuns(), timer.elapsed() / 1000.0,
+            qPrintable(QDir::toNativeSeparators(out)));
+    if (const GlueConvergenceMonitor *m = driver.convergence()) {
+        QString verdict = "Posterior " + m->verdict();
+        if (driver.stoppedEarly())
+            verdict += QString(", stopped early (%1 of %2 sets not run)")
+                           .arg(sets.sets - driver.completedRuns()).arg(sets.sets);
+        fprintf(stdout, "%s\n", qPrintable(verdict));
+        if (m->needsMoreRuns())
+            fprintf(stdout, "WARNING: posterior has not converged; sample more sets\n");
+    }
     fflush(stdout);
-    return code;
+    return ok ? 0 : 1;
+}
+
+int CommandLineHandler::runStandInModel(const QStringList &args)
+{
+    // Batch file: "$BATCH(CULTIVAR):<crop><cultivar> <name>", then one treatment per line
+    QFile bf(args.last());
+    if (!bf.open(QIODevice::ReadOnly | QIODevice::Text)) return 2;
+    QString cultivarId;
+    QList<int> trts;
+    for (const QString &line : QString::fromLatin1(bf.readAll()).split('\n')) {
+        if (line.startsWith("$BATCH(CULTIVAR):")) {
+            cultivarId = line.mid(19, 6);
+        } else if (!line.startsWith('@') && line.trimmed().size() > 0) {
+            QStringList tok = line.simplified().split(' ');
+            if (tok.size() >= 6) trts << tok[tok.size() - 5].toInt();
+        }
+    }
+
+    // P1 of the cultivar drives the simulated day of anthesis; the truth is P1 = 2
+    QStringList culs = QDir::current().entryList({"*.CUL"}, QDir::Files);
+    if (culs.isEmpty()) return 3;
+    QStringList hdr;
+    double p1 = 0;
+    bool found = false;
+    for (const CulRow &r : CulParser::parse(culs.first(), hdr)) {
+        if (r.varNum.trimmed() == cultivarId && !r.params.isEmpty() && r.params[0]) {
+            p1 = *r.params[0];
+            found = true;
+        }
+    }
+    if (!found) return 4;
+
+    QFile out("Evaluate.OUT");
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Text)) return 5;
+    QTextStream ts(&out);
+    ts << "*EVALUATION : STAND-IN MODEL\n\n";
+    ts << "@RUN EXCODE    TRNO  ADAPS  ADAPM\n";
+    for (int i = 0; i < trts.size(); ++i)
+        ts << QString("%1 STANDIN1 %2 %3 %4\n").arg(i + 1, 4).arg(trts[i], 6)
+                  .arg(30.0 + 10.0 * p1 + trts[i], 6, 'f', 2).arg(30.0 + 20.0 + trts[i], 6, 'f', 2);
+    return 0;
+}
+
+int CommandLineHandler::runStandInGlue()
+{
+    SimulationControl sc;
+    if (!SimulationControl::load("SimulationControl.csv", sc)) return 2;
+    const QString batch = sc.cultivarBatchFile;
+
+    QFile ind(QDir(sc.outputDir).filePath("ModelRunIndicator.txt"));
+    if (!ind.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) return 3;
+    fprintf(stdout, "GLUE stand-in: %s, %d runs\n", qPrintable(batch), sc.numberOfModelRun);
+    fflush(stdout);
+    for (const char *phase : {"Random parameter sets have been generated.",
+                              "Model runs are starting.",
+                              "Likelihood calculation is starting.",
+                              "Likelihood calculation is finished.",
+                              "Starting calculation of posterior.",
+                              "The first round of GLUE is finished."}) {
+        ind.write(QByteArray(phase) + "\n");
+        ind.flush();
+        // Runs stand for milliseconds per phase, so tests can interrupt long jobs
+        QThread::msleep(qBound(0, sc.numberOfModelRun, 60000));
+    }
+    if (batch.startsWith("FAIL")) {
+        fprintf(stderr, "Error in stand-in: cannot open %s\n", qPrintable(batch));
+        return 1;
+    }
+    // GLUE leaves the crop's CUL file with the calibrated line in OutputD
+    QFile cul(QDir(sc.outputDir).filePath(sc.modelId + ".CUL"));
+    if (!cul.open(QIODevice::WriteOnly | QIODevice::Text)) return 4;
+    cul.write(QString("*STAND-IN CULTIVARS\n"
+                      "@VAR#  VRNAME.......... EXPNO   ECO#    P1    P2\n"
+                      "%1 STANDIN              . DFAULT  1.50 15.00\n")
+                  .arg(QFileInfo(batch).completeBaseName(), -6).toLatin1());
+    return 0;
+}
+
+int CommandLineHandler::runStandInRWorker()
+{
+    fprintf(stdout, "@@READY\n");
+    fflush(stdout);
+    char buf[4096];
+    while (fgets(buf, sizeof buf, stdin)) {
+        const QStringList job = QString::fromUtf8(buf).trimmed().split('\t');
+        if (job.value(0) == "QUIT") break;
+        if (job.size() < 3 || job[0] != "JOB") continue;
+        QFile script(job[2]);
+        if (!script.open(QIODevice::ReadOnly | QIODevice::Text)) return 2;
+        for (const QString &line : QString::fromUtf8(script.readAll()).split('\n')) {
+            const QString cmd = line.section(' ', 0, 0), arg = line.section(' ', 1);
+            if (cmd == "echo")  fprintf(stdout, "%s\n", qPrintable(arg));
+            if (cmd == "write") fprintf(stdout, "%s", qPrintable(arg));
+            fflush(stdout);
+            if (cmd == "sleep") QThread::msleep(arg.toInt());
+            if (cmd == "exit") return arg.toInt();
+            // Dies the first time only, like a job hit by a bad interpreter state
+            if (cmd == "exit-once" && !QFile::exists(job[2] + ".died")) {
+                QFile(job[2] + ".died").open(QIODevice::WriteOnly);
+                return arg.toInt();
+            }
+        }
+        fprintf(stdout, "\n@@DONE\t%s\t0\n", qPrintable(job[1]));
+        fflush(stdout);
+    }
+    return 0;
 }
 
 void CommandLineHandler::printUsage()
@@ -444,5 +2466,26 @@ void CommandLineHandler::printUsage()
         "              --name NEWTON\n"
         "              [--runs 100]\n"
         "              [--mode phenology|growth|both]\n"
+        "              [--force]                    Rerun even if a cached result matches\n"
+        "              [--jobs N]                   Calibrate N cultivars at once (comma-separated --cultivar)\n"
+        "              [--json]                     JSON-lines progress events on stdout\n"
+        "  Gen2.exe --sample --crop WH              Write GLUE parameter sets\n"
+        "              --cultivar IB0488\n"
+        "              [--sets 1000] [--method uniform|lhs|sobol]\n"
+        "              [--seed 1] [--round 1|2] [--mode phenology|growth|both]\n"
+        "              [--out RealRandomSets_1.txt]\n"
+        "  Gen2.exe --likelihood                    Posterior of a finished round\n"
+        "              --sets-file RealRandomSets_1.txt\n"
+        "              --eval EvaluateFrame_1.txt\n"
+        "              [--out GluePosterior.txt]\n"
+        "  Gen2.exe --parallel-runs --crop WH       Run the model for every parameter set\n"
+        "              --cultivar IB0488 --sets-file RealRandomSets_1.txt\n"
+        "              [--workers N] [--round 1|2] [--out EvaluateFrame_1.txt]\n"
+        "              [--converge] [--batch 50] [--tolerance 0.01]\n"
+        "              [--stop-early]               Stop once the posterior has converged\n"
+        "  Gen2.exe --merge --crop WH               Write finished GLUE results to the CUL file\n"
+        "              [--cultivar IB0488,IB0489]   (default: every stored result of the crop)\n"
+        "              [--from results.txt]         Cultivar lines to merge instead of stored results\n"
+        "              [--out WHCER048.CUL]         CUL file to update (default: the crop's)\n"
     );
 }
@@ -3,20 +3,41 @@
 #include <QColor>
 #include <QFont>
 #include <QBrush>
+#include <algorithm>
+#include <cmath>
+#include <utility>
 
 CulTableModel::CulTableModel(QObject *parent)
     : QAbstractTableModel(parent)
     , m_paramNames(CUL_PARAM_NAMES)
-{}
+    , m_minMaxBrush(QBrush(Config::MINMAX_COLOR))
+    , m_oorBrush(QBrush(Config::OOR_COLOR))
+{
+    QFont bold;
+    bold.setBold(true);
+    m_boldFont = bold;
+    rebuildColumnTips();
+}
 
 void CulTableModel::setParamNames(const QStringList &names)
 {
     beginResetModel();
     m_paramNames = names;
     if (m_paramNames.isEmpty()) m_paramNames = CUL_PARAM_NAMES; // fallback
+    ++m_generation;
+    clearUndo();
+    rebuildColumnTips();
+    rebuildRanges();
+    rebuildCellStates();
     endResetModel();
 }
 
+void CulTableModel::setColumnTooltips(const QMap<QString, QString> &tips)
+{
+    m_tips = tips;
+    rebuildColumnTips();
+}
+
 void CulTableModel::setCalibrationTypes(const QMap<QString, QString> &types)
 {
     m_calibTypes = types;
@@ -43,6 +64,19 @@ void CulTableModel::setRows(const QVector<CulRow> &rows)
 {
     beginResetModel();
     m_rows = rows;
+    ++m_generation;
+    clearUndo();
+    QVector<QString> ids;
+    QVector<bool> numbered;
+    for (const CulRow &r : rows) {
+        ids << r.varNum;
+        numbered << isNumbered(r);
+    }
+    m_varIndex.reset(ids, numbered);
+    QVector<QString> ecoNums;
+    for (const CulRow &r : rows)
+        ecoNums << r.ecoNum;
+    m_ecoRefs.reset(ecoNums);
 
     // Extract MINIMA (999991) and MAXIMA (999992) for validation
     m_minParams.clear();
@@ -51,6 +85,8 @@ void CulTableModel::setRows(const QVector<CulRow> &rows)
         if (r.varNum == "999991") m_minParams = r.params;
         if (r.varNum == "999992") m_maxParams = r.params;
     }
+    rebuildRanges();
+    rebuildCellStates();
 
     endResetModel();
 }
@@ -59,6 +95,79 @@ void CulTableModel::setMinMaxRows(const CulRow *minRow, const CulRow *maxRow)
 {
     m_minParams = minRow ? minRow->params : QVector<std::optional<double>>();
     m_maxParams = maxRow ? maxRow->params : QVector<std::optional<double>>();
+    rebuildRanges();
+    rebuildCellStates();
+    if (!m_rows.isEmpty())
+        emit dataChanged(index(0, COL_PARAM0), index(m_rows.size() - 1, columnCount() - 1),
+                         {Qt::BackgroundRole, Qt::ToolTipRole});
+}
+
+// ── render state cache ────────────────────────────────────────────────────────
+void CulTableModel::rebuildRanges()
+{
+    m_ranges = QVector<ParamRange>(m_paramNames.size());
+    for (int p = 0; p < m_ranges.size(); ++p) {
+        if (p >= m_minParams.size() || p >= m_maxParams.size()) continue;
+        if (!m_minParams[p].has_value() || !m_maxParams[p].has_value()) continue;
+        ParamRange &r = m_ranges[p];
+        r.lo = m_minParams[p].value();
+        r.hi = m_maxParams[p].value();
+        r.valid = r.hi > r.lo;
+        r.allowed = QString("\nAllowed: %1 to %2").arg(r.lo).arg(r.hi);
+    }
+}
+
+void CulTableModel::rebuildCellStates()
+{
+    const int before = m_violations.size();
+    m_cellState = QVector<quint8>(m_rows.size() * m_paramNames.size());
+    m_violations.clear();
+    for (int r = 0; r < m_rows.size(); ++r)
+        rebuildRowStates(r);
+    if (before > 0 || !m_violations.isEmpty())
+        notifyViolations();
+}
+
+bool CulTableModel::rebuildRowStates(int r)
+{
+    const int stride = m_paramNames.size();
+    const CulRow &row = m_rows[r];
+    const qint64 base = qint64(r) * stride;
+    quint8 *state = m_cellState.data() + base;
+    bool changed = false, outOfRange = false;
+    for (int p = 0; p < stride; ++p) {
+        quint8 s = row.isMinMax ? CellMinMax : 0;
+        if (p >= row.params.size() || !row.params[p].has_value())
+            s |= CellEmpty;
+        else if (!row.isMinMax)
+            s |= isOutOfRange(p, row.params[p].value()) ? CellOutOfRange : CellInRange;
+        const bool was = state[p] & CellOutOfRange;
+        const bool is  = s & CellOutOfRange;
+        if (was != is) {
+            if (is) m_violations.insert(base + p);
+            else    m_violations.remove(base + p);
+            changed = true;
+        }
+        outOfRange |= is;
+        state[p] = s;
+    }
+    return changed || outOfRange;
+}
+
+void CulTableModel::rebuildColumnTips()
+{
+    m_colTips.resize(columnCount());
+    for (int col = 0; col < m_colTips.size(); ++col) {
+        const QString name = columnName(col);
+        m_colTips[col] = m_tips.value(name, name);
+    }
+}
+
+quint8 CulTableModel::cellState(int row, int paramIdx) const
+{
+    const int stride = m_paramNames.size();
+    if (row < 0 || row >= m_rows.size() || paramIdx < 0 || paramIdx >= stride) return CellEmpty;
+    return m_cellState[qsizetype(row) * stride + paramIdx];
 }
 
 int CulTableModel::rowCount(const QModelIndex &) const { return m_rows.size(); }
@@ -81,14 +190,9 @@ QString CulTableModel::columnName(int col) const
 
 bool CulTableModel::isOutOfRange(int paramIdx, double value) const
 {
-    if (m_minParams.size() > paramIdx && m_maxParams.size() > paramIdx) {
-        if (m_minParams[paramIdx].has_value() && m_maxParams[paramIdx].has_value()) {
-            double lo = m_minParams[paramIdx].value();
-            double hi = m_maxParams[paramIdx].value();
-            if (hi > lo) return (value < lo || value > hi);
-        }
-    }
-    return false;
+    if (paramIdx < 0 || paramIdx >= m_ranges.size() || !m_ranges[paramIdx].valid) return false;
+    const ParamRange &r = m_ranges[paramIdx];
+    return value < r.lo || value > r.hi;
 }
 
 QVariant CulTableModel::data(const QModelIndex &index, int role) const
@@ -136,37 +240,24 @@ QVariant CulTableModel::data(const QModelIndex &index, int role) const
 
     if (role == Qt::BackgroundRole) {
         if (row.isMinMax)
-            return QBrush(Config::MINMAX_COLOR);
-        if (col >= COL_PARAM0) {
-            int p = col - COL_PARAM0;
-            if (p < row.params.size() && row.params[p].has_value() && isOutOfRange(p, row.params[p].value()))
-                return QBrush(Config::OOR_COLOR);
-        }
+            return m_minMaxBrush;
+        if (col >= COL_PARAM0 && (cellState(index.row(), col - COL_PARAM0) & CellOutOfRange))
+            return m_oorBrush;
         return QVariant();
     }
 
-    if (role == Qt::FontRole && row.isMinMax) {
-        QFont f;
-        f.setBold(true);
-        return f;
-    }
+    if (role == Qt::FontRole && row.isMinMax)
+        return m_boldFont;
 
     if (role == Qt::ToolTipRole) {
-        QString name = columnName(col);
-        QString tip = m_tips.value(name, name);
-
+        const QString &tip = m_colTips.value(col);
         // Add min/max range info if out of range
-        if (col >= COL_PARAM0) {
-            int p = col - COL_PARAM0;
-            if (p < row.params.size() && row.params[p].has_value() && isOutOfRange(p, row.params[p].value())) {
-                double lo = (p < m_minParams.size() && m_minParams[p].has_value()) ? m_minParams[p].value() : 0.0;
-                double hi = (p < m_maxParams.size() && m_maxParams[p].has_value()) ? m_maxParams[p].value() : 0.0;
-                tip += QString("\n\n⚠️ OUT OF RANGE");
-                tip += QString("\nValue: %1").arg(row.params[p].value());
-                tip += QString("\nAllowed: %1 to %2").arg(lo).arg(hi);
-            }
+        const int p = col - COL_PARAM0;
+        if (col >= COL_PARAM0 && (cellState(index.row(), p) & CellOutOfRange)) {
+            return tip + QString("\n\n⚠️ OUT OF RANGE")
+                       + QString("\nValue: %1").arg(row.params[p].value())
+                       + m_ranges[p].allowed;
         }
-
         return tip;
     }
 
@@ -207,11 +298,8 @@ QVariant CulTableModel::headerData(int section, Qt::Orientation orientation, int
         return tip;
     }
 
-    if (role == Qt::FontRole) {
-        QFont f;
-        f.setBold(true);
-        return f;
-    }
+    if (role == Qt::FontRole)
+        return m_boldFont;
 
     return QVariant();
 }
@@ -233,13 +321,26 @@ bool CulTableModel::setData(const QModelIndex &index, const QVariant &value, int
 
     CulRow &row = m_rows[index.row()];
     if (row.isMinMax) return false;
+    const CulRow before = row;
 
     int col = index.column();
+    bool violations = false;
     switch (col) {
-    case COL_VARNUM: row.varNum = value.toString().left(6); break;
+    case COL_VARNUM:
+        row.varNum = value.toString().left(6);
+        m_varIndex.rename(index.row(), row.varNum, isNumbered(row));
+        // The violations list names the cultivar by VAR#
+        violations = rebuildRowStates(index.row());
+        break;
     case COL_VRNAME: row.vrName = value.toString().left(13); break;
     case COL_EXPNO:  row.expNo  = value.toString().left(7).leftJustified(7, ' '); break;
-    case COL_ECONUM: row.ecoNum = value.toString().left(6); break;
+    case COL_ECONUM: {
+        const QString old = row.ecoNum;
+        row.ecoNum = value.toString().left(6);
+        m_ecoRefs.rename(index.row(), row.ecoNum);
+        notifyEcoRefs({old, row.ecoNum});
+        break;
+    }
     default: {
         int p = col - COL_PARAM0;
         if (p >= 0 && p < m_paramNames.size()) {
@@ -257,19 +358,19 @@ bool CulTableModel::setData(const QModelIndex &index, const QVariant &value, int
                 row.params[p] = std::optional<double>(v);
                 row.paramStrs[p] = str; // Preserve string so decimal precision is kept on write
             }
+            violations = rebuildRowStates(index.row());
         } else return false;
     }
     }
 
-    emit dataChanged(index, index, {role});
-    emit dataModified();
+    record(RowChange::Replace, index.row(), before, row);
+    notifyCells(index.row(), col, index.row(), col);
+    notifyModified(violations);
     return true;
 }
 
 void CulTableModel::addRow(const QString &vrName)
 {
-    int n = m_rows.size();
-    beginInsertRows(QModelIndex(), n, n);
     CulRow r;
     r.varNum  = generateUniqueVarNum();
     r.vrName  = vrName;
@@ -278,15 +379,11 @@ void CulTableModel::addRow(const QString &vrName)
     r.params  = QVector<std::optional<double>>(m_paramNames.size());
     r.paramStrs = QVector<QString>(m_paramNames.size(), "");
     r.isMinMax = false;
-    m_rows.append(r);
-    endInsertRows();
-    emit dataModified();
+    insertRowAt(m_rows.size(), r);
 }
 
 void CulTableModel::addRowWithData(const QString &vrName, const QString &expNo, const QString &ecoNum)
 {
-    int n = m_rows.size();
-    beginInsertRows(QModelIndex(), n, n);
     CulRow r;
     r.varNum  = generateUniqueVarNum();
     r.vrName  = vrName;
@@ -295,15 +392,11 @@ void CulTableModel::addRowWithData(const QString &vrName, const QString &expNo,
     r.params  = QVector<std::optional<double>>(m_paramNames.size());
     r.paramStrs = QVector<QString>(m_paramNames.size(), "");
     r.isMinMax = false;
-    m_rows.append(r);
-    endInsertRows();
-    emit dataModified();
+    insertRowAt(m_rows.size(), r);
 }
 
 void CulTableModel::addRowWithFullData(const QString &vrName, const QString &expNo, const QString &ecoNum, const QVector<std::optional<double>> &params)
 {
-    int n = m_rows.size();
-    beginInsertRows(QModelIndex(), n, n);
     CulRow r;
     r.varNum  = generateUniqueVarNum();
     r.vrName  = vrName;
@@ -318,64 +411,147 @@ void CulTableModel::addRowWithFullData(const QString &vrName, const QString &exp
     }
     
     r.isMinMax = false;
-    m_rows.append(r);
-    endInsertRows();
-    emit dataModified();
+    insertRowAt(m_rows.size(), r);
 }
 
 QString CulTableModel::generateUniqueVarNum() const
 {
-    // Find the most recent crop code (first 2 chars) and highest number for that code
-    QString cropCode = "NEW";  // Default fallback
-    int maxNum = 0;
-    
-    for (const auto &row : m_rows) {
-        if (row.varNum.length() >= 6) {
-            QString code = row.varNum.left(2);
-            bool ok;
-            int num = row.varNum.right(4).toInt(&ok);
-            if (ok) {
-                // Use the last non-MINMAX code we find, and track the highest number
-                if (!row.isMinMax && code != "99") {
-                    cropCode = code;
-                    if (num > maxNum)
-                        maxNum = num;
-                }
-            }
-        }
-    }
-    
-    // Format as [CROP_CODE] + 4-digit zero-padded number
-    return QString("%1%2").arg(cropCode).arg(maxNum + 1, 4, 10, QChar('0'));
+    // Code of the last cultivar (first 2 chars), next number after its highest
+    return m_varIndex.nextId("NEW");
 }
 
 void CulTableModel::duplicateRow(int row)
 {
     if (row < 0 || row >= m_rows.size()) return;
-    int n = m_rows.size();
-    beginInsertRows(QModelIndex(), n, n);
     CulRow r = m_rows[row];
     r.isMinMax = false;
     r.varNum   = r.varNum + "X";   // User should rename
-    m_rows.append(r);
-    endInsertRows();
-    emit dataModified();
+    insertRowAt(m_rows.size(), r);
 }
 
 void CulTableModel::deleteRow(int row)
 {
     if (row < 0 || row >= m_rows.size()) return;
     if (m_rows[row].isMinMax) return;  // Protect MINIMA/MAXIMA
+    removeRowAt(row);
+}
+
+// ── row storage ───────────────────────────────────────────────────────────────
+void CulTableModel::insertRowAt(int row, const CulRow &r)
+{
+    beginInsertRows(QModelIndex(), row, row);
+    m_rows.insert(row, r);
+    m_varIndex.insert(row, r.varNum, isNumbered(r));
+    m_ecoRefs.insert(row, r.ecoNum);
+    const qint64 stride = m_paramNames.size(), first = row * stride;
+    m_cellState.insert(first, stride, 0);
+    // Cells below the new row move down by one row
+    if (row < m_rows.size() - 1) {
+        QSet<qint64> shifted;
+        for (qint64 cell : std::as_const(m_violations))
+            shifted.insert(cell < first ? cell : cell + stride);
+        m_violations.swap(shifted);
+    }
+    const bool violations = rebuildRowStates(row);
+    endInsertRows();
+    record(RowChange::Insert, row, CulRow(), r);
+    notifyEcoRefs({r.ecoNum});
+    notifyModified(violations);
+}
+
+void CulTableModel::removeRowAt(int row)
+{
     beginRemoveRows(QModelIndex(), row, row);
+    const CulRow old = m_rows[row];
     m_rows.removeAt(row);
+    m_varIndex.remove(row);
+    m_ecoRefs.remove(row);
+    const qint64 stride = m_paramNames.size(), first = row * stride, last = first + stride;
+    m_cellState.remove(first, stride);
+    // Cells below the removed row move up by one row
+    QSet<qint64> shifted;
+    bool violations = false;
+    for (qint64 cell : std::as_const(m_violations)) {
+        if (cell < first) shifted.insert(cell);
+        else if (cell >= last) shifted.insert(cell - stride);
+        else violations = true;
+    }
+    m_violations.swap(shifted);
     endRemoveRows();
-    emit dataModified();
+    record(RowChange::Remove, row, old, CulRow());
+    notifyEcoRefs({old.ecoNum});
+    notifyModified(violations);
+}
+
+void CulTableModel::replaceRow(int row, const CulRow &r)
+{
+    const CulRow old = m_rows[row];
+    m_rows[row] = r;
+    m_varIndex.rename(row, r.varNum, isNumbered(r));
+    m_ecoRefs.rename(row, r.ecoNum);
+    record(RowChange::Replace, row, old, r);
+    bool violations = false;
+    if (isRangeRow(old) || isRangeRow(r)) {
+        m_minParams.clear();
+        m_maxParams.clear();
+        for (const CulRow &mr : std::as_const(m_rows)) {
+            if (mr.varNum == "999991") m_minParams = mr.params;
+            if (mr.varNum == "999992") m_maxParams = mr.params;
+        }
+        rebuildRanges();
+        rebuildCellStates();
+        notifyCells(0, 0, m_rows.size() - 1, columnCount() - 1);
+    } else {
+        violations = rebuildRowStates(row);
+        notifyCells(row, 0, row, columnCount() - 1);
+    }
+    notifyEcoRefs({old.ecoNum, r.ecoNum});
+    notifyModified(violations);
 }
 
 void CulTableModel::setRowPreComment(int row, const QString &comment)
 {
     if (row < 0 || row >= m_rows.size()) return;
     m_rows[row].preComment = comment;
+    ++m_generation;
+}
+
+// ── columnar reads ────────────────────────────────────────────────────────────
+void CulTableModel::textColumn(int col, int first, int count, QVector<QString> *out) const
+{
+    out->resize(count);
+    const int p = col - COL_PARAM0;
+    for (int i = 0; i < count; ++i) {
+        const CulRow &row = m_rows[first + i];
+        QString &cell = (*out)[i];
+        switch (col) {
+        case COL_VARNUM: cell = row.varNum; break;
+        case COL_VRNAME: cell = row.vrName; break;
+        case COL_EXPNO:  cell = row.expNo;  break;
+        case COL_ECONUM: cell = row.ecoNum; break;
+        default:
+            cell = (p < row.params.size() && row.params[p].has_value())
+                 ? QString::number(row.params[p].value()) : QString();
+        }
+    }
+}
+
+void CulTableModel::numberColumn(int col, int first, int count, QVector<double> *values, QBitArray *present) const
+{
+    values->resize(count);
+    *present = QBitArray(count);
+    const int p = col - COL_PARAM0;
+    if (p < 0) return;
+    double *v = values->data();
+    for (int i = 0; i < count; ++i) {
+        const QVector<std::optional<double>> &params = m_rows[first + i].params;
+        if (p < params.size() && params[p].has_value()) {
+            v[i] = params[p].value();
+            present->setBit(i);
+        } else {
+            v[i] = 0.0;
+        }
+    }
 }
 
 QString CulTableModel::Violation::toString() const
@@ -388,27 +564,278 @@ QString CulTableModel::Violation::toString() const
         .arg(maxVal);
 }
 
+// ── ECO# references ───────────────────────────────────────────────────────────
+QVector<int> CulTableModel::rowsUsingEco(const QString &ecoNum) const
+{
+    QVector<int> rows = m_ecoRefs.rowsOf(ecoNum);
+    rows.erase(std::remove_if(rows.begin(), rows.end(),
+                              [this](int r) { return m_rows[r].isMinMax; }),
+               rows.end());
+    return rows;
+}
+
+QHash<QString, int> CulTableModel::ecoRefCounts() const
+{
+    QHash<QString, int> counts;
+    for (const QString &ecoNum : m_ecoRefs.ids()) {
+        const int n = ecoRefCount(ecoNum);
+        if (n > 0) counts.insert(ecoNum, n);
+    }
+    return counts;
+}
+
 QVector<CulTableModel::Violation> CulTableModel::getViolations() const
 {
-    QVector<Violation> violations;
+    QList<qint64> cells(m_violations.cbegin(), m_violations.cend());
+    std::sort(cells.begin(), cells.end());
 
-    for (int r = 0; r < m_rows.size(); ++r) {
+    QVector<Violation> violations;
+    violations.reserve(cells.size());
+    const int stride = m_paramNames.size();
+    for (qint64 cell : cells) {
+        const int r = int(cell / stride), p = int(cell % stride);
         const CulRow &row = m_rows[r];
-        if (row.isMinMax) continue;  // Skip MINIMA/MAXIMA rows
-
-        for (int p = 0; p < row.params.size() && p < m_paramNames.size(); ++p) {
-            if (row.params[p].has_value() && isOutOfRange(p, row.params[p].value())) {
-                Violation v;
-                v.row       = r;
-                v.varNum    = row.varNum;
-                v.paramName = m_paramNames[p];
-                v.value     = row.params[p].has_value() ? row.params[p].value() : 0.0;
-                v.minVal    = (p < m_minParams.size() && m_minParams[p].has_value()) ? m_minParams[p].value() : 0.0;
-                v.maxVal    = (p < m_maxParams.size() && m_maxParams[p].has_value()) ? m_maxParams[p].value() : 0.0;
-                violations.append(v);
-            }
+        Violation v;
+        v.row       = r;
+        v.paramIdx  = p;
+        v.varNum    = row.varNum;
+        v.paramName = m_paramNames[p];
+        v.value     = row.params[p].value();
+        v.minVal    = m_ranges[p].lo;
+        v.maxVal    = m_ranges[p].hi;
+        violations.append(v);
+    }
+    return violations;
+}
+
+void CulTableModel::applyMerged(const QVector<CulRow> &rows, const QVector<int> &changedRows)
+{
+    if (rows.size() < m_rows.size() || changedRows.isEmpty()) return;
+    EditBatch batch(this);   // one undo step
+    const int oldCount = m_rows.size();
+    bool rangesChanged = false;
+    for (int r : changedRows)
+        if (r < oldCount && (rows[r].varNum == "999991" || rows[r].varNum == "999992"))
+            rangesChanged = true;
+    QStringList ecoNums;
+    for (int r : changedRows) {
+        if (r >= oldCount) continue;
+        if (rows[r].ecoNum != m_rows[r].ecoNum) ecoNums << m_rows[r].ecoNum;
+        record(RowChange::Replace, r, m_rows[r], rows[r]);
+    }
+    for (int r = 0; r < oldCount; ++r)
+        m_rows[r] = rows[r];
+    for (int r : changedRows) {
+        if (r >= oldCount) continue;
+        m_varIndex.rename(r, m_rows[r].varNum, isNumbered(m_rows[r]));
+        m_ecoRefs.rename(r, m_rows[r].ecoNum);
+        ecoNums << m_rows[r].ecoNum;
+    }
+    bool violations = false;
+    if (rangesChanged) {
+        for (const auto &r : m_rows) {
+            if (r.varNum == "999991") m_minParams = r.params;
+            if (r.varNum == "999992") m_maxParams = r.params;
+        }
+        rebuildRanges();
+    }
+    if (rows.size() > oldCount) {
+        beginInsertRows(QModelIndex(), oldCount, rows.size() - 1);
+        for (int r = oldCount; r < rows.size(); ++r) {
+            m_rows.append(rows[r]);
+            m_varIndex.insert(r, rows[r].varNum, isNumbered(rows[r]));
+            m_ecoRefs.insert(r, rows[r].ecoNum);
+            record(RowChange::Insert, r, CulRow(), rows[r]);
+            ecoNums << rows[r].ecoNum;
+        }
+        m_cellState.resize(m_rows.size() * m_paramNames.size());
+        for (int r = oldCount; r < rows.size(); ++r)
+            violations |= rebuildRowStates(r);
+        endInsertRows();
+    }
+    if (rangesChanged) {
+        rebuildCellStates();
+        notifyCells(0, 0, m_rows.size() - 1, columnCount() - 1);
+    } else {
+        for (int r : changedRows) {
+            if (r >= oldCount) continue;
+            violations |= rebuildRowStates(r);
+            notifyCells(r, 0, r, columnCount() - 1);
         }
     }
+    notifyEcoRefs(ecoNums);
+    notifyModified(violations);
+}
 
-    return violations;
+// ── batched edits ─────────────────────────────────────────────────────────────
+void CulTableModel::beginBatch()
+{
+    ++m_batchDepth;
+}
+
+void CulTableModel::commitBatch()
+{
+    if (m_batchDepth == 0 || --m_batchDepth > 0) return;
+    // Rows removed inside the batch may have shrunk the table
+    const QRect cells = m_batchCells.intersected(QRect(0, 0, columnCount(), m_rows.size()));
+    const bool violations = m_batchViolations, modified = m_batchModified;
+    m_batchCells = QRect();
+    m_batchViolations = m_batchModified = false;
+    const QStringList ecoNums(m_batchEcoRefs.cbegin(), m_batchEcoRefs.cend());
+    m_batchEcoRefs.clear();
+    if (!cells.isEmpty())
+        emit dataChanged(index(cells.top(), cells.left()), index(cells.bottom(), cells.right()));
+    if (violations) emit violationsChanged(m_violations.size());
+    if (!ecoNums.isEmpty()) emit ecoRefsChanged(ecoNums);
+    flushUndo();
+    if (modified) emit dataModified();
+}
+
+void CulTableModel::notifyCells(int top, int left, int bottom, int right)
+{
+    if (bottom < top) return;
+    if (m_batchDepth > 0)
+        m_batchCells |= QRect(QPoint(left, top), QPoint(right, bottom));
+    else
+        emit dataChanged(index(top, left), index(bottom, right));
+}
+
+void CulTableModel::notifyViolations()
+{
+    if (m_batchDepth > 0)
+        m_batchViolations = true;
+    else
+        emit violationsChanged(m_violations.size());
+}
+
+void CulTableModel::notifyEcoRefs(const QStringList &ecoNums)
+{
+    QSet<QString> keys;
+    for (const QString &e : ecoNums)
+        keys.insert(IdentifierIndex::normalize(e));
+    if (keys.isEmpty()) return;
+    if (m_batchDepth > 0)
+        m_batchEcoRefs.unite(keys);
+    else
+        emit ecoRefsChanged(QStringList(keys.cbegin(), keys.cend()));
+}
+
+void CulTableModel::notifyModified(bool violations)
+{
+    ++m_generation;
+    if (violations) notifyViolations();
+    if (m_batchDepth > 0)
+        m_batchModified = true;
+    else
+        emit dataModified();
+}
+
+// ── undo ──────────────────────────────────────────────────────────────────────
+void CulTableModel::setUndoStack(QUndoStack *stack)
+{
+    m_undoPending.clear();
+    m_undoStack = stack;
+}
+
+void CulTableModel::record(RowChange::Kind kind, int row, const CulRow &before, const CulRow &after)
+{
+    if (!m_undoStack || m_replaying) return;
+    m_undoPending.append({kind, row, before, after});
+    if (m_batchDepth == 0) flushUndo();
+}
+
+void CulTableModel::flushUndo()
+{
+    if (!m_undoStack || m_undoPending.isEmpty()) return;
+    m_undoStack->push(new TableUndoCommand<CulTableModel>(this, std::exchange(m_undoPending, {})));
+}
+
+void CulTableModel::clearUndo()
+{
+    m_undoPending.clear();
+    if (m_undoStack) m_undoStack->clear();
+}
+
+void CulTableModel::replayChanges(const QVector<RowChange> &changes, bool undo)
+{
+    m_replaying = true;
+    EditBatch batch(this);
+    const int n = changes.size();
+    for (int i = 0; i < n; ++i) {
+        const RowChange &c = changes[undo ? n - 1 - i : i];
+        switch (c.kind) {
+        case RowChange::Replace: replaceRow(c.row, undo ? c.before : c.after); break;
+        case RowChange::Insert:  undo ? removeRowAt(c.row) : insertRowAt(c.row, c.after); break;
+        case RowChange::Remove:  undo ? insertRowAt(c.row, c.before) : removeRowAt(c.row); break;
+        }
+    }
+    batch.commit();
+    m_replaying = false;
+}
+
+// ── column formulas ───────────────────────────────────────────────────────────
+bool CulTableModel::Formula::parse(const QString &text, Formula *out, QString *errorMsg)
+{
+    QString s = text.trimmed();
+    QChar op('=');
+    if (!s.isEmpty() && QString("*/+-=").contains(s[0])) {
+        op = s[0];
+        s = s.mid(1).trimmed();
+    }
+    bool ok = false;
+    const double v = s.toDouble(&ok);
+    if (!ok || !std::isfinite(v)) {
+        if (errorMsg) *errorMsg = QString("not a number: '%1'").arg(s);
+        return false;
+    }
+    if (op == '/' && v == 0.0) {
+        if (errorMsg) *errorMsg = "division by zero";
+        return false;
+    }
+    Formula f;
+    if (op == '*')      f.scale  = v;
+    else if (op == '/') f.scale  = 1.0 / v;
+    else if (op == '+') f.offset = v;
+    else if (op == '-') f.offset = -v;
+    else { f.scale = 0.0; f.offset = v; }
+    *out = f;
+    return true;
+}
+
+int CulTableModel::applyFormula(int paramIdx, const QVector<int> &rows, const Formula &f)
+{
+    if (paramIdx < 0 || paramIdx >= m_paramNames.size()) return 0;
+
+    // Gather the column, transform it in one pass, then write back
+    QVector<int>    targets;
+    QVector<double> values;
+    targets.reserve(rows.size());
+    values.reserve(rows.size());
+    for (int r : rows) {
+        if (r < 0 || r >= m_rows.size() || m_rows[r].isMinMax) continue;
+        const CulRow &row = m_rows[r];
+        if (paramIdx >= row.params.size() || !row.params[paramIdx].has_value()) continue;
+        targets.append(r);
+        values.append(row.params[paramIdx].value());
+    }
+    const double scale = f.scale, offset = f.offset;
+    for (double &v : values)
+        v = v * scale + offset;
+
+    EditBatch batch(this);
+    const int col = COL_PARAM0 + paramIdx;
+    bool violations = false;
+    int changed = 0;
+    for (int i = 0; i < targets.size(); ++i) {
+        const int r = targets[i];
+        if (*m_rows[r].params[paramIdx] == values[i]) continue;
+        const CulRow before = m_rows[r];
+        m_rows[r].params[paramIdx] = values[i];   // paramStrs keeps the cell's decimals for write
+        record(RowChange::Replace, r, before, m_rows[r]);
+        violations |= rebuildRowStates(r);
+        notifyCells(r, col, r, col);
+        ++changed;
+    }
+    if (changed > 0) notifyModified(violations);
+    return changed;
 }
@@ -0,0 +1,65 @@
+#include "CulViolationPanel.h"
+#include <QVBoxLayout>
+
+static const int ROW_ROLE   = Qt::UserRole;
+static const int PARAM_ROLE = Qt::UserRole + 1;
+
+CulViolationPanel::CulViolationPanel(CulTableModel *model, QWidget *parent)
+    : QWidget(parent)
+    , m_model(model)
+{
+    QVBoxLayout *vbox = new QVBoxLayout(this);
+    vbox->setContentsMargins(4, 4, 4, 4);
+    vbox->setSpacing(4);
+    m_summary = new QLabel;
+    m_list = new QListWidget;
+    m_list->setUniformItemSizes(true);
+    m_list->setToolTip("Double-click to show the cell in the CUL table");
+    vbox->addWidget(m_summary);
+    vbox->addWidget(m_list, 1);
+
+    m_refreshTimer.setSingleShot(true);
+    m_refreshTimer.setInterval(0);
+    connect(&m_refreshTimer, &QTimer::timeout, this, &CulViolationPanel::refresh);
+    // Rows shift on insert/remove/reset; values and ranges report through violationsChanged
+    connect(model, &CulTableModel::violationsChanged, this, &CulViolationPanel::scheduleRefresh);
+    connect(model, &QAbstractItemModel::modelReset,   this, &CulViolationPanel::scheduleRefresh);
+    connect(model, &QAbstractItemModel::rowsRemoved,  this, &CulViolationPanel::scheduleRefresh);
+    connect(model, &QAbstractItemModel::rowsInserted, this, &CulViolationPanel::scheduleRefresh);
+
+    connect(m_list, &QListWidget::itemActivated, this, [this](QListWidgetItem *item) {
+        emit cellActivated(item->data(ROW_ROLE).toInt(),
+                           CulTableModel::COL_PARAM0 + item->data(PARAM_ROLE).toInt());
+    });
+    refresh();
+}
+
+void CulViolationPanel::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    if (m_stale) refresh();
+}
+
+void CulViolationPanel::scheduleRefresh()
+{
+    m_stale = true;
+    if (isVisible()) m_refreshTimer.start();
+}
+
+void CulViolationPanel::refresh()
+{
+    m_stale = false;
+    const QVector<CulTableModel::Violation> violations = m_model->getViolations();
+    m_summary->setText(violations.isEmpty()
+        ? QString("All values within MINIMA/MAXIMA")
+        : QString("%1 value(s) outside MINIMA/MAXIMA").arg(violations.size()));
+
+    m_list->setUpdatesEnabled(false);
+    m_list->clear();
+    for (const CulTableModel::Violation &v : violations) {
+        QListWidgetItem *item = new QListWidgetItem(v.toString(), m_list);
+        item->setData(ROW_ROLE, v.row);
+        item->setData(PARAM_ROLE, v.paramIdx);
+    }
+    m_list->setUpdatesEnabled(true);
+}
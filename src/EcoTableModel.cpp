@@ -2,6 +2,7 @@
 #include "Config.h"
 #include <QBrush>
 #include <QFont>
+#include <utility>
 
 EcoTableModel::EcoTableModel(QObject *parent)
     : QAbstractTableModel(parent)
@@ -11,9 +12,38 @@ void EcoTableModel::setRows(const QVector<EcoRow> &rows)
 {
     beginResetModel();
     m_rows = rows;
+    ++m_generation;
+    m_undoPending.clear();
+    if (m_undoStack) m_undoStack->clear();
+    QVector<QString> ids;
+    QVector<bool> numbered;
+    for (const EcoRow &r : rows) {
+        ids << r.ecoNum;
+        numbered << !r.isMinMax;
+    }
+    m_ecoIndex.reset(ids, numbered);
     endResetModel();
 }
 
+void EcoTableModel::setCulCrossRef(const QHash<QString, int> &refCounts)
+{
+    m_refCounts = refCounts;
+    if (!m_rows.isEmpty())
+        emit dataChanged(index(0, COL_REFS), index(m_rows.size() - 1, COL_REFS));
+}
+
+void EcoTableModel::setCulRefCount(const QString &ecoNum, int count)
+{
+    const QString key = IdentifierIndex::normalize(ecoNum);
+    if (m_refCounts.value(key, 0) == count) return;
+    if (count > 0)
+        m_refCounts.insert(key, count);
+    else
+        m_refCounts.remove(key);
+    for (int r : m_ecoIndex.rowsOf(key))
+        emit dataChanged(index(r, COL_REFS), index(r, COL_REFS));
+}
+
 int EcoTableModel::rowCount(const QModelIndex &) const { return m_rows.size(); }
 int EcoTableModel::columnCount(const QModelIndex &) const { return TOTAL_COLS; }
 
@@ -48,7 +78,7 @@ QVariant EcoTableModel::data(const QModelIndex &index, int role) const
         case COL_ECONAME: return row.ecoName;
         case COL_MG:      return row.mg;
         case COL_TM:      return row.tm;
-        case COL_REFS:    return m_refCounts.value(row.ecoNum, 0);
+        case COL_REFS:    return refCount(row);
         default: {
             int p = col - COL_PARAM0;
             if (p >= 0 && p < row.params.size()) {
@@ -67,7 +97,7 @@ QVariant EcoTableModel::data(const QModelIndex &index, int role) const
         case COL_ECONAME: return row.ecoName;
         case COL_MG:      return row.mg;
         case COL_TM:      return row.tm;
-        case COL_REFS:    return m_refCounts.value(row.ecoNum, 0);
+        case COL_REFS:    return refCount(row);
         default: {
             int p = col - COL_PARAM0;
             if (p >= 0 && p < row.params.size()) {
@@ -81,7 +111,7 @@ QVariant EcoTableModel::data(const QModelIndex &index, int role) const
 
     if (role == Qt::BackgroundRole) {
         if (row.isMinMax)  return QBrush(Config::MINMAX_COLOR);
-        if (col == COL_REFS && m_refCounts.value(row.ecoNum, 0) == 0)
+        if (col == COL_REFS && refCount(row) == 0)
             return QBrush(Config::WARNING_COLOR);
         return QVariant();
     }
@@ -124,10 +154,16 @@ bool EcoTableModel::setData(const QModelIndex &index, const QVariant &value, int
 
     EcoRow &row = m_rows[index.row()];
     if (row.isMinMax) return false;
+    const EcoRow before = row;
 
     int col = index.column();
     switch (col) {
-    case COL_ECONUM:  row.ecoNum  = value.toString().left(6); break;
+    case COL_ECONUM:
+        row.ecoNum = value.toString().left(6);
+        m_ecoIndex.rename(index.row(), row.ecoNum);
+        // The REFS cell follows the new ECO#
+        notifyCells(index.row(), COL_REFS, index.row(), COL_REFS);
+        break;
     case COL_ECONAME: row.ecoName = value.toString().left(16); break;
     case COL_MG:      row.mg      = value.toString().left(2); break;
     case COL_TM:      row.tm      = value.toString().left(2); break;
@@ -148,15 +184,14 @@ bool EcoTableModel::setData(const QModelIndex &index, const QVariant &value, int
     }
     }
 
-    emit dataChanged(index, index, {role});
-    emit dataModified();
+    record(RowChange::Replace, index.row(), before, row);
+    notifyCells(index.row(), col, index.row(), col);
+    notifyModified();
     return true;
 }
 
 void EcoTableModel::addRow(const QString &ecoName)
 {
-    int n = m_rows.size();
-    beginInsertRows(QModelIndex(), n, n);
     EcoRow r;
     r.ecoNum  = generateUniqueEcoNum();
     r.ecoName = ecoName;
@@ -164,15 +199,11 @@ void EcoTableModel::addRow(const QString &ecoName)
     r.tm      = " 0";
     r.params  = QVector<std::optional<double>>(16);  // Initialize with nullopt
     r.isMinMax = false;
-    m_rows.append(r);
-    endInsertRows();
-    emit dataModified();
+    insertRowAt(m_rows.size(), r);
 }
 
 void EcoTableModel::addRowWithData(const QString &ecoName, const QString &mg, const QString &tm)
 {
-    int n = m_rows.size();
-    beginInsertRows(QModelIndex(), n, n);
     EcoRow r;
     r.ecoNum  = generateUniqueEcoNum();
     r.ecoName = ecoName;
@@ -180,15 +211,11 @@ void EcoTableModel::addRowWithData(const QString &ecoName, const QString &mg, co
     r.tm      = tm;
     r.params  = QVector<std::optional<double>>(16);  // Initialize with nullopt
     r.isMinMax = false;
-    m_rows.append(r);
-    endInsertRows();
-    emit dataModified();
+    insertRowAt(m_rows.size(), r);
 }
 
 void EcoTableModel::addRowWithFullData(const QString &ecoName, const QString &mg, const QString &tm, const QVector<std::optional<double>> &params)
 {
-    int n = m_rows.size();
-    beginInsertRows(QModelIndex(), n, n);
     EcoRow r;
     r.ecoNum  = generateUniqueEcoNum();
     r.ecoName = ecoName;
@@ -202,53 +229,177 @@ void EcoTableModel::addRowWithFullData(const QString &ecoName, const QString &mg
     }
     
     r.isMinMax = false;
-    m_rows.append(r);
-    endInsertRows();
-    emit dataModified();
+    insertRowAt(m_rows.size(), r);
 }
 
 QString EcoTableModel::generateUniqueEcoNum() const
 {
-    // Find the prefix (e.g., "G", "D") and highest number
-    QString prefix = "ECO";  // Default fallback
-    int maxNum = 0;
-    
-    for (const auto &row : m_rows) {
-        if (row.ecoNum.length() >= 5) {
-            QString code = row.ecoNum.left(1);
-            bool ok;
-            int num = row.ecoNum.right(4).toInt(&ok);
-            if (ok && !row.isMinMax) {
-                prefix = code;
-                if (num > maxNum)
-                    maxNum = num;
-            }
-        }
-    }
-    
-    // Format as [PREFIX] + 4-digit zero-padded number
-    return QString("%1%2").arg(prefix).arg(maxNum + 1, 4, 10, QChar('0'));
+    // Prefix of the last ecotype (e.g. "G", "D"), next number after its highest
+    return m_ecoIndex.nextId("ECO");
 }
 
 void EcoTableModel::duplicateRow(int row)
 {
     if (row < 0 || row >= m_rows.size()) return;
-    int n = m_rows.size();
-    beginInsertRows(QModelIndex(), n, n);
     EcoRow r  = m_rows[row];
     r.isMinMax = false;
     r.ecoNum   = r.ecoNum + "X";
-    m_rows.append(r);
-    endInsertRows();
-    emit dataModified();
+    insertRowAt(m_rows.size(), r);
 }
 
 void EcoTableModel::deleteRow(int row)
 {
     if (row < 0 || row >= m_rows.size()) return;
     if (m_rows[row].isMinMax) return;
+    removeRowAt(row);
+}
+
+// ── row storage ───────────────────────────────────────────────────────────────
+void EcoTableModel::insertRowAt(int row, const EcoRow &r)
+{
+    beginInsertRows(QModelIndex(), row, row);
+    m_rows.insert(row, r);
+    m_ecoIndex.insert(row, r.ecoNum, !r.isMinMax);
+    endInsertRows();
+    record(RowChange::Insert, row, EcoRow(), r);
+    notifyModified();
+}
+
+void EcoTableModel::removeRowAt(int row)
+{
     beginRemoveRows(QModelIndex(), row, row);
+    const EcoRow old = m_rows[row];
     m_rows.removeAt(row);
+    m_ecoIndex.remove(row);
     endRemoveRows();
-    emit dataModified();
+    record(RowChange::Remove, row, old, EcoRow());
+    notifyModified();
+}
+
+void EcoTableModel::replaceRow(int row, const EcoRow &r)
+{
+    record(RowChange::Replace, row, m_rows[row], r);
+    m_rows[row] = r;
+    m_ecoIndex.rename(row, r.ecoNum, !r.isMinMax);
+    notifyCells(row, 0, row, TOTAL_COLS - 1);
+    notifyModified();
+}
+
+// ── undo ──────────────────────────────────────────────────────────────────────
+void EcoTableModel::setUndoStack(QUndoStack *stack)
+{
+    m_undoPending.clear();
+    m_undoStack = stack;
+}
+
+void EcoTableModel::record(RowChange::Kind kind, int row, const EcoRow &before, const EcoRow &after)
+{
+    if (!m_undoStack || m_replaying) return;
+    m_undoPending.append({kind, row, before, after});
+    if (m_batchDepth == 0) flushUndo();
+}
+
+void EcoTableModel::flushUndo()
+{
+    if (!m_undoStack || m_undoPending.isEmpty()) return;
+    m_undoStack->push(new TableUndoCommand<EcoTableModel>(this, std::exchange(m_undoPending, {})));
+}
+
+void EcoTableModel::replayChanges(const QVector<RowChange> &changes, bool undo)
+{
+    m_replaying = true;
+    EditBatch batch(this);
+    const int n = changes.size();
+    for (int i = 0; i < n; ++i) {
+        const RowChange &c = changes[undo ? n - 1 - i : i];
+        switch (c.kind) {
+        case RowChange::Replace: replaceRow(c.row, undo ? c.before : c.after); break;
+        case RowChange::Insert:  undo ? removeRowAt(c.row) : insertRowAt(c.row, c.after); break;
+        case RowChange::Remove:  undo ? insertRowAt(c.row, c.before) : removeRowAt(c.row); break;
+        }
+    }
+    batch.commit();
+    m_replaying = false;
+}
+
+// ── columnar reads ────────────────────────────────────────────────────────────
+void EcoTableModel::textColumn(int col, int first, int count, QVector<QString> *out) const
+{
+    out->resize(count);
+    const int p = col - COL_PARAM0;
+    for (int i = 0; i < count; ++i) {
+        const EcoRow &row = m_rows[first + i];
+        QString &cell = (*out)[i];
+        switch (col) {
+        case COL_ECONUM:  cell = row.ecoNum;  break;
+        case COL_ECONAME: cell = row.ecoName; break;
+        case COL_MG:      cell = row.mg;      break;
+        case COL_TM:      cell = row.tm;      break;
+        case COL_REFS:    cell = QString::number(refCount(row)); break;
+        default:
+            cell = (p >= 0 && p < row.params.size() && row.params[p].has_value())
+                 ? QString::number(row.params[p].value()) : QString();
+        }
+    }
+}
+
+void EcoTableModel::numberColumn(int col, int first, int count, QVector<double> *values, QBitArray *present) const
+{
+    values->resize(count);
+    *present = QBitArray(count);
+    double *v = values->data();
+    if (col == COL_REFS) {
+        for (int i = 0; i < count; ++i)
+            v[i] = refCount(m_rows[first + i]);
+        present->fill(true);
+        return;
+    }
+    const int p = col - COL_PARAM0;
+    if (p < 0) return;
+    for (int i = 0; i < count; ++i) {
+        const QVector<std::optional<double>> &params = m_rows[first + i].params;
+        if (p < params.size() && params[p].has_value()) {
+            v[i] = params[p].value();
+            present->setBit(i);
+        } else {
+            v[i] = 0.0;
+        }
+    }
+}
+
+// ── batched edits ─────────────────────────────────────────────────────────────
+void EcoTableModel::beginBatch()
+{
+    ++m_batchDepth;
+}
+
+void EcoTableModel::commitBatch()
+{
+    if (m_batchDepth == 0 || --m_batchDepth > 0) return;
+    const QRect cells = m_batchCells.intersected(QRect(0, 0, TOTAL_COLS, m_rows.size()));
+    const bool modified = m_batchModified;
+    m_batchCells = QRect();
+    m_batchModified = false;
+    if (!cells.isEmpty())
+        emit dataChanged(index(cells.top(), cells.left()), index(cells.bottom(), cells.right()));
+    if (modified) emit dataModified();
+    flushUndo();
+}
+
+void EcoTableModel::notifyCells(int top, int left, int bottom, int right)
+{
+    if (bottom < top) return;
+    if (m_batchDepth > 0)
+        m_batchCells |= QRect(QPoint(left, top), QPoint(right, bottom));
+    else
+        emit dataChanged(index(top, left), index(bottom, right));
+}
+
+void EcoTableModel::notifyModified()
+{
+    ++m_generation;
+    if (m_batchDepth > 0)
+        m_batchModified = true;
+    else
+        emit dataModified();
 }
@@ -0,0 +1,155 @@
+#include "GlueConvergenceMonitor.h"
+#include "GlueOutputReader.h"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+QString GlueConvergenceCheck::summary() const
+{
+    if (bestSet < 0) return QString("%1 runs: no successful run yet").arg(runs);
+    QString s = QString("%1 runs: best set %2, ESS %3, max shift %4%")
+                    .arg(runs).arg(bestSet + 1)
+                    .arg(effectiveSampleSize, 0, 'f', 1)
+                    .arg(maxShift * 100, 0, 'f', 2);
+    if (!driftParam.isEmpty()) s += " (" + driftParam + ")";
+    if (converged) s += ", converged";
+    return s;
+}
+
+GlueConvergenceMonitor::GlueConvergenceMonitor(const GlueConvergenceOptions &options)
+    : m_options(options)
+{
+    m_options.batchSize    = qMax(1, m_options.batchSize);
+    m_options.stableChecks = qMax(1, m_options.stableChecks);
+    m_nextCheck = m_options.batchSize;
+}
+
+void GlueConvergenceMonitor::reset(const GlueParamMatrix &sets)
+{
+    m_sets = sets;
+    m_range.clear();
+    for (const std::vector<double> &col : sets.columns) {
+        if (col.empty()) { m_range << 0.0; continue; }
+        auto mm = std::minmax_element(col.begin(), col.end());
+        m_range << (*mm.second - *mm.first);
+    }
+    m_history.clear();
+    m_nextCheck = m_options.batchSize;
+}
+
+// ── check ─────────────────────────────────────────────────────────────────────
+const GlueConvergenceCheck &GlueConvergenceMonitor::check(const GlueEvalTable &table, int finishedRuns)
+{
+    GlueConvergenceCheck c;
+    c.runs = finishedRuns;
+    m_nextCheck = finishedRuns + m_options.batchSize;
+
+    GlueLikelihoodResult res = GlueLikelihood::evaluate(table, m_sets.sets);
+    if (!res.errorMsg.isEmpty()) {
+        m_history << c;
+        return m_history.last();
+    }
+    c.bestSet = res.bestSet;
+    c.effectiveSampleSize = res.effectiveSampleSize;
+    c.posterior = GlueLikelihood::posterior(m_sets, res);
+
+    const GlueConvergenceCheck *prev = nullptr;
+    if (!m_history.isEmpty() && m_history.last().bestSet >= 0) prev = &m_history.last();
+    if (prev && prev->posterior.size() == c.posterior.size()) {
+        double bestShift = 0;
+        for (int p = 0; p < c.posterior.size(); ++p) {
+            const double range = m_range.value(p);
+            if (range <= 0) continue;   // held fixed in this round
+            const double shift = std::fabs(c.posterior[p].mean - prev->posterior[p].mean) / range;
+            if (shift > c.maxShift) { c.maxShift = shift; c.driftParam = c.posterior[p].name; }
+            bestShift = qMax(bestShift, std::fabs(c.posterior[p].best - prev->posterior[p].best) / range);
+        }
+        // A new best set close to the old one still counts as stable
+        c.bestStable = c.bestSet == prev->bestSet || bestShift <= m_options.tolerance;
+        if (c.bestStable && c.maxShift <= m_options.tolerance)
+            c.stableCount = prev->stableCount + 1;
+        if (!c.bestStable && c.driftParam.isEmpty()) c.driftParam = "best set";
+    } else {
+        c.maxShift = 1.0;   // nothing to compare with yet
+    }
+    c.converged = finishedRuns >= m_options.minRuns && c.stableCount >= m_options.stableChecks;
+
+    m_history << c;
+    return m_history.last();
+}
+
+QString GlueConvergenceMonitor::verdict() const
+{
+    if (m_history.isEmpty()) return "not checked";
+    const GlueConvergenceCheck &last = m_history.last();
+    if (last.converged) {
+        // First check of the final stable streak
+        int at = m_history.size() - 1;
+        while (at > 0 && m_history[at - 1].converged) --at;
+        return QString("converged after %1 runs").arg(m_history[at].runs);
+    }
+    if (last.bestSet < 0) return "needs more runs (no successful run)";
+    return QString("needs more runs (%1 still moving %2% of its range between checks)")
+        .arg(last.driftParam.isEmpty() ? QString("posterior") : last.driftParam)
+        .arg(last.maxShift * 100, 0, 'f', 1);
+}
+
+// ── replay ────────────────────────────────────────────────────────────────────
+bool GlueConvergenceMonitor::replay(const QString &dir, int round, QString *errorMsg)
+{
+    GlueParamMatrix sets;
+    const QString setsPath = dir + "/" + GlueParamSampler::randomSetsFileName(round);
+    if (!GlueParamSampler::readRandomSets(setsPath, sets)) {
+        if (errorMsg) *errorMsg = "Cannot read " + setsPath;
+        return false;
+    }
+    GlueEvalTable table;
+    if (!GlueLikelihood::readTable(QString("%1/EvaluateFrame_%2.txt").arg(dir).arg(round), table, errorMsg))
+        return false;
+    const int runCol = table.column("RUN");
+    if (runCol < 0) {
+        if (errorMsg) *errorMsg = "Table has no RUN column";
+        return false;
+    }
+    reset(sets);
+
+    // Feed the rows in run order, checking at every batch boundary
+    const double *run = table.data[runCol].data();
+    auto runOf = [run](int r) { return std::isfinite(run[r]) ? run[r] : HUGE_VAL; };
+    std::vector<int> order(table.rows);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return runOf(a) < runOf(b); });
+    GlueEvalTable sofar;
+    sofar.columns = table.columns;
+    sofar.data.resize(table.columns.size());
+    int k = 0;
+    for (int runs = m_options.batchSize; ; runs += m_options.batchSize) {
+        runs = qMin(runs, sets.sets);
+        for (; k < table.rows && runOf(order[k]) <= runs; ++k) {
+            for (int c = 0; c < table.columns.size(); ++c)
+                sofar.data[c].push_back(table.data[c][order[k]]);
+            ++sofar.rows;
+        }
+        check(sofar, runs);
+        if (runs >= sets.sets) break;
+    }
+    return true;
+}
+
+QString GlueConvergenceMonitor::assessRun(const QString &dir, int runs, bool *needsMoreRuns)
+{
+    GlueConvergenceOptions opt;
+    opt.batchSize = qMax(10, runs / 10);
+    opt.minRuns   = 2 * opt.batchSize;
+    if (needsMoreRuns) *needsMoreRuns = false;
+
+    QStringList parts;
+    const QList<int> rounds = GlueOutputReader::availableRounds(dir);
+    for (int round : rounds) {
+        GlueConvergenceMonitor monitor(opt);
+        if (!monitor.replay(dir, round)) continue;
+        if (monitor.needsMoreRuns() && needsMoreRuns) *needsMoreRuns = true;
+        parts << (rounds.size() > 1 ? QString("Round %1: ").arg(round) : QString()) + monitor.verdict();
+    }
+    return parts.join("; ");
+}
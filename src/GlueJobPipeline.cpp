@@ -0,0 +1,587 @@
+#include "GlueJobPipeline.h"
+#include "GlueConvergenceMonitor.h"
+#include "GlueLogBuffer.h"
+#include "GlueResultCache.h"
+#include "GlueRWorker.h"
+#include "SimulationControl.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QSocketNotifier>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <csignal>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+static const int POLL_MS = 800;
+static const int KILL_GRACE_MS = 3000;   // SIGTERM, then SIGKILL to the R process
+
+// ── termination signals ───────────────────────────────────────────────────────
+// Handlers may only do async-signal-safe work: they write the signal number
+// to a socket (POSIX) or queue a call (Windows); cancel() runs on the event loop.
+static GlueJobPipeline *s_signalTarget = nullptr;
+
+#ifdef Q_OS_WIN
+static BOOL WINAPI consoleCtrlHandler(DWORD type)
+{
+    if (!s_signalTarget) return FALSE;
+    if (type != CTRL_C_EVENT && type != CTRL_BREAK_EVENT && type != CTRL_CLOSE_EVENT)
+        return FALSE;
+    QMetaObject::invokeMethod(s_signalTarget, "onSignalReceived", Qt::QueuedConnection);
+    if (type == CTRL_CLOSE_EVENT) Sleep(KILL_GRACE_MS);   // Windows ends us when this returns
+    return TRUE;
+}
+#else
+static int s_signalFd[2] = {-1, -1};
+
+static void terminationHandler(int sig)
+{
+    char c = char(sig);
+    ssize_t n = ::write(s_signalFd[0], &c, 1);
+    (void)n;
+}
+#endif
+
+GlueJobPipeline::GlueJobPipeline(QObject *parent)
+    : QObject(parent)
+{
+    m_pollTimer.setInterval(POLL_MS);
+    connect(&m_pollTimer, &QTimer::timeout, this, &GlueJobPipeline::poll);
+    m_snapshotPool.setMaxThreadCount(1);   // copies are disk bound; one at a time
+}
+
+GlueJobPipeline::~GlueJobPipeline()
+{
+    if (s_signalTarget == this) s_signalTarget = nullptr;
+    if (m_worker) m_worker->disconnect(this);   // its destructor stops R
+    for (Job *job : m_jobs) {
+        if (job->proc && job->proc->state() != QProcess::NotRunning) {
+            job->proc->disconnect(this);
+            killTree(job->proc);
+            job->proc->waitForFinished(KILL_GRACE_MS);
+        }
+#ifndef Q_OS_WIN
+        // DSSAT children outlive R when it dies first; the group is ours
+        if (job->pid > 0 && m_cancelled)
+            ::kill(-pid_t(job->pid), SIGKILL);
+#endif
+    }
+    m_snapshotPool.waitForDone();
+    qDeleteAll(m_jobs);
+}
+
+int GlueJobPipeline::addJob(const GlueJobSpec &spec)
+{
+    Job *j = new Job;
+    j->id   = m_jobs.size();
+    j->spec = spec;
+    m_jobs << j;
+    if (m_started) scheduleLater();
+    return j->id;
+}
+
+bool GlueJobPipeline::dropJob(int id)
+{
+    if (id < 0 || id >= m_jobs.size()) return false;
+    Job *job = m_jobs[id];
+    if (job->stage != GlueJobStage::Queued && job->stage != GlueJobStage::Prepared) return false;
+    job->stage = GlueJobStage::Dropped;
+    if (m_started) scheduleLater();
+    return true;
+}
+
+int GlueJobPipeline::pendingJobs() const
+{
+    int n = 0;
+    for (const Job *job : m_jobs)
+        if (job->stage == GlueJobStage::Queued || job->stage == GlueJobStage::Prepared) ++n;
+    return n;
+}
+
+GlueJobStage GlueJobPipeline::stage(int id) const
+{
+    return id >= 0 && id < m_jobs.size() ? m_jobs[id]->stage : GlueJobStage::Dropped;
+}
+
+void GlueJobPipeline::setProgram(const QString &program, const QStringList &arguments)
+{
+    m_program     = program;
+    m_programArgs = arguments;
+}
+
+void GlueJobPipeline::setResidentWorker(bool enabled)
+{
+    m_resident = enabled;
+    // A busy worker is released when its job is harvested
+    if (!enabled && m_worker && !m_worker->isBusy()) {
+        m_worker->shutdown();
+        m_worker->deleteLater();
+        m_worker = nullptr;
+    }
+}
+
+void GlueJobPipeline::catchTerminationSignals()
+{
+    s_signalTarget = this;
+#ifdef Q_OS_WIN
+    SetConsoleCtrlHandler(consoleCtrlHandler, TRUE);
+#else
+    if (s_signalFd[0] < 0 && ::socketpair(AF_UNIX, SOCK_STREAM, 0, s_signalFd) != 0) return;
+    delete m_signalNotifier;
+    m_signalNotifier = new QSocketNotifier(s_signalFd[1], QSocketNotifier::Read, this);
+    connect(m_signalNotifier, &QSocketNotifier::activated,
+            this, &GlueJobPipeline::onSignalReceived);
+
+    struct sigaction sa = {};
+    sa.sa_handler = terminationHandler;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    sigaction(SIGINT,  &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+#endif
+}
+
+void GlueJobPipeline::onSignalReceived()
+{
+#ifdef Q_OS_WIN
+    cancel("Ctrl+C");
+#else
+    char sig = 0;
+    if (::read(s_signalFd[1], &sig, 1) != 1) return;
+    cancel(sig == SIGINT ? "SIGINT" : "SIGTERM");
+#endif
+}
+
+// ── start ─────────────────────────────────────────────────────────────────────
+bool GlueJobPipeline::start(QString *errorMsg)
+{
+    if (m_started) return true;
+    if (pendingJobs() == 0) {
+        if (errorMsg) *errorMsg = "No GLUE jobs";
+        return false;
+    }
+    if (m_program.isEmpty()) {
+        m_program     = GlueRunner::findRTerm();
+        m_programArgs = {"--slave"};
+    }
+    if (m_jobs.size() > 1) m_forward = false;   // interleaved consoles are unreadable
+
+    m_started   = true;
+    m_cancelled = false;
+    m_failed    = 0;
+    m_pollTimer.start();
+    // From the event loop, so even an immediate failure reaches finished() listeners
+    scheduleLater();
+    return true;
+}
+
+void GlueJobPipeline::scheduleLater()
+{
+    if (m_scheduled) return;
+    m_scheduled = true;
+    QMetaObject::invokeMethod(this, [this] {
+        m_scheduled = false;
+        schedule();
+    }, Qt::QueuedConnection);
+}
+
+// Launch what fits, prepare what comes next, report when drained
+void GlueJobPipeline::schedule()
+{
+    if (!m_started) return;
+    const bool shared = m_layout == SharedLayout;
+    const int slots = (shared || m_resident) ? 1 : m_concurrency;
+
+    auto fail = [this](Job &job, const QString &err) {
+        job.stage = GlueJobStage::Done;
+        job.result.errorMsg = err;
+        ++m_failed;
+        emitEvent("finished", &job, {{"status", "failed"}, {"error", err}});
+        emit jobFinished(job.id, job.result);
+    };
+
+    // By index: listeners may add jobs from the signals emitted below
+    for (int i = 0; i < m_jobs.size(); ++i) {
+        Job *job = m_jobs[i];
+        if (m_cancelled || m_active >= slots) break;
+        if (job->stage != GlueJobStage::Queued && job->stage != GlueJobStage::Prepared) continue;
+        // The shared work dir belongs to the last job until its snapshot is taken
+        if (shared && m_copying > 0) break;
+        if (m_resident && m_worker && m_worker->isBusy()) break;
+        QString err;
+        if (job->stage == GlueJobStage::Queued && !prepare(*job, &err)) {
+            fail(*job, err);
+            continue;
+        }
+        launch(*job);
+    }
+
+    // Sandboxes of the next jobs are written while the current ones run
+    if (!shared && !m_cancelled) {
+        int ahead = 0;
+        for (int i = 0; i < m_jobs.size(); ++i) {
+            Job *job = m_jobs[i];
+            if (ahead >= m_concurrency) break;
+            if (job->stage == GlueJobStage::Prepared) { ++ahead; continue; }
+            if (job->stage != GlueJobStage::Queued) continue;
+            QString err;
+            if (prepare(*job, &err)) {
+                job->stage = GlueJobStage::Prepared;
+                ++ahead;
+            } else {
+                fail(*job, err);
+            }
+        }
+    }
+
+    if (m_active == 0 && m_copying == 0 && (m_cancelled || pendingJobs() == 0)) {
+        m_started = false;
+        m_pollTimer.stop();
+        const int code = m_cancelled ? 130 : (m_failed > 0 ? 1 : 0);
+        emitEvent("done", nullptr, {{"jobs", m_jobs.size()}, {"failed", m_failed},
+                                    {"cancelled", m_cancelled}, {"exitCode", code}});
+        emit finished(code);
+    }
+}
+
+// ── prepare ───────────────────────────────────────────────────────────────────
+bool GlueJobPipeline::prepare(Job &job, QString *errorMsg)
+{
+    const GlueJobSpec &s = job.spec;
+    if (m_layout == SharedLayout) {
+        job.runDir         = GlueRunner::GLUE_DIR;
+        job.result.workDir = GlueRunner::GLUE_WORK;
+        if (GlueRunner::writeBatchFile(s.cropInfo, s.cultivarId, s.cultivarName, s.treatments).isEmpty()) {
+            if (errorMsg) *errorMsg = "Cannot write batch file to " + GlueRunner::GLUE_WORK;
+            return false;
+        }
+        return GlueRunner::updateSimControl(s.cropInfo, s.cultivarId, s.runs, s.glueFlag, s.ecoCalib,
+                                            QString(), errorMsg);
+    }
+
+    // The job id keeps two entries for one cultivar apart: the sandbox is
+    // wiped first, and the other one may be running in its own
+    job.runDir = QString("%1/Jobs/%2_%3_%4").arg(GlueRunner::GLUE_WORK, s.cropInfo.cropCode,
+                                                  s.cultivarId.trimmed()).arg(job.id);
+    job.result.workDir = job.runDir;
+    for (const Job *other : std::as_const(m_jobs)) {
+        if (other != &job && other->result.launched && other->stage != GlueJobStage::Done &&
+            other->runDir == job.runDir) {
+            if (errorMsg) *errorMsg = job.runDir + " is in use by a running job";
+            return false;
+        }
+    }
+    QDir(job.runDir).removeRecursively();
+    if (!QDir().mkpath(job.runDir)) {
+        if (errorMsg) *errorMsg = "Cannot create " + job.runDir;
+        return false;
+    }
+    if (GlueRunner::writeBatchFile(s.cropInfo, s.cultivarId, s.cultivarName, s.treatments,
+                                   job.runDir).isEmpty()) {
+        if (errorMsg) *errorMsg = "Cannot write batch file to " + job.runDir;
+        return false;
+    }
+    SimulationControl sc;
+    if (!SimulationControl::cached(GlueRunner::GLUE_DIR + "/SimulationControl.csv", sc, errorMsg))
+        return false;
+    sc.configureJob(s.cropInfo, s.cultivarId, s.runs, s.glueFlag, s.ecoCalib);
+    sc.outputDir = QDir::toNativeSeparators(job.runDir);
+    QStringList problems = sc.validate();
+    if (!problems.isEmpty()) {
+        if (errorMsg) *errorMsg = problems.join("\n");
+        return false;
+    }
+    return sc.writeTo(job.runDir + "/SimulationControl.csv", errorMsg);
+}
+
+// ── launch ────────────────────────────────────────────────────────────────────
+void GlueJobPipeline::launch(Job &job)
+{
+    job.stage = GlueJobStage::Running;
+    job.result.launched = true;
+    ++m_active;
+    job.progress = GlueProgress();
+    job.sampler  = GlueResourceSampler();
+    if (!job.log) {
+        job.log = job.spec.log;
+        if (!job.log) {
+            job.log = new GlueLogBuffer(200, this);
+            job.log->setWatchPatterns({"error occurred", "cannot open", "Error in "});
+        }
+    }
+    if (!m_forward)
+        job.log->reset(GlueLogBuffer::jobLogPath(job.spec.cropInfo.cropCode, job.spec.cultivarId));
+    job.result.logFile = job.log->filePath();
+    const QString script = GlueRunner::GLUE_DIR + "/GLUE.r";
+    const int id = job.id;
+
+    QJsonObject fields{{"runs", job.spec.runs},
+                       {"glueFlag", job.spec.glueFlag},
+                       {"dir", QDir::toNativeSeparators(job.result.workDir)}};
+    if (!job.result.logFile.isEmpty())
+        fields["log"] = QDir::toNativeSeparators(job.result.logFile);
+
+    if (m_resident) {
+        if (!m_worker) {
+            m_worker = new GlueRWorker(this);
+            connect(m_worker, &GlueRWorker::jobStarted, this, [this](qint64 pid) {
+                if (m_workerJob >= 0) m_jobs[m_workerJob]->sampler.start(pid);
+            });
+            connect(m_worker, &GlueRWorker::outputReceived, this, [this](const QByteArray &data, bool err) {
+                if (m_workerJob >= 0) m_jobs[m_workerJob]->log->append(data, err);
+            });
+            connect(m_worker, &GlueRWorker::jobFinished, this, [this](int code, const QString &message) {
+                if (m_workerJob >= 0) harvest(*m_jobs[m_workerJob], code, QProcess::NormalExit, message);
+            });
+        }
+        m_workerJob = id;
+        job.wall.start();
+        emitEvent("start", &job, fields);
+        emit jobStarted(id);
+        // The shared layout keeps R in GLUE_DIR, as a spawned Rscript would be
+        m_worker->submit(script, m_layout == SharedLayout ? QString() : job.runDir);
+        return;
+    }
+
+    job.proc = new QProcess(this);
+    job.proc->setWorkingDirectory(job.runDir);
+    if (m_forward) {
+        job.proc->setProcessChannelMode(QProcess::ForwardedChannels);
+    } else {
+        QProcess *p = job.proc;
+        GlueLogBuffer *log = job.log;
+        connect(p, &QProcess::readyReadStandardOutput, log,
+                [p, log] { log->append(p->readAllStandardOutput(), false); });
+        connect(p, &QProcess::readyReadStandardError, log,
+                [p, log] { log->append(p->readAllStandardError(), true); });
+    }
+#ifndef Q_OS_WIN
+    // Own process group, so cancel() reaches the DSSAT runs R spawns
+    job.proc->setChildProcessModifier([] { ::setpgid(0, 0); });
+#endif
+    connect(job.proc, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, [this, id](int code, QProcess::ExitStatus st) { harvest(*m_jobs[id], code, st); });
+    connect(job.proc, &QProcess::errorOccurred, this, [this, id](QProcess::ProcessError e) {
+        if (e == QProcess::FailedToStart) harvest(*m_jobs[id], -1, QProcess::CrashExit);
+    });
+
+    job.wall.start();
+    // Before start(): a program that cannot start is harvested inside it
+    emit jobStarted(id);
+    job.proc->start(m_program, m_programArgs + QStringList{"--file=" + script});
+    if (job.proc->state() == QProcess::NotRunning) return;   // reported via errorOccurred
+    job.pid = job.proc->processId();
+    job.sampler.start(job.pid);
+    fields["pid"] = job.pid;
+    emitEvent("start", &job, fields);
+}
+
+// ── monitor ───────────────────────────────────────────────────────────────────
+void GlueJobPipeline::poll()
+{
+    for (Job *job : m_jobs) {
+        if (job->stage != GlueJobStage::Running) continue;
+        job->sampler.sample();
+        if (GlueRunner::readProgress(job->result.workDir + "/ModelRunIndicator.txt", job->progress)) {
+            job->sampler.markPhase(QString("Round %1 — %2").arg(job->progress.round + 1)
+                                                          .arg(job->progress.label));
+            emitEvent("progress", job, {{"round", job->progress.round + 1},
+                                        {"percent", job->progress.percent},
+                                        {"phase", job->progress.label}});
+            emit jobProgress(job->id, job->progress);
+        }
+        job->result.resources = job->sampler.usage();
+    }
+}
+
+// ── harvest ───────────────────────────────────────────────────────────────────
+void GlueJobPipeline::harvest(Job &job, int exitCode, QProcess::ExitStatus status, const QString &message)
+{
+    if (job.stage != GlueJobStage::Running) return;
+    job.stage = GlueJobStage::Harvested;
+    --m_active;
+    if (m_workerJob == job.id) m_workerJob = -1;
+
+    if (job.proc && !m_forward) {
+        job.log->append(job.proc->readAllStandardOutput(), false);
+        job.log->append(job.proc->readAllStandardError(), true);
+    }
+    if (!message.isEmpty()) job.log->appendLine(message, true);
+    job.log->flush();
+
+    GlueJobResult &r = job.result;
+    r.resources   = job.sampler.finish();
+    r.exitCode    = exitCode;
+    r.cancelled   = m_cancelled;
+    r.wallSeconds = job.wall.elapsed() / 1000.0;
+    r.ok = !m_cancelled && status == QProcess::NormalExit && exitCode == 0 && !job.log->watchMatched();
+
+    // GLUE writes <module>.CUL (the full crop file) with the calibrated line inside
+    QFile cf(r.workDir + "/" + job.spec.cropInfo.module + ".CUL");
+    if (cf.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        for (const QString &line : QString::fromLatin1(cf.readAll()).split('\n')) {
+            if (line.startsWith(job.spec.cultivarId, Qt::CaseInsensitive)) {
+                r.culLine = line.trimmed();
+                break;
+            }
+        }
+    }
+
+    QJsonObject fields{{"status", m_cancelled ? "cancelled" : r.ok ? "ok" : "failed"},
+                       {"exitCode", exitCode},
+                       {"wallSeconds", r.wallSeconds}};
+    fields["resources"] = r.resources.summary();
+    if (r.resources.available) {
+        fields["cpuSeconds"] = r.resources.cpuSeconds;
+        fields["peakRssKb"]  = r.resources.peakRssKb;
+    }
+    if (!r.logFile.isEmpty())
+        fields["log"] = QDir::toNativeSeparators(r.logFile);
+    if (!r.culLine.isEmpty())
+        fields["cul"] = r.culLine;
+    if (!r.ok) {
+        ++m_failed;
+        const QStringList tail = job.log->tail(40, true);
+        if (job.proc && status == QProcess::CrashExit && exitCode == -1 &&
+            job.proc->error() == QProcess::FailedToStart) {
+            r.errorMsg = "Cannot start " + m_program;
+            fields["error"] = r.errorMsg;
+        } else {
+            r.errorMsg = QString("Exit code %1").arg(exitCode);
+            if (!tail.isEmpty()) r.errorMsg += "\n\n" + tail.join('\n').trimmed();
+            fields["errors"] = QJsonArray::fromStringList(tail.mid(qMax(0, tail.size() - 20)));
+        }
+    }
+    emitEvent("finished", &job, fields);
+
+    if (m_worker && !m_resident && !m_worker->isBusy()) {
+        m_worker->shutdown();
+        m_worker->deleteLater();
+        m_worker = nullptr;
+    }
+
+    emit jobFinished(job.id, r);
+    // Queued ahead of the snapshot on the same pool, so both read the work dir
+    // before the shared layout hands it to the next job
+    if (r.ok)
+        assess(job);
+    if (!job.spec.snapshotDir.isEmpty() && !m_cancelled)
+        snapshot(job);
+    else
+        job.stage = GlueJobStage::Done;
+    // Start the next job from the event loop, not inside QProcess's signal
+    scheduleLater();
+}
+
+// ── assess ────────────────────────────────────────────────────────────────────
+// Reading every round's RealizedParams and EvaluateFrame takes seconds for a
+// large run; the verdict follows the "finished" event
+void GlueJobPipeline::assess(Job &job)
+{
+    ++m_copying;
+    const int id = job.id, runs = job.spec.runs;
+    const QString dir = job.result.workDir;
+    m_snapshotPool.start([this, id, runs, dir] {
+        bool needsMoreRuns = false;
+        const QString verdict = GlueConvergenceMonitor::assessRun(dir, runs, &needsMoreRuns);
+        QMetaObject::invokeMethod(this, [this, id, verdict, needsMoreRuns] {
+            onAssessed(id, verdict, needsMoreRuns);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void GlueJobPipeline::onAssessed(int id, const QString &convergence, bool needsMoreRuns)
+{
+    --m_copying;
+    Job &job = *m_jobs[id];
+    job.result.convergence   = convergence;
+    job.result.needsMoreRuns = needsMoreRuns;
+    if (!convergence.isEmpty())
+        emitEvent("convergence", &job, {{"convergence", convergence}, {"needsMoreRuns", needsMoreRuns}});
+    emit jobAssessed(id, job.result);
+    scheduleLater();
+}
+
+// ── snapshot ──────────────────────────────────────────────────────────────────
+void GlueJobPipeline::snapshot(Job &job)
+{
+    ++m_copying;
+    const int id = job.id;
+    const QString src = job.result.workDir, dst = job.spec.snapshotDir, logFile = job.result.logFile;
+    m_snapshotPool.start([this, id, src, dst, logFile] {
+        bool ok = QDir().mkpath(dst);
+        // A partial copy must never be served from the result cache
+        GlueResultCache::invalidate(dst);
+        // Not recursive: the shared GLWork holds BackUp/ and Jobs/
+        QDirIterator it(src, QDir::Files | QDir::NoSymLinks, QDirIterator::NoIteratorFlags);
+        while (ok && it.hasNext()) {
+            const QString file = it.next();
+            const QString to = dst + "/" + QFileInfo(file).fileName();
+            QFile::remove(to);
+            ok = QFile::copy(file, to);
+        }
+        if (ok && !logFile.isEmpty()) {
+            QFile::remove(dst + "/GlueRun.log");
+            QFile::copy(logFile, dst + "/GlueRun.log");
+        }
+        QMetaObject::invokeMethod(this, [this, id, ok] { onSnapshotDone(id, ok); }, Qt::QueuedConnection);
+    });
+}
+
+void GlueJobPipeline::onSnapshotDone(int id, bool ok)
+{
+    --m_copying;
+    Job &job = *m_jobs[id];
+    job.stage = GlueJobStage::Done;
+    emitEvent("snapshot", &job, {{"dir", QDir::toNativeSeparators(job.spec.snapshotDir)}, {"ok", ok}});
+    emit jobSnapshotted(id, ok);
+    scheduleLater();
+}
+
+// ── cancel ────────────────────────────────────────────────────────────────────
+void GlueJobPipeline::cancel(const QString &reason)
+{
+    if (m_cancelled || !m_started) return;
+    m_cancelled = true;
+    emitEvent("cancel", nullptr, {{"reason", reason}});
+    for (Job *job : m_jobs) {
+        if (job->stage == GlueJobStage::Queued || job->stage == GlueJobStage::Prepared)
+            job->stage = GlueJobStage::Dropped;
+        else if (job->stage == GlueJobStage::Running && job->proc &&
+                 job->proc->state() != QProcess::NotRunning)
+            killTree(job->proc);
+    }
+    if (m_worker && m_worker->isBusy())
+        m_worker->abort();   // reports the job through GlueRWorker::jobFinished
+    scheduleLater();
+}
+
+void GlueJobPipeline::killTree(QProcess *proc)
+{
+    const qint64 pid = proc->processId();
+    if (pid <= 0) return;
+#ifdef Q_OS_WIN
+    QProcess::execute("taskkill", {"/T", "/F", "/PID", QString::number(pid)});
+#else
+    ::kill(-pid_t(pid), SIGTERM);
+    QTimer::singleShot(KILL_GRACE_MS, proc, [proc, pid] {
+        if (proc->state() != QProcess::NotRunning) ::kill(-pid_t(pid), SIGKILL);
+    });
+#endif
+}
+
+void GlueJobPipeline::emitEvent(const QString &type, const Job *job, QJsonObject fields)
+{
+    fields["event"] = type;
+    if (job) {
+        fields["job"]  = job->spec.cultivarId.trimmed();
+        fields["crop"] = job->spec.cropInfo.cropCode;
+    }
+    emit event(fields);
+}
@@ -0,0 +1,323 @@
+#include "GlueLikelihood.h"
+#include "GlueOutputReader.h"
+#include <QFile>
+#include <QTextStream>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+static const double NEG_INF = -std::numeric_limits<double>::infinity();
+static const double TWO_PI  = 6.283185307179586;
+
+static inline bool isMissing(double v)
+{
+    return !std::isfinite(v) || std::fabs(v - GlueLikelihood::MISSING) < 0.5;
+}
+
+// Simulated/measured pairs: <stem>S and <stem>M
+static QStringList pairedStems(const QStringList &columns, const QStringList &variables)
+{
+    QStringList stems;
+    for (const QString &c : columns) {
+        if (c.size() < 2 || !c.endsWith('S')) continue;
+        QString stem = c.chopped(1);
+        if (!columns.contains(stem + "M")) continue;
+        if (variables.isEmpty() || variables.contains(stem, Qt::CaseInsensitive))
+            stems << stem;
+    }
+    return stems;
+}
+
+// Error SD from the spread of the observations, so variables with
+// different units carry comparable weight
+static double errorSd(double sum, double sumSq, int count)
+{
+    double mean = sum / count;
+    double var  = count > 1 ? qMax(0.0, (sumSq - count * mean * mean) / (count - 1)) : 0.0;
+    double sd   = std::sqrt(var);
+    if (sd <= 1e-9 * qMax(1.0, std::fabs(mean)))
+        sd = std::fabs(mean) > 0 ? 0.1 * std::fabs(mean) : 1.0;
+    return sd;
+}
+
+// Zero weight for sets that never ran or failed, then log-sum-exp weights
+static void normalizeWeights(GlueLikelihoodResult &res, const std::vector<char> &seen,
+                             const std::vector<char> &failed)
+{
+    const int sets = int(res.logLikelihood.size());
+    double maxLL = NEG_INF;
+    for (int s = 0; s < sets; ++s) {
+        if (!seen[s] || failed[s]) res.logLikelihood[s] = NEG_INF;
+        if (res.logLikelihood[s] > maxLL) { maxLL = res.logLikelihood[s]; res.bestSet = s; }
+    }
+    if (res.bestSet < 0) { res.errorMsg = "Every model run failed"; return; }
+
+    res.weights.resize(sets);
+    double total = 0;
+    for (int s = 0; s < sets; ++s) {
+        res.weights[s] = std::exp(res.logLikelihood[s] - maxLL);
+        total += res.weights[s];
+    }
+    double sumSq = 0;
+    for (double &w : res.weights) { w /= total; sumSq += w * w; }
+    res.effectiveSampleSize = sumSq > 0 ? 1.0 / sumSq : 0.0;
+}
+
+int GlueEvalTable::column(const QString &name) const
+{
+    return columns.indexOf(name);
+}
+
+// ── readTable ─────────────────────────────────────────────────────────────────
+bool GlueLikelihood::readTable(const QString &filePath, GlueEvalTable &table, QString *errorMsg)
+{
+    table = GlueEvalTable();
+    QFile f(filePath);
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (errorMsg) *errorMsg = "Cannot open " + filePath;
+        return false;
+    }
+
+    appendRows(table, f.readAll());
+    if (table.columns.isEmpty()) {
+        if (errorMsg) *errorMsg = "No header line in " + filePath;
+        return false;
+    }
+    return true;
+}
+
+void GlueLikelihood::appendRows(GlueEvalTable &table, const QByteArray &text)
+{
+    const QList<QByteArray> lines = text.split('\n');
+    for (const QByteArray &raw : lines) {
+        QByteArray line = raw.simplified();
+        if (line.isEmpty() || line.startsWith('*') || line.startsWith('!')) continue;
+        const QList<QByteArray> tok = line.split(' ');
+
+        if (table.columns.isEmpty()) {
+            for (QByteArray t : tok) {
+                if (t.startsWith('@')) t.remove(0, 1);
+                if (!t.isEmpty()) table.columns << QString::fromLatin1(t).toUpper();
+            }
+            table.data.resize(table.columns.size());
+            continue;
+        }
+        if (line.startsWith('@')) continue;   // repeated header between runs
+
+        // Text columns (EXCODE, CR) become NaN; short rows are padded as missing
+        for (int c = 0; c < table.columns.size(); ++c) {
+            bool ok = false;
+            double v = c < tok.size() ? tok[c].toDouble(&ok) : MISSING;
+            table.data[c].push_back(ok || c >= tok.size() ? v : std::numeric_limits<double>::quiet_NaN());
+        }
+        ++table.rows;
+    }
+}
+
+// ── evaluate ──────────────────────────────────────────────────────────────────
+GlueLikelihoodResult GlueLikelihood::evaluate(const GlueEvalTable &table, int sets,
+                                              const QStringList &variables)
+{
+    GlueLikelihoodResult res;
+    const int runCol = table.column("RUN");
+    if (runCol < 0) { res.errorMsg = "Table has no RUN column"; return res; }
+    if (sets <= 0)  { res.errorMsg = "No parameter sets"; return res; }
+
+    const QStringList stems = pairedStems(table.columns, variables);
+    if (stems.isEmpty()) { res.errorMsg = "No simulated/measured column pairs"; return res; }
+
+    const int n = table.rows;
+    std::vector<int> setOf(n);
+    std::vector<char> seen(sets, 0);
+    for (int r = 0; r < n; ++r) {
+        double run = table.data[runCol][r];
+        int s = std::isfinite(run) ? int(std::lround(run)) - 1 : -1;
+        setOf[r] = (s >= 0 && s < sets) ? s : -1;
+        if (setOf[r] >= 0) seen[setOf[r]] = 1;
+    }
+
+    res.logLikelihood.assign(sets, 0.0);
+    std::vector<char> failed(sets, 0);
+    std::vector<double> contrib(n);
+    std::vector<char> valid(n), broken(n);
+
+    for (const QString &stem : stems) {
+        const double *sim = table.data[table.column(stem + "S")].data();
+        const double *obs = table.data[table.column(stem + "M")].data();
+
+        double sum = 0, sumSq = 0;
+        int count = 0;
+        for (int r = 0; r < n; ++r) {
+            valid[r] = !isMissing(obs[r]) && setOf[r] >= 0;
+            if (!valid[r]) continue;
+            sum += obs[r]; sumSq += obs[r] * obs[r]; ++count;
+        }
+        if (count == 0) continue;
+        const double sd = errorSd(sum, sumSq, count);
+
+        const double invVar  = 1.0 / (sd * sd);
+        const double logNorm = 0.5 * std::log(TWO_PI * sd * sd);
+
+        // Branch-free pass over the columns, then scatter into the sets
+        for (int r = 0; r < n; ++r) {
+            const double d = sim[r] - obs[r];
+            broken[r]  = valid[r] && isMissing(sim[r]);
+            contrib[r] = (valid[r] && !broken[r]) ? (-0.5 * d * d * invVar - logNorm) : 0.0;
+        }
+        for (int r = 0; r < n; ++r) {
+            if (setOf[r] < 0) continue;
+            res.logLikelihood[setOf[r]] += contrib[r];
+            failed[setOf[r]] |= broken[r];
+        }
+
+        res.variables << stem;
+        res.sigma << sd;
+    }
+    if (res.variables.isEmpty()) { res.errorMsg = "No observed values in the table"; return res; }
+
+    // Runs that crashed (no output or missing simulated values) get zero weight
+    normalizeWeights(res, seen, failed);
+    return res;
+}
+
+// ── evaluateFile ──────────────────────────────────────────────────────────────
+GlueLikelihoodResult GlueLikelihood::evaluateFile(const QString &filePath, int sets,
+                                                  const QStringList &variables)
+{
+    GlueLikelihoodResult res;
+    GlueTableStream table;
+    if (!table.open(filePath, &res.errorMsg)) return res;
+    const int runCol = table.column("RUN");
+    if (runCol < 0) { res.errorMsg = "Table has no RUN column"; return res; }
+    if (sets <= 0)  { res.errorMsg = "No parameter sets"; return res; }
+
+    const QStringList stems = pairedStems(table.columns(), variables);
+    if (stems.isEmpty()) { res.errorMsg = "No simulated/measured column pairs"; return res; }
+    const int nv = stems.size();
+    std::vector<int> simCol(nv), obsCol(nv), count(nv, 0);
+    std::vector<double> sum(nv, 0.0), sumSq(nv, 0.0);
+    for (int v = 0; v < nv; ++v) {
+        simCol[v] = table.column(stems[v] + "S");
+        obsCol[v] = table.column(stems[v] + "M");
+    }
+    auto setOfRow = [&]() {
+        const double run = table.value(runCol);
+        const int s = std::isfinite(run) ? int(std::lround(run)) - 1 : -1;
+        return (s >= 0 && s < sets) ? s : -1;
+    };
+
+    // Pass 1: which sets ran, and the spread of each variable's observations
+    std::vector<char> seen(sets, 0);
+    while (table.next()) {
+        const int s = setOfRow();
+        if (s < 0) continue;
+        seen[s] = 1;
+        for (int v = 0; v < nv; ++v) {
+            const double obs = table.value(obsCol[v]);
+            if (isMissing(obs)) continue;
+            sum[v] += obs; sumSq[v] += obs * obs; ++count[v];
+        }
+    }
+    std::vector<double> invVar(nv, 0.0), logNorm(nv, 0.0);
+    for (int v = 0; v < nv; ++v) {
+        if (count[v] == 0) continue;
+        const double sd = errorSd(sum[v], sumSq[v], count[v]);
+        invVar[v]  = 1.0 / (sd * sd);
+        logNorm[v] = 0.5 * std::log(TWO_PI * sd * sd);
+        res.variables << stems[v];
+        res.sigma << sd;
+    }
+    if (res.variables.isEmpty()) { res.errorMsg = "No observed values in the table"; return res; }
+
+    // Pass 2: Gaussian log-densities summed per set
+    res.logLikelihood.assign(sets, 0.0);
+    std::vector<char> failed(sets, 0);
+    table.rewind();
+    while (table.next()) {
+        const int s = setOfRow();
+        if (s < 0) continue;
+        for (int v = 0; v < nv; ++v) {
+            const double obs = table.value(obsCol[v]);
+            if (count[v] == 0 || isMissing(obs)) continue;
+            const double sim = table.value(simCol[v]);
+            if (isMissing(sim)) { failed[s] = 1; continue; }
+            const double d = sim - obs;
+            res.logLikelihood[s] += -0.5 * d * d * invVar[v] - logNorm[v];
+        }
+    }
+    normalizeWeights(res, seen, failed);
+    return res;
+}
+
+// ── posterior ─────────────────────────────────────────────────────────────────
+QVector<GlueParamPosterior> GlueLikelihood::posterior(const GlueParamMatrix &paramSets,
+                                                      const GlueLikelihoodResult &result)
+{
+    QVector<GlueParamPosterior> out;
+    const int sets = qMin(paramSets.sets, int(result.weights.size()));
+    if (sets <= 0 || result.bestSet < 0 || result.bestSet >= sets) return out;
+
+    const double *w = result.weights.data();
+    std::vector<int> order(sets);
+    for (int p = 0; p < paramSets.names.size(); ++p) {
+        const double *x = paramSets.columns[p].data();
+        GlueParamPosterior st;
+        st.name = paramSets.names[p];
+        st.best = x[result.bestSet];
+
+        double mean = 0;
+        for (int i = 0; i < sets; ++i) mean += w[i] * x[i];
+        double var = 0;
+        for (int i = 0; i < sets; ++i) { double d = x[i] - mean; var += w[i] * d * d; }
+        st.mean = mean;
+        st.sd   = std::sqrt(var);
+
+        // Weighted quantiles from the cumulative weight of the sorted values
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [x](int a, int b) { return x[a] < x[b]; });
+        double cum = 0;
+        bool has05 = false, has50 = false, has95 = false;
+        for (int k = 0; k < sets; ++k) {
+            cum += w[order[k]];
+            double v = x[order[k]];
+            if (!has05 && cum >= 0.05) { st.q05 = v; has05 = true; }
+            if (!has50 && cum >= 0.50) { st.median = v; has50 = true; }
+            if (!has95 && cum >= 0.95) { st.q95 = v; has95 = true; break; }
+        }
+        if (!has95) st.q95 = x[order[sets - 1]];
+        if (!has50) st.median = st.q95;
+        if (!has05) st.q05 = st.median;
+        out << st;
+    }
+    return out;
+}
+
+// ── writeReport ───────────────────────────────────────────────────────────────
+bool GlueLikelihood::writeReport(const QString &filePath,
+                                 const GlueLikelihoodResult &result,
+                                 const QVector<GlueParamPosterior> &stats)
+{
+    QFile f(filePath);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) return false;
+    QTextStream out(&f);
+
+    QStringList vars;
+    for (int i = 0; i < result.variables.size(); ++i)
+        vars << QString("%1 (sigma %2)").arg(result.variables[i]).arg(result.sigma[i], 0, 'g', 4);
+    out << "! GLUE posterior: " << result.weights.size() << " parameter sets, effective sample size "
+        << QString::number(result.effectiveSampleSize, 'f', 1) << "\n";
+    out << "! Variables: " << vars.join(", ") << "\n";
+    out << "@MAXPROB_SET " << (result.bestSet + 1) << "  LOG_LIKELIHOOD "
+        << QString::number(result.bestSet >= 0 ? result.logLikelihood[result.bestSet] : 0.0, 'f', 4)
+        << "\n";
+    out << QString("@%1%2%3%4%5%6%7\n").arg("PARAM", -9)
+               .arg("BEST", 12).arg("MEAN", 12).arg("SD", 12)
+               .arg("Q05", 12).arg("MEDIAN", 12).arg("Q95", 12);
+    for (const GlueParamPosterior &s : stats) {
+        out << QString(" %1%2%3%4%5%6%7\n").arg(s.name, -9)
+                   .arg(s.best, 12, 'g', 6).arg(s.mean, 12, 'g', 6).arg(s.sd, 12, 'g', 6)
+                   .arg(s.q05, 12, 'g', 6).arg(s.median, 12, 'g', 6).arg(s.q95, 12, 'g', 6);
+    }
+    return out.status() == QTextStream::Ok;
+}
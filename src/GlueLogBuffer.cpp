@@ -0,0 +1,153 @@
+#include "GlueLogBuffer.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+static const int MAX_JOB_LOGS = 100;
+
+GlueLogBuffer::GlueLogBuffer(int capacity, QObject *parent)
+    : QObject(parent)
+    , m_capacity(qMax(1, capacity))
+{
+}
+
+GlueLogBuffer::~GlueLogBuffer()
+{
+    flush();
+}
+
+bool GlueLogBuffer::reset(const QString &filePath)
+{
+    flush();
+    m_file.close();
+    m_file.setFileName(QString());
+    m_ring.clear();
+    m_total = 0;
+    m_partialOut.clear();
+    m_partialErr.clear();
+    m_watchMatched = false;
+    emit linesAppended();
+
+    if (filePath.isEmpty()) return true;
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    m_file.setFileName(filePath);
+    return m_file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text);
+}
+
+// ── appending ─────────────────────────────────────────────────────────────────
+void GlueLogBuffer::push(const QString &text, bool isError)
+{
+    if (m_file.isOpen()) {
+        m_file.write(text.toUtf8());
+        m_file.write("\n");
+    }
+    for (const QString &p : m_watch)
+        if (!m_watchMatched && text.contains(p, Qt::CaseInsensitive)) m_watchMatched = true;
+
+    Entry e;
+    e.text  = text.size() > MAX_LINE_LENGTH ? text.left(MAX_LINE_LENGTH) + QChar(0x2026) : text;
+    e.error = isError;
+    if (int(m_ring.size()) < m_capacity)
+        m_ring.push_back(std::move(e));
+    else
+        m_ring[m_total % m_capacity] = std::move(e);
+    ++m_total;
+}
+
+void GlueLogBuffer::splitLines(QByteArray &pending, const QByteArray &data, bool isError)
+{
+    pending += data;
+    int start = 0, nl;
+    while ((nl = pending.indexOf('\n', start)) >= 0) {
+        int end = nl;
+        if (end > start && pending[end - 1] == '\r') --end;
+        push(QString::fromLocal8Bit(pending.constData() + start, end - start), isError);
+        start = nl + 1;
+    }
+    pending.remove(0, start);
+    // A runaway line without newline is flushed rather than grown forever
+    if (pending.size() > 64 * 1024) {
+        push(QString::fromLocal8Bit(pending), isError);
+        pending.clear();
+    }
+}
+
+void GlueLogBuffer::append(const QByteArray &data, bool isError)
+{
+    if (data.isEmpty()) return;
+    const qint64 before = m_total;
+    splitLines(isError ? m_partialErr : m_partialOut, data, isError);
+    if (m_total != before) emit linesAppended();
+}
+
+void GlueLogBuffer::appendLine(const QString &line, bool isError)
+{
+    for (const QString &l : line.split('\n'))
+        push(l, isError);
+    emit linesAppended();
+}
+
+void GlueLogBuffer::flush()
+{
+    const bool any = !m_partialOut.isEmpty() || !m_partialErr.isEmpty();
+    if (!m_partialOut.isEmpty()) push(QString::fromLocal8Bit(m_partialOut), false);
+    if (!m_partialErr.isEmpty()) push(QString::fromLocal8Bit(m_partialErr), true);
+    m_partialOut.clear();
+    m_partialErr.clear();
+    if (m_file.isOpen()) m_file.flush();
+    if (any) emit linesAppended();
+}
+
+// ── access ────────────────────────────────────────────────────────────────────
+QString GlueLogBuffer::line(qint64 index) const
+{
+    if (index < firstLine() || index >= m_total) return QString();
+    return m_ring[index % m_capacity].text;
+}
+
+bool GlueLogBuffer::isError(qint64 index) const
+{
+    if (index < firstLine() || index >= m_total) return false;
+    return m_ring[index % m_capacity].error;
+}
+
+QStringList GlueLogBuffer::tail(int count, bool errorsOnly) const
+{
+    QStringList out;
+    for (qint64 i = m_total - 1; i >= firstLine() && out.size() < count; --i) {
+        const Entry &e = m_ring[i % m_capacity];
+        if (!errorsOnly || e.error) out.prepend(e.text);
+    }
+    return out;
+}
+
+// ── files ─────────────────────────────────────────────────────────────────────
+bool GlueLogBuffer::loadTail(const QString &filePath)
+{
+    reset();
+    QFile f(filePath);
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) return false;
+    // Streamed, so only the ring's worth of lines is ever held
+    while (!f.atEnd()) {
+        QByteArray l = f.readLine();
+        if (l.endsWith('\n')) l.chop(1);
+        push(QString::fromUtf8(l), false);
+    }
+    m_file.setFileName(filePath);   // not opened: filePath() names the full log
+    emit linesAppended();
+    return true;
+}
+
+QString GlueLogBuffer::jobLogPath(const QString &cropCode, const QString &cultivarId)
+{
+    QDir dir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/GlueLogs");
+    dir.mkpath(".");
+
+    QStringList old = dir.entryList({"*.log"}, QDir::Files, QDir::Time | QDir::Reversed);
+    while (old.size() >= MAX_JOB_LOGS)
+        dir.remove(old.takeFirst());
+
+    QString stamp = QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss-zzz");
+    return dir.filePath(QString("%1_%2_%3.log").arg(cropCode, cultivarId.trimmed(), stamp));
+}
@@ -0,0 +1,103 @@
+#include "GlueLogView.h"
+#include <QPainter>
+#include <QScrollBar>
+#include <QFontMetrics>
+#include <QContextMenuEvent>
+#include <QMenu>
+#include <QGuiApplication>
+#include <QClipboard>
+#include <QDesktopServices>
+#include <QUrl>
+
+GlueLogView::GlueLogView(QWidget *parent)
+    : QAbstractScrollArea(parent)
+{
+    QFont f("Courier New", 8);
+    f.setStyleHint(QFont::Monospace);
+    setFont(f);
+    m_lineHeight = QFontMetrics(f).lineSpacing();
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    verticalScrollBar()->setSingleStep(1);
+
+    m_updateTimer.setSingleShot(true);
+    m_updateTimer.setInterval(150);
+    connect(&m_updateTimer, &QTimer::timeout, this, &GlueLogView::refresh);
+}
+
+void GlueLogView::setBuffer(GlueLogBuffer *buffer)
+{
+    if (m_buffer) m_buffer->disconnect(this);
+    m_buffer = buffer;
+    m_shownFirst = m_buffer ? m_buffer->firstLine() : 0;
+    if (m_buffer)
+        connect(m_buffer, &GlueLogBuffer::linesAppended, this, [this] {
+            if (!m_updateTimer.isActive()) m_updateTimer.start();
+        });
+    refresh();
+    verticalScrollBar()->setValue(verticalScrollBar()->maximum());
+}
+
+int GlueLogView::visibleRows() const
+{
+    return qMax(1, viewport()->height() / qMax(1, m_lineHeight));
+}
+
+void GlueLogView::refresh()
+{
+    QScrollBar *sb = verticalScrollBar();
+    const bool follow = sb->value() >= sb->maximum();
+    const qint64 first = m_buffer ? m_buffer->firstLine() : 0;
+    const qint64 held  = m_buffer ? m_buffer->totalLines() - first : 0;
+    // Scroll positions count held lines; older ones live only in the file
+    // Keep a scrolled-back view on the same text as old lines drop out
+    const int dropped = int(qMax<qint64>(0, first - m_shownFirst));
+    m_shownFirst = first;
+    const int value = sb->value() - dropped;
+    sb->setRange(0, int(qMax<qint64>(0, held - visibleRows())));
+    sb->setPageStep(visibleRows());
+    sb->setValue(follow ? sb->maximum() : qMax(0, value));
+    viewport()->update();
+}
+
+void GlueLogView::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    refresh();
+}
+
+void GlueLogView::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    QPainter painter(viewport());
+    painter.fillRect(viewport()->rect(), QColor("#FFFFFF"));
+    if (!m_buffer) return;
+
+    const QFontMetrics fm(font());
+    const qint64 first = m_buffer->firstLine() + verticalScrollBar()->value();
+    const qint64 last  = qMin(m_buffer->totalLines(), first + visibleRows() + 1);
+    int y = fm.ascent() + 1;
+    for (qint64 i = first; i < last; ++i, y += m_lineHeight) {
+        painter.setPen(m_buffer->isError(i) ? QColor("#B71C1C") : QColor("#202020"));
+        painter.drawText(4, y, fm.elidedText(m_buffer->line(i), Qt::ElideRight, viewport()->width() - 8));
+    }
+}
+
+void GlueLogView::contextMenuEvent(QContextMenuEvent *event)
+{
+    if (!m_buffer) return;
+    QMenu menu(this);
+    QAction *copyAct = menu.addAction("Copy Shown Lines");
+    QAction *openAct = menu.addAction("Open Full Log");
+    openAct->setEnabled(!m_buffer->filePath().isEmpty());
+    QAction *chosen = menu.exec(event->globalPos());
+    if (chosen == copyAct) {
+        QStringList lines;
+        const qint64 first = m_buffer->firstLine() + verticalScrollBar()->value();
+        const qint64 last  = qMin(m_buffer->totalLines(), first + visibleRows());
+        for (qint64 i = first; i < last; ++i) lines << m_buffer->line(i);
+        QGuiApplication::clipboard()->setText(lines.join('\n'));
+    } else if (chosen == openAct) {
+        m_buffer->flush();
+        QDesktopServices::openUrl(QUrl::fromLocalFile(m_buffer->filePath()));
+    }
+}
@@ -0,0 +1,245 @@
+#include "GlueOutputReader.h"
+#include "GlueLikelihood.h"
+#include "GlueParamSampler.h"
+#include <QDir>
+#include <QFileInfo>
+#include <cmath>
+#include <limits>
+
+static const double NaN = std::numeric_limits<double>::quiet_NaN();
+
+// ── GlueTableStream ───────────────────────────────────────────────────────────
+bool GlueTableStream::open(const QString &filePath, QString *errorMsg)
+{
+    m_file.close();
+    m_file.setFileName(filePath);
+    m_columns.clear();
+    m_row = -1;
+    if (!m_file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (errorMsg) *errorMsg = "Cannot open " + filePath;
+        return false;
+    }
+    while (!m_file.atEnd()) {
+        QByteArray line = m_file.readLine().simplified();
+        if (line.isEmpty() || line.startsWith('*') || line.startsWith('!')) continue;
+        for (QByteArray t : line.split(' ')) {
+            if (t.startsWith('@')) t.remove(0, 1);
+            if (t.startsWith('"') && t.endsWith('"') && t.size() >= 2) t = t.mid(1, t.size() - 2);
+            if (!t.isEmpty()) m_columns << QString::fromLatin1(t).toUpper();
+        }
+        break;
+    }
+    if (m_columns.isEmpty()) {
+        if (errorMsg) *errorMsg = "No header line in " + filePath;
+        return false;
+    }
+    m_dataStart = m_file.pos();
+    m_values.assign(m_columns.size(), NaN);
+    return true;
+}
+
+bool GlueTableStream::rewind()
+{
+    m_row = -1;
+    return m_file.seek(m_dataStart);
+}
+
+bool GlueTableStream::next()
+{
+    const int ncol = m_columns.size();
+    while (!m_file.atEnd()) {
+        QByteArray line = m_file.readLine();
+        const char *p = line.constData();
+        while (*p == ' ' || *p == '\t') ++p;
+        if (*p == '\0' || *p == '\n' || *p == '\r' || *p == '@' || *p == '*' || *p == '!')
+            continue;
+
+        // Token boundaries first, so a leading row name can be skipped; the
+        // buffers keep their capacity, so wide tables allocate once
+        m_tokStart.clear();
+        m_tokLen.clear();
+        for (const char *q = p; *q; ) {
+            while (*q == ' ' || *q == '\t' || *q == '\r' || *q == '\n') ++q;
+            if (!*q) break;
+            const char *start = q;
+            while (*q && *q != ' ' && *q != '\t' && *q != '\r' && *q != '\n') ++q;
+            m_tokStart.push_back(int(start - line.constData()));
+            m_tokLen.push_back(int(q - start));
+        }
+        // QByteArray::toDouble() is locale-independent, unlike strtod()
+        const int n = int(m_tokStart.size());
+        const int skip = (n == ncol + 1) ? 1 : 0;
+        for (int c = 0; c < ncol; ++c) {
+            if (c + skip >= n) { m_values[c] = NaN; continue; }
+            bool ok = false;
+            double v = QByteArray::fromRawData(line.constData() + m_tokStart[c + skip],
+                                               m_tokLen[c + skip]).toDouble(&ok);
+            m_values[c] = ok ? v : NaN;
+        }
+        ++m_row;
+        return true;
+    }
+    return false;
+}
+
+// ── likelihood sources ────────────────────────────────────────────────────────
+namespace {
+struct WeightSource {
+    GlueTableStream stream;
+    QString name;
+    int  col = -1;
+    bool logScale = false;
+};
+
+// Column holding a per-set probability, likelihood or weight; -1 if none
+int weightColumn(const QStringList &cols, bool &logScale)
+{
+    for (const char *key : {"PROB", "LIKELIHOOD", "WEIGHT"}) {
+        for (int c = cols.size() - 1; c >= 0; --c) {
+            if (cols[c].contains(key) && !cols[c].startsWith("MAX")) {
+                logScale = cols[c].contains("LOG");
+                return c;
+            }
+        }
+    }
+    return -1;
+}
+
+bool openWeightSource(const QString &dir, int round, WeightSource &src)
+{
+    const QString suffix = QString("%1.txt").arg(round);
+    const QStringList files = QDir(dir).entryList({"*.txt"}, QDir::Files, QDir::Name);
+    for (const QString &name : files) {
+        if (!name.endsWith(suffix, Qt::CaseInsensitive)) continue;
+        if (!name.contains("Likelihood", Qt::CaseInsensitive) &&
+            !name.contains("Posterior", Qt::CaseInsensitive)) continue;
+        if (!src.stream.open(dir + "/" + name)) continue;
+        src.col = weightColumn(src.stream.columns(), src.logScale);
+        src.name = name;
+        if (src.col >= 0) return true;
+        src.stream.close();
+    }
+    return false;
+}
+} // namespace
+
+// ── distributions ─────────────────────────────────────────────────────────────
+GlueDistributions GlueOutputReader::distributions(const QString &dir, int round, int bins)
+{
+    GlueDistributions out;
+    out.round = round;
+    bins = qMax(1, bins);
+
+    GlueTableStream sets;
+    if (!sets.open(dir + "/" + GlueParamSampler::randomSetsFileName(round), &out.errorMsg))
+        return out;
+    const int np = sets.columns().size();
+
+    // Pass 1: ranges, set count and, for a likelihood table, its maximum
+    WeightSource ws;
+    bool useFile = openWeightSource(dir, round, ws);
+    std::vector<double> lo(np, std::numeric_limits<double>::max());
+    std::vector<double> hi(np, std::numeric_limits<double>::lowest());
+    double maxW = -std::numeric_limits<double>::infinity();
+    qint64 bestRow = -1;
+    while (sets.next()) {
+        for (int p = 0; p < np; ++p) {
+            double v = sets.value(p);
+            if (!std::isfinite(v)) continue;
+            lo[p] = std::min(lo[p], v);
+            hi[p] = std::max(hi[p], v);
+        }
+        if (useFile) {
+            if (!ws.stream.next()) { useFile = false; continue; }
+            double w = ws.stream.value(ws.col);
+            if (std::isfinite(w) && w > maxW) { maxW = w; bestRow = sets.row(); }
+        }
+    }
+    out.sets = sets.row() + 1;
+    if (out.sets <= 0) {
+        out.errorMsg = "No parameter sets in " + GlueParamSampler::randomSetsFileName(round);
+        return out;
+    }
+    if (useFile && ws.stream.next()) useFile = false;   // more rows than sets
+    if (useFile && !ws.logScale && maxW <= 0) useFile = false;
+
+    // Fallback: score EvaluateFrame_<round>.txt natively, streamed like the
+    // sets (holds a few doubles per set, never the table)
+    std::vector<double> evalWeights;
+    if (!useFile) {
+        QString evalPath = QString("%1/EvaluateFrame_%2.txt").arg(dir).arg(round);
+        if (QFile::exists(evalPath)) {
+            GlueLikelihoodResult res = GlueLikelihood::evaluateFile(evalPath, int(out.sets));
+            if (res.errorMsg.isEmpty()) {
+                evalWeights = std::move(res.weights);
+                bestRow = res.bestSet;
+                out.weightSource = QFileInfo(evalPath).fileName() + " (Gaussian likelihood)";
+            }
+        }
+    } else {
+        out.weightSource = ws.name;
+    }
+    out.weighted = useFile || !evalWeights.empty();
+
+    // Pass 2: histograms and weighted moments for the sampled columns
+    std::vector<int> cols;
+    for (int p = 0; p < np; ++p)
+        if (hi[p] > lo[p]) cols.push_back(p);
+    const int nc = int(cols.size());
+    std::vector<std::vector<double>> prior(nc, std::vector<double>(bins, 0.0));
+    std::vector<std::vector<double>> post(nc, std::vector<double>(bins, 0.0));
+    std::vector<double> sw(nc, 0.0), swx(nc, 0.0), swxx(nc, 0.0), best(nc, NaN);
+
+    sets.rewind();
+    if (useFile) ws.stream.rewind();
+    while (sets.next()) {
+        double w = 1.0;
+        if (useFile) {
+            ws.stream.next();
+            double raw = ws.stream.value(ws.col);
+            w = !std::isfinite(raw) ? 0.0 : ws.logScale ? std::exp(raw - maxW) : qMax(0.0, raw);
+        } else if (!evalWeights.empty()) {
+            w = sets.row() < qint64(evalWeights.size()) ? evalWeights[sets.row()] : 0.0;
+        }
+        for (int k = 0; k < nc; ++k) {
+            const int p = cols[k];
+            double v = sets.value(p);
+            if (!std::isfinite(v)) continue;
+            int b = int((v - lo[p]) / (hi[p] - lo[p]) * bins);
+            b = qBound(0, b, bins - 1);
+            prior[k][b] += 1.0;
+            post[k][b]  += w;
+            sw[k] += w; swx[k] += w * v; swxx[k] += w * v * v;
+            if (out.weighted && sets.row() == bestRow) best[k] = v;
+        }
+    }
+
+    for (int k = 0; k < nc; ++k) {
+        GlueParamHistogram h;
+        h.name = sets.columns()[cols[k]];
+        h.lo = lo[cols[k]];
+        h.hi = hi[cols[k]];
+        double nPrior = 0;
+        for (double c : prior[k]) nPrior += c;
+        for (double &c : prior[k]) c = nPrior > 0 ? c / nPrior : 0.0;
+        for (double &c : post[k])  c = sw[k] > 0 ? c / sw[k] : 0.0;
+        h.prior = std::move(prior[k]);
+        h.posterior = std::move(post[k]);
+        h.best = best[k];
+        if (sw[k] > 0) {
+            h.mean = swx[k] / sw[k];
+            h.sd   = std::sqrt(qMax(0.0, swxx[k] / sw[k] - h.mean * h.mean));
+        }
+        out.params << h;
+    }
+    return out;
+}
+
+QList<int> GlueOutputReader::availableRounds(const QString &dir)
+{
+    QList<int> rounds;
+    for (int r : {1, 2})
+        if (QFile::exists(dir + "/" + GlueParamSampler::randomSetsFileName(r)))
+            rounds << r;
+    return rounds;
+}
@@ -0,0 +1,255 @@
+#include "GlueParallelDriver.h"
+#include "Config.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include <cctype>
+
+GlueParallelDriver::GlueParallelDriver(QObject *parent)
+    : QObject(parent)
+{
+}
+
+GlueParallelDriver::~GlueParallelDriver()
+{
+    for (Worker &w : m_workers) {
+        if (w.proc && w.proc->state() != QProcess::NotRunning) {
+            w.proc->disconnect(this);
+            w.proc->kill();
+            w.proc->waitForFinished(2000);
+        }
+    }
+}
+
+// ── start ─────────────────────────────────────────────────────────────────────
+bool GlueParallelDriver::start(const GlueDriverConfig &config, const GlueParamMatrix &sets,
+                               QString *errorMsg)
+{
+    auto fail = [errorMsg](const QString &msg) {
+        if (errorMsg) *errorMsg = msg;
+        return false;
+    };
+    if (isRunning()) return fail("Driver is already running");
+    if (sets.sets <= 0) return fail("No parameter sets");
+
+    m_config = config;
+    if (m_config.program.isEmpty())
+        m_config.program = QDir(Config::DSSAT_BASE).filePath(m_config.cropInfo.exe);
+    if (m_config.scratchRoot.isEmpty())
+        m_config.scratchRoot = GlueRunner::GLUE_WORK + "/Parallel";
+    if (m_config.workers <= 0)
+        m_config.workers = qMax(1, QThread::idealThreadCount());
+    m_config.workers = qMin(m_config.workers, sets.sets);
+
+    // Render the CUL once; only the cultivar's line changes between runs
+    QStringList headers;
+    QVector<CulRow> rows = CulParser::parse(m_config.cropInfo.culFile, headers);
+    QStringList paramNames = CulParser::extractParamNames(headers);
+    int culIndex = -1;
+    for (int i = 0; i < rows.size(); ++i)
+        if (rows[i].varNum.trimmed().compare(m_config.cultivarId.trimmed(), Qt::CaseInsensitive) == 0)
+            culIndex = i;
+    if (culIndex < 0)
+        return fail(QString("Cultivar %1 not found in %2").arg(m_config.cultivarId, m_config.cropInfo.culFile));
+    for (const QString &name : sets.names)
+        if (!paramNames.contains(name))
+            return fail(QString("Parameter %1 is not a column of %2").arg(name, m_config.cropInfo.culFile));
+
+    QDir().mkpath(m_config.scratchRoot);
+    QString templatePath = m_config.scratchRoot + "/template.CUL";
+    if (!CulParser::write(templatePath, rows, headers, paramNames))
+        return fail("Cannot write " + templatePath);
+    QFile tf(templatePath);
+    if (!tf.open(QIODevice::ReadOnly | QIODevice::Text)) return fail("Cannot read " + templatePath);
+    m_culLines = QString::fromLatin1(tf.readAll()).split('\n');
+    tf.close();
+    QFile::remove(templatePath);
+
+    m_culRowLine = -1;
+    for (int i = 0; i < m_culLines.size(); ++i)
+        if (m_culLines[i].startsWith(rows[culIndex].varNum.leftJustified(6, ' ') + ' '))
+            m_culRowLine = i;
+    if (m_culRowLine < 0) return fail("Cultivar line not found in rendered CUL");
+
+    m_culRow = rows[culIndex];
+    m_culRow.paramStrs.clear();   // decimals follow the MINIMA/MAXIMA formats
+    m_formats = CulParser::inferFormats(rows, paramNames.size());
+    m_culFileName = QFileInfo(m_config.cropInfo.culFile).fileName();
+
+    // Map the set matrix columns onto CUL parameter positions
+    m_sets = sets;
+    QStringList ordered;
+    for (const QString &name : paramNames)
+        ordered << name;
+    m_sets.names = ordered;
+    m_sets.columns.assign(ordered.size(), std::vector<double>());
+    for (int p = 0; p < sets.names.size(); ++p)
+        m_sets.columns[ordered.indexOf(sets.names[p])] = sets.columns[p];
+
+    // Workers
+    for (Worker &w : m_workers) if (w.proc) w.proc->deleteLater();
+    m_workers.clear();
+    for (int i = 0; i < m_config.workers; ++i) {
+        Worker w;
+        if (!prepareWorker(w, i, errorMsg)) return false;
+        m_workers << w;
+    }
+
+    m_results.assign(m_sets.sets, QByteArray());
+    m_header.clear();
+    m_table = GlueEvalTable();
+    if (m_monitor) m_monitor->reset(sets);   // sampled columns only, as given
+    m_limit = m_sets.sets;
+    m_next = m_done = m_failed = m_active = 0;
+    m_cancelled = false;
+
+    for (int i = 0; i < m_workers.size(); ++i)
+        launchNext(i);
+    return true;
+}
+
+bool GlueParallelDriver::prepareWorker(Worker &w, int index, QString *errorMsg)
+{
+    w.dir = QString("%1/worker%2").arg(m_config.scratchRoot).arg(index + 1);
+    QDir(w.dir).removeRecursively();
+    QDir().mkpath(w.dir);
+
+    for (const QString &src : {m_config.cropInfo.ecoFile, m_config.cropInfo.speFile}) {
+        if (src.isEmpty() || !QFile::exists(src)) continue;
+        QFile::copy(src, w.dir + "/" + QFileInfo(src).fileName());
+    }
+    if (GlueRunner::writeBatchFile(m_config.cropInfo, m_config.cultivarId, m_config.cultivarName,
+                                   m_config.treatments, w.dir).isEmpty()) {
+        if (errorMsg) *errorMsg = "Cannot write batch file in " + w.dir;
+        return false;
+    }
+
+    w.proc = new QProcess(this);
+    w.proc->setWorkingDirectory(w.dir);
+    w.proc->setProcessChannelMode(QProcess::MergedChannels);
+    w.proc->setStandardOutputFile(QProcess::nullDevice());
+    int wi = index;
+    connect(w.proc, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, [this, wi](int, QProcess::ExitStatus) { onRunFinished(wi); });
+    connect(w.proc, &QProcess::errorOccurred, this, [this, wi](QProcess::ProcessError e) {
+        if (e == QProcess::FailedToStart) onRunFinished(wi);
+    });
+    return true;
+}
+
+QString GlueParallelDriver::culText(int set) const
+{
+    CulRow row = m_culRow;
+    for (int p = 0; p < m_sets.columns.size(); ++p)
+        if (!m_sets.columns[p].empty() && p < row.params.size())
+            row.params[p] = m_sets.columns[p][set];
+    QStringList lines = m_culLines;
+    lines[m_culRowLine] = CulParser::formatRow(row, m_formats, m_formats.size());
+    return lines.join('\n');
+}
+
+// ── scheduling ────────────────────────────────────────────────────────────────
+void GlueParallelDriver::launchNext(int workerIndex)
+{
+    Worker &w = m_workers[workerIndex];
+    if (m_next < 0) return;   // already reported
+    if (m_cancelled || m_next >= m_limit) {
+        // Last worker to go idle reports completion exactly once
+        if (m_active == 0) {
+            m_next = -1;
+            // Runs without output are tolerated, but not a batch that has none
+            emit finished(!m_cancelled && m_done >= m_limit && m_failed < m_done);
+        }
+        return;
+    }
+
+    w.set = m_next++;
+    ++m_active;
+
+    QFile cul(w.dir + "/" + m_culFileName);
+    if (cul.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+        cul.write(culText(w.set).toLatin1());
+        cul.close();
+    }
+    QFile::remove(w.dir + "/Evaluate.OUT");
+    QFile::remove(w.dir + "/EVALUATE.OUT");
+
+    QString modelId = m_config.cropInfo.modelId.isEmpty() ? m_config.cropInfo.module
+                                                          : m_config.cropInfo.modelId;
+    QString batch = QString("%1.%2C").arg(m_config.cultivarId, m_config.cropInfo.cropCode);
+    w.proc->start(m_config.program, m_config.programPrefix + QStringList{modelId, m_config.runMode, batch});
+}
+
+void GlueParallelDriver::onRunFinished(int workerIndex)
+{
+    Worker &w = m_workers[workerIndex];
+    if (w.set < 0) return;   // FailedToStart is followed by no finished(), but guard anyway
+
+    QFile f(w.dir + "/Evaluate.OUT");
+    if (!f.exists()) f.setFileName(w.dir + "/EVALUATE.OUT");
+    QByteArray rows;
+    if (f.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        const QByteArray runNo = QByteArray::number(w.set + 1);
+        for (const QByteArray &raw : f.readAll().split('\n')) {
+            QByteArray line = raw.trimmed();
+            if (line.isEmpty() || line.startsWith('*') || line.startsWith('!')) continue;
+            // Replace the model's own RUN column by the parameter-set number
+            int cut = 0;
+            while (cut < line.size() && !isspace(uchar(line[cut]))) ++cut;
+            if (line.startsWith('@')) {
+                if (m_header.isEmpty()) m_header = "@RUN" + line.mid(cut);
+                continue;
+            }
+            rows += runNo + line.mid(cut) + '\n';
+        }
+    }
+    m_results[w.set] = rows;
+    if (rows.isEmpty()) ++m_failed;
+
+    ++m_done;
+    --m_active;
+    w.set = -1;
+    emit progress(m_done, m_sets.sets);
+
+    if (m_monitor) {
+        if (m_table.columns.isEmpty() && !m_header.isEmpty())
+            GlueLikelihood::appendRows(m_table, m_header);
+        GlueLikelihood::appendRows(m_table, rows);
+        if (m_monitor->due(m_done) && !m_table.columns.isEmpty()) {
+            const GlueConvergenceCheck &c = m_monitor->check(m_table, m_done);
+            emit convergenceChecked(c);
+            // Runs already started still finish and are kept
+            if (c.converged && m_monitor->options().stopEarly && m_limit == m_sets.sets)
+                m_limit = m_next;
+        }
+    }
+
+    // Restart from the event loop, not from inside QProcess's own signal
+    QMetaObject::invokeMethod(this, [this, workerIndex] { launchNext(workerIndex); },
+                              Qt::QueuedConnection);
+}
+
+void GlueParallelDriver::setConvergence(const GlueConvergenceOptions &options)
+{
+    m_monitor = std::make_unique<GlueConvergenceMonitor>(options);
+}
+
+void GlueParallelDriver::cancel()
+{
+    m_cancelled = true;
+    for (Worker &w : m_workers)
+        if (w.proc && w.proc->state() != QProcess::NotRunning)
+            w.proc->kill();
+}
+
+// ── writeMerged ───────────────────────────────────────────────────────────────
+bool GlueParallelDriver::writeMerged(const QString &filePath) const
+{
+    QFile f(filePath);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) return false;
+    f.write((m_header.isEmpty() ? QByteArray("@RUN") : m_header) + '\n');
+    for (const QByteArray &rows : m_results)
+        if (f.write(rows) != rows.size()) return false;
+    return true;
+}
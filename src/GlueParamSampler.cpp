@@ -0,0 +1,290 @@
+#include "GlueParamSampler.h"
+#include <QFile>
+#include <cstdio>
+#include <cstdint>
+#include <numeric>
+
+// ── RNG: splitmix64-seeded xoshiro256** ───────────────────────────────────────
+namespace {
+class Xoshiro256
+{
+public:
+    explicit Xoshiro256(quint64 seed)
+    {
+        for (auto &w : s) {
+            seed += 0x9E3779B97F4A7C15ULL;
+            quint64 z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            w = z ^ (z >> 31);
+        }
+    }
+    quint64 next()
+    {
+        const quint64 result = rotl(s[1] * 5, 7) * 9;
+        const quint64 t = s[1] << 17;
+        s[2] ^= s[0]; s[3] ^= s[1]; s[1] ^= s[2]; s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+    // Uniform in [0, 1) with 53 random bits
+    double uniform() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+    // Uniform integer in [0, n)
+    quint64 below(quint64 n) { return static_cast<quint64>(uniform() * n); }
+
+private:
+    static quint64 rotl(quint64 x, int k) { return (x << k) | (x >> (64 - k)); }
+    quint64 s[4];
+};
+
+// ── Sobol direction numbers (Joe & Kuo, new-joe-kuo-6.21201) ─────────────────
+// Dimension 1 is the van der Corput sequence; rows below are dimensions 2..21.
+struct SobolPoly { int s; int a; int m[7]; };
+const SobolPoly SOBOL_POLYS[] = {
+    {1,  0, {1}},
+    {2,  1, {1, 3}},
+    {3,  1, {1, 3, 1}},
+    {3,  2, {1, 1, 1}},
+    {4,  1, {1, 1, 3, 3}},
+    {4,  4, {1, 3, 5, 13}},
+    {5,  2, {1, 1, 5, 5, 17}},
+    {5,  4, {1, 1, 5, 5, 5}},
+    {5,  7, {1, 1, 7, 11, 19}},
+    {5, 11, {1, 1, 5, 1, 1}},
+    {5, 13, {1, 1, 1, 3, 11}},
+    {5, 14, {1, 3, 5, 5, 31}},
+    {6,  1, {1, 3, 3, 9, 7, 49}},
+    {6, 13, {1, 1, 1, 15, 21, 21}},
+    {6, 16, {1, 3, 1, 13, 27, 49}},
+    {6, 19, {1, 1, 1, 15, 7, 5}},
+    {6, 22, {1, 3, 1, 15, 13, 25}},
+    {6, 25, {1, 1, 5, 5, 19, 61}},
+    {7,  1, {1, 3, 7, 11, 23, 15, 103}},
+    {7,  4, {1, 3, 7, 13, 13, 15, 69}},
+};
+const int SOBOL_BITS = 32;
+const int SOBOL_DIMS = 1 + int(sizeof(SOBOL_POLYS) / sizeof(SOBOL_POLYS[0]));
+
+// Direction numbers V[k] (scaled by 2^32) for 0-based dimension d
+void sobolDirections(int d, quint32 V[SOBOL_BITS])
+{
+    if (d == 0) {
+        for (int k = 0; k < SOBOL_BITS; ++k) V[k] = quint32(1) << (31 - k);
+        return;
+    }
+    const SobolPoly &p = SOBOL_POLYS[d - 1];
+    for (int k = 0; k < p.s && k < SOBOL_BITS; ++k)
+        V[k] = quint32(p.m[k]) << (31 - k);
+    for (int k = p.s; k < SOBOL_BITS; ++k) {
+        quint32 v = V[k - p.s] ^ (V[k - p.s] >> p.s);
+        for (int j = 1; j < p.s; ++j)
+            if ((p.a >> (p.s - 1 - j)) & 1) v ^= V[k - j];
+        V[k] = v;
+    }
+}
+
+// Fill one column with n Sobol points of dimension d (the all-zero first point is skipped)
+void sobolColumn(int d, quint32 shift, double *out, int n)
+{
+    quint32 V[SOBOL_BITS];
+    sobolDirections(d, V);
+    quint32 x = 0;
+    for (int i = 0; i < n; ++i) {
+        // Gray-code order: flip the direction of the lowest zero bit of i
+        quint32 c = 0, v = quint32(i);
+        while (v & 1u) { v >>= 1; ++c; }
+        x ^= V[c];
+        out[i] = (x ^ shift) * (1.0 / 4294967296.0);
+    }
+}
+
+void lhsColumn(Xoshiro256 &rng, double *out, int n)
+{
+    std::vector<int> perm(n);
+    std::iota(perm.begin(), perm.end(), 0);
+    for (int i = n - 1; i > 0; --i)
+        std::swap(perm[i], perm[rng.below(quint64(i) + 1)]);
+    const double inv = 1.0 / n;
+    for (int i = 0; i < n; ++i)
+        out[i] = (perm[i] + rng.uniform()) * inv;
+}
+} // namespace
+
+// ── GlueParamSpace ────────────────────────────────────────────────────────────
+int GlueParamSpace::sampledCount() const
+{
+    int n = 0;
+    for (bool b : sampled) n += b ? 1 : 0;
+    return n;
+}
+
+// ── GlueParamSampler ──────────────────────────────────────────────────────────
+QString GlueParamSampler::calibratedType(int glueFlag, int round)
+{
+    if (glueFlag == 2) return "P";
+    if (glueFlag == 3) return "G";
+    return round >= 2 ? "G" : "P";
+}
+
+int GlueParamSampler::maxSobolDimensions() { return SOBOL_DIMS; }
+
+GlueParamSpace GlueParamSampler::buildSpace(const QVector<CulRow> &rows,
+                                            const QStringList &headerLines,
+                                            const QString &cultivarId,
+                                            int glueFlag, int round,
+                                            QString *errorMsg)
+{
+    auto fail = [errorMsg](const QString &msg) {
+        if (errorMsg) *errorMsg = msg;
+        return GlueParamSpace();
+    };
+
+    const CulRow *minRow = nullptr, *maxRow = nullptr, *cultivar = nullptr;
+    for (const CulRow &r : rows) {
+        QString v = r.varNum.trimmed();
+        if (v == "999991") minRow = &r;
+        else if (v == "999992") maxRow = &r;
+        else if (v.compare(cultivarId.trimmed(), Qt::CaseInsensitive) == 0) cultivar = &r;
+    }
+    if (!minRow || !maxRow) return fail("CUL file has no MINIMA/MAXIMA (999991/999992) rows");
+    if (!cultivar)          return fail(QString("Cultivar %1 not found").arg(cultivarId));
+
+    QStringList names = CulParser::extractParamNames(headerLines);
+    QMap<QString, QString> types = CulParser::calibrationTypes(headerLines);
+    const QString wanted = calibratedType(glueFlag, round);
+    const int n = qMax(minRow->params.size(), maxRow->params.size());
+
+    GlueParamSpace space;
+    for (int i = 0; i < n; ++i) {
+        QString name = i < names.size() ? names[i]
+                     : (i < CUL_PARAM_NAMES.size() ? CUL_PARAM_NAMES[i] : QString("P%1").arg(i + 1));
+        auto lo = i < minRow->params.size() ? minRow->params[i] : std::nullopt;
+        auto hi = i < maxRow->params.size() ? maxRow->params[i] : std::nullopt;
+        auto cur = i < cultivar->params.size() ? cultivar->params[i] : std::nullopt;
+        // calibrationTypes() is keyed by the fixed CUL_PARAM_NAMES position
+        QString type = i < CUL_PARAM_NAMES.size() ? types.value(CUL_PARAM_NAMES[i]) : QString();
+
+        space.names   << name;
+        space.minima  << lo.value_or(0.0);
+        space.maxima  << hi.value_or(0.0);
+        space.base    << cur.value_or(lo.value_or(0.0));
+        space.sampled << (type == wanted && lo && hi && *hi > *lo);
+    }
+    if (space.sampledCount() == 0)
+        return fail(QString("No %1 parameters with valid MINIMA/MAXIMA to sample").arg(wanted));
+    return space;
+}
+
+GlueParamMatrix GlueParamSampler::generate(const GlueParamSpace &space, int sets,
+                                           GlueSamplingMethod method, quint64 seed)
+{
+    GlueParamMatrix m;
+    m.names = space.names;
+    m.sets  = qMax(0, sets);
+    m.columns.resize(space.names.size());
+
+    Xoshiro256 rng(seed);
+    int dim = 0;
+    for (int p = 0; p < space.names.size(); ++p) {
+        std::vector<double> &col = m.columns[p];
+        col.resize(m.sets);
+        if (!space.sampled[p]) {
+            std::fill(col.begin(), col.end(), space.base[p]);
+            continue;
+        }
+
+        // Unit-interval draws first, then one affine pass per column
+        double *u = col.data();
+        switch (method) {
+        case GlueSamplingMethod::Uniform:
+            for (int i = 0; i < m.sets; ++i) u[i] = rng.uniform();
+            break;
+        case GlueSamplingMethod::LatinHypercube:
+            lhsColumn(rng, u, m.sets);
+            break;
+        case GlueSamplingMethod::Sobol:
+            if (dim < SOBOL_DIMS)
+                sobolColumn(dim, seed ? quint32(rng.next() >> 32) : 0u, u, m.sets);
+            else
+                lhsColumn(rng, u, m.sets);
+            break;
+        }
+        ++dim;
+
+        const double lo = space.minima[p], span = space.maxima[p] - space.minima[p];
+        for (int i = 0; i < m.sets; ++i) u[i] = lo + span * u[i];
+    }
+    return m;
+}
+
+bool GlueParamSampler::writeRandomSets(const QString &filePath, const GlueParamMatrix &matrix)
+{
+    QFile f(filePath);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+
+    QByteArray buf = matrix.names.join(' ').toLatin1() + '\n';
+    buf.reserve(1 << 20);
+    char num[32];
+    const int cols = int(matrix.columns.size());
+    for (int i = 0; i < matrix.sets; ++i) {
+        for (int p = 0; p < cols; ++p) {
+            int len = std::snprintf(num, sizeof(num), p ? " %.6g" : "%.6g", matrix.columns[p][i]);
+            buf.append(num, len);
+        }
+        buf.append('\n');
+        if (buf.size() > (1 << 20) - 512) {
+            if (f.write(buf) != buf.size()) return false;
+            buf.clear();
+        }
+    }
+    return f.write(buf) == buf.size();
+}
+
+bool GlueParamSampler::readRandomSets(const QString &filePath, GlueParamMatrix &matrix)
+{
+    matrix = GlueParamMatrix();
+    QFile f(filePath);
+    if (!f.open(QIODevice::ReadOnly)) return false;
+
+    const QList<QByteArray> lines = f.readAll().split('\n');
+    for (const QByteArray &raw : lines) {
+        QByteArray line = raw.simplified();
+        if (line.isEmpty()) continue;
+        const QList<QByteArray> tok = line.split(' ');
+        if (matrix.names.isEmpty()) {
+            for (const QByteArray &t : tok) matrix.names << QString::fromLatin1(t);
+            matrix.columns.resize(tok.size());
+            continue;
+        }
+        if (tok.size() != matrix.names.size()) return false;
+        for (int p = 0; p < tok.size(); ++p)
+            matrix.columns[p].push_back(tok[p].toDouble());
+        ++matrix.sets;
+    }
+    return !matrix.names.isEmpty();
+}
+
+QString GlueParamSampler::randomSetsFileName(int round)
+{
+    return QString("RealRandomSets_%1.txt").arg(round);
+}
+
+bool GlueParamSampler::parseMethod(const QString &name, GlueSamplingMethod &method)
+{
+    QString n = name.trimmed().toLower();
+    if (n == "uniform" || n == "random")           method = GlueSamplingMethod::Uniform;
+    else if (n == "lhs" || n == "latin")           method = GlueSamplingMethod::LatinHypercube;
+    else if (n == "sobol")                         method = GlueSamplingMethod::Sobol;
+    else return false;
+    return true;
+}
+
+QString GlueParamSampler::methodName(GlueSamplingMethod method)
+{
+    switch (method) {
+    case GlueSamplingMethod::LatinHypercube: return "lhs";
+    case GlueSamplingMethod::Sobol:          return "sobol";
+    default:                                 return "uniform";
+    }
+}
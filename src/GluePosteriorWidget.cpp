@@ -0,0 +1,228 @@
+#include "GluePosteriorWidget.h"
+#include <QPainter>
+#include <QPen>
+#include <QFontMetrics>
+#include <QDialog>
+#include <QComboBox>
+#include <QLabel>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QMessageBox>
+#include <algorithm>
+#include <cmath>
+
+const QColor GluePosteriorWidget::PRIOR_COLOR     = QColor("#BDBDBD");  // grey
+const QColor GluePosteriorWidget::POSTERIOR_COLOR = QColor("#0078D4");  // blue
+const QColor GluePosteriorWidget::BEST_COLOR      = QColor("#E64A19");  // orange-red
+
+GluePosteriorWidget::GluePosteriorWidget(QWidget *parent)
+    : QWidget(parent)
+{
+    setMinimumSize(300, 200);
+}
+
+GluePosteriorWidget::~GluePosteriorWidget() {}
+
+void GluePosteriorWidget::setData(const GlueDistributions &data)
+{
+    m_data = data;
+    m_hasData = !m_data.params.isEmpty();
+    update();
+}
+
+void GluePosteriorWidget::clearData()
+{
+    m_data = {};
+    m_hasData = false;
+    update();
+}
+
+// ── round browser ─────────────────────────────────────────────────────────────
+QWidget *GluePosteriorWidget::createRoundBrowser(const QString &dir, QWidget *parent)
+{
+    const QList<int> rounds = dir.isEmpty() ? QList<int>() : GlueOutputReader::availableRounds(dir);
+    if (rounds.isEmpty()) return nullptr;
+
+    QWidget *browser = new QWidget(parent);
+    QVBoxLayout *vl = new QVBoxLayout(browser);
+    vl->setContentsMargins(0, 0, 0, 0);
+    QComboBox *roundCombo = new QComboBox;
+    for (int r : rounds)
+        roundCombo->addItem(r == 1 ? "Round 1 (phenology)" : "Round 2 (growth)", r);
+    QHBoxLayout *roundRow = new QHBoxLayout;
+    roundRow->addWidget(new QLabel("Round:"));
+    roundRow->addWidget(roundCombo);
+    roundRow->addStretch();
+    vl->addLayout(roundRow);
+    GluePosteriorWidget *postWidget = new GluePosteriorWidget;
+    vl->addWidget(postWidget, 1);
+
+    auto loadRound = [postWidget, roundCombo, dir]() {
+        postWidget->setData(GlueOutputReader::distributions(dir, roundCombo->currentData().toInt()));
+    };
+    connect(roundCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), postWidget, loadRound);
+    roundCombo->setCurrentIndex(roundCombo->count() - 1);
+    loadRound();
+    return browser;
+}
+
+void GluePosteriorWidget::showForDir(QWidget *parent, const QString &dir, const QString &title)
+{
+    QDialog dlg(parent);
+    QWidget *browser = createRoundBrowser(dir, &dlg);
+    if (!browser) {
+        QMessageBox::warning(parent, "File Not Found",
+            QString("No GLUE parameter sets found in:\n%1\n\nRun GLUE first.").arg(dir));
+        return;
+    }
+    dlg.setWindowTitle(title);
+    dlg.resize(750, 500);
+    QVBoxLayout *vl = new QVBoxLayout(&dlg);
+    vl->addWidget(browser, 1);
+    QPushButton *closeBtn = new QPushButton("Close");
+    connect(closeBtn, &QPushButton::clicked, &dlg, &QDialog::accept);
+    QHBoxLayout *hl = new QHBoxLayout;
+    hl->addStretch();
+    hl->addWidget(closeBtn);
+    vl->addLayout(hl);
+    dlg.exec();
+}
+
+void GluePosteriorWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.fillRect(rect(), QColor("#FFFFFF"));
+
+    if (!m_hasData) {
+        painter.setPen(QColor("#999999"));
+        painter.drawText(rect(), Qt::AlignCenter,
+            m_data.errorMsg.isEmpty()
+                ? QString("No GLUE parameter sets to show.\n"
+                          "(Distributions appear after a GLUE round has finished.)")
+                : m_data.errorMsg);
+        return;
+    }
+
+    // Title: round, set count and where the weights came from
+    const int marginTop = 28;
+    QFont f = painter.font();
+    f.setBold(true);
+    painter.setFont(f);
+    painter.setPen(Qt::black);
+    QString title = QString("Round %1 — %2 parameter sets").arg(m_data.round).arg(m_data.sets);
+    title += m_data.weighted ? QString(", weights from %1").arg(m_data.weightSource)
+                             : QString(" (no likelihoods found, prior only)");
+    painter.drawText(QRect(0, 4, width(), marginTop - 4), Qt::AlignHCenter | Qt::AlignTop, title);
+    f.setBold(false);
+    painter.setFont(f);
+
+    // Legend
+    QFont smallFont = painter.font();
+    smallFont.setPointSize(8);
+    painter.setFont(smallFont);
+    int lx = width() - 250;
+    int ly = marginTop - 2;
+    painter.fillRect(lx, ly + 2, 14, 10, PRIOR_COLOR);
+    painter.setPen(Qt::black);
+    painter.drawText(lx + 18, ly, 60, 14, Qt::AlignLeft | Qt::AlignVCenter, "Prior");
+    if (m_data.weighted) {
+        painter.fillRect(lx + 70, ly + 2, 14, 10, POSTERIOR_COLOR);
+        painter.drawText(lx + 88, ly, 70, 14, Qt::AlignLeft | Qt::AlignVCenter, "Posterior");
+        painter.setPen(QPen(BEST_COLOR, 2));
+        painter.drawLine(lx + 160, ly + 7, lx + 174, ly + 7);
+        painter.setPen(Qt::black);
+        painter.drawText(lx + 178, ly, 70, 14, Qt::AlignLeft | Qt::AlignVCenter, "Max. prob.");
+    }
+
+    // One cell per sampled parameter, laid out on a near-square grid
+    const int n = m_data.params.size();
+    const int cols = std::max(1, int(std::ceil(std::sqrt(double(n)))));
+    const int rows = (n + cols - 1) / cols;
+    const int top = marginTop + 16;
+    const double cellW = double(width()) / cols;
+    const double cellH = double(height() - top) / rows;
+    for (int i = 0; i < n; ++i) {
+        QRect cell(int((i % cols) * cellW), top + int((i / cols) * cellH), int(cellW), int(cellH));
+        paintHistogram(painter, cell, m_data.params[i]);
+    }
+    painter.setFont(QFont());
+}
+
+void GluePosteriorWidget::paintHistogram(QPainter &painter, const QRect &cell,
+                                         const GlueParamHistogram &h) const
+{
+    const int marginLeft = 36, marginRight = 10, marginTop = 18, marginBottom = 30;
+    QRect graphRect(cell.left() + marginLeft, cell.top() + marginTop,
+                    cell.width() - marginLeft - marginRight,
+                    cell.height() - marginTop - marginBottom);
+    if (graphRect.width() < 20 || graphRect.height() < 20) return;
+
+    // Parameter name, posterior mean ± SD
+    painter.setPen(Qt::black);
+    QString label = h.name;
+    if (m_data.weighted)
+        label += QString("  %1 ± %2").arg(h.mean, 0, 'g', 4).arg(h.sd, 0, 'g', 3);
+    painter.drawText(QRect(cell.left(), cell.top() + 2, cell.width(), marginTop - 2),
+                     Qt::AlignHCenter | Qt::AlignTop, label);
+
+    const int bins = int(h.prior.size());
+    double yMax = 0;
+    for (int b = 0; b < bins; ++b) {
+        yMax = std::max(yMax, h.prior[b]);
+        if (m_data.weighted) yMax = std::max(yMax, h.posterior[b]);
+    }
+    if (yMax <= 0) yMax = 1.0;
+    yMax *= 1.1;
+
+    // Axes and grid
+    painter.setPen(QPen(Qt::black, 1));
+    painter.drawLine(graphRect.bottomLeft(), graphRect.bottomRight());
+    painter.drawLine(graphRect.topLeft(),    graphRect.bottomLeft());
+    for (int i = 1; i <= 2; ++i) {
+        int yPos = graphRect.bottom() - graphRect.height() * i / 2;
+        painter.setPen(QPen(QColor("#E0E0E0"), 1, Qt::DashLine));
+        painter.drawLine(graphRect.left() + 1, yPos, graphRect.right(), yPos);
+        painter.setPen(Qt::black);
+        painter.drawText(QRect(cell.left(), yPos - 8, marginLeft - 4, 16),
+                         Qt::AlignRight | Qt::AlignVCenter,
+                         QString::number(yMax * i / 2, 'f', 2));
+    }
+
+    // Bars: prior behind, posterior in front and narrower
+    const double barW = double(graphRect.width()) / std::max(1, bins);
+    auto barRect = [&](int b, double share, double inset) {
+        int hPix = int(share / yMax * graphRect.height());
+        int x0 = graphRect.left() + int(b * barW + inset);
+        int x1 = graphRect.left() + int((b + 1) * barW - inset);
+        return QRect(x0, graphRect.bottom() - hPix, std::max(1, x1 - x0), hPix);
+    };
+    for (int b = 0; b < bins; ++b)
+        painter.fillRect(barRect(b, h.prior[b], 0.5), PRIOR_COLOR);
+    if (m_data.weighted) {
+        QColor c = POSTERIOR_COLOR;
+        c.setAlpha(200);
+        for (int b = 0; b < bins; ++b)
+            painter.fillRect(barRect(b, h.posterior[b], barW * 0.2), c);
+    }
+
+    // Most likely set
+    if (m_data.weighted && std::isfinite(h.best) && h.hi > h.lo) {
+        int x = graphRect.left() + int((h.best - h.lo) / (h.hi - h.lo) * graphRect.width());
+        painter.setPen(QPen(BEST_COLOR, 2, Qt::DashLine));
+        painter.drawLine(x, graphRect.top(), x, graphRect.bottom());
+    }
+
+    // Range labels
+    painter.setPen(Qt::black);
+    painter.drawText(QRect(graphRect.left() - 30, graphRect.bottom() + 3, 60, 14),
+                     Qt::AlignHCenter | Qt::AlignTop, QString::number(h.lo, 'g', 4));
+    painter.drawText(QRect(graphRect.right() - 30, graphRect.bottom() + 3, 60, 14),
+                     Qt::AlignHCenter | Qt::AlignTop, QString::number(h.hi, 'g', 4));
+    if (m_data.weighted && std::isfinite(h.best))
+        painter.drawText(QRect(graphRect.left(), graphRect.bottom() + 14, graphRect.width(), 14),
+                         Qt::AlignHCenter | Qt::AlignTop,
+                         QString("max. prob. %1").arg(h.best, 0, 'g', 5));
+}
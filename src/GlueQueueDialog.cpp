@@ -5,6 +5,7 @@
 #include <QGroupBox>
 #include <QMessageBox>
 #include <QLabel>
+#include "GlueResultCache.h"
 
 GlueQueueDialog::GlueQueueDialog(const CropInfo &cropInfo,
                                  const QString  &cultivarId,
@@ -68,6 +69,10 @@ GlueQueueDialog::GlueQueueDialog(const CropInfo &cropInfo,
     m_ecoCheck = new QCheckBox;
     form->addRow("Include ECO file:", m_ecoCheck);
 
+    m_forceCheck = new QCheckBox;
+    m_forceCheck->setToolTip("Run GLUE even if an identical calibration has already finished");
+    form->addRow("Force rerun:", m_forceCheck);
+
     main->addWidget(paramBox);
 
     // Bottom buttons
@@ -190,6 +195,27 @@ void GlueQueueDialog::onAddToQueue()
     m_entry.glueFlag           = m_modeCombo->currentData().toInt();
     m_entry.ecoCalib           = m_ecoCheck->isChecked() ? "Y" : "N";
     m_entry.status             = GlueQueueStatus::Pending;
+    m_entry.forceRerun         = m_forceCheck->isChecked();
+
+    // Offer the result of an earlier run with identical inputs
+    GlueCacheHit hit;
+    if (!m_entry.forceRerun && GlueResultCache::lookup(m_entry, hit)) {
+        QMessageBox box(QMessageBox::Question, "Calibration already available",
+            QString("GLUE already calibrated %1 with identical inputs%2.\n\n%3")
+                .arg(m_cultivarId)
+                .arg(hit.finishedAt.isValid()
+                     ? " on " + hit.finishedAt.toString("yyyy-MM-dd HH:mm") : QString())
+                .arg(hit.resultCulLine),
+            QMessageBox::Cancel, this);
+        QPushButton *useBtn   = box.addButton("Use Cached Result", QMessageBox::AcceptRole);
+        QPushButton *rerunBtn = box.addButton("Run Again",         QMessageBox::DestructiveRole);
+        box.setDefaultButton(useBtn);
+        box.exec();
+        if (box.clickedButton() == rerunBtn)
+            m_entry.forceRerun = true;
+        else if (box.clickedButton() != useBtn)
+            return;
+    }
 
     accept();
 }
@@ -1,227 +1,346 @@
 #include "GlueQueueManager.h"
+#include "GlueResultCache.h"
+#include "GlueConvergenceMonitor.h"
+#include "Config.h"
 #include <QFile>
 #include <QFileInfo>
 #include <QDir>
-#include <QDirIterator>
 #include <QTextStream>
-
-static const QStringList GLUE_PHASES = {
-    "Random parameter sets have been generated",
-    "Model runs are starting",
-    "Likelihood calculation is starting",
-    "Likelihood calculation is finished",
-    "Starting calculation of posterior",
-    "round of GLUE is finished"
-};
+#include <QSettings>
+#include <QStandardPaths>
 
 GlueQueueManager::GlueQueueManager(QObject *parent)
-    : QObject(parent) {}
+    : QObject(parent)
+    , m_pipeline(new GlueJobPipeline(this))
+    , m_log(new GlueLogBuffer(GlueLogBuffer::DEFAULT_CAPACITY, this))
+{
+    int p = QSettings(Config::ORG_NAME, Config::SETTINGS_APP).value("GlueSchedulePolicy", 0).toInt();
+    if (p >= 0 && p <= static_cast<int>(GlueSchedulePolicy::Priority))
+        m_policy = static_cast<GlueSchedulePolicy>(p);
+    m_residentWorker = QSettings(Config::ORG_NAME, Config::SETTINGS_APP).value("GlueResidentWorker", false).toBool();
+
+    // Every entry runs in its own GLWork/Jobs sandbox, so the next one can be
+    // prepared while R works and snapshots are copied off the GUI thread
+    m_pipeline->setLayout(GlueJobPipeline::SandboxLayout);
+    m_pipeline->setResidentWorker(m_residentWorker);
+    connect(m_pipeline, &GlueJobPipeline::jobStarted,     this, &GlueQueueManager::onJobStarted);
+    connect(m_pipeline, &GlueJobPipeline::jobProgress,    this, &GlueQueueManager::onJobProgress);
+    connect(m_pipeline, &GlueJobPipeline::jobFinished,    this, &GlueQueueManager::onJobFinished);
+    connect(m_pipeline, &GlueJobPipeline::jobAssessed,    this, &GlueQueueManager::onJobAssessed);
+    connect(m_pipeline, &GlueJobPipeline::jobSnapshotted, this, &GlueQueueManager::onJobSnapshotted);
+    // A restart while a stopped job was still exiting is picked up here
+    connect(m_pipeline, &GlueJobPipeline::finished, this, [this] { feed(); });
+}
 
 void GlueQueueManager::addEntry(const GlueQueueEntry &entry)
 {
     m_entries.append(entry);
+    m_entries.last().estimatedSeconds = GlueScheduler::estimateSeconds(m_entries.last());
+    m_entries.last().jobId = -1;
+    emit entriesInserted(m_entries.size() - 1, m_entries.size() - 1);
     emit queueChanged();
+    if (completeFromCache(m_entries.size() - 1))
+        return;
     if (!m_running)
         start();
+    else
+        feed();
 }
 
 void GlueQueueManager::removeEntry(int index)
 {
     if (index < 0 || index >= m_entries.size()) return;
-    if (index == m_currentIndex && m_running) return; // can't remove running entry
+    if (m_entries[index].status == GlueQueueStatus::Running) return; // can't remove running entry
+    dropAhead(index);
     m_entries.removeAt(index);
-    if (m_currentIndex > index) m_currentIndex--;
+    if (m_currentIndex == index) m_currentIndex = -1;
+    else if (m_currentIndex > index) m_currentIndex--;
+    emit entryRemoved(index);
     emit queueChanged();
+    feed();
 }
 
 void GlueQueueManager::clearDone()
 {
     for (int i = m_entries.size() - 1; i >= 0; --i) {
         auto s = m_entries[i].status;
-        if (s == GlueQueueStatus::Done || s == GlueQueueStatus::Failed)
+        if (s == GlueQueueStatus::Done || s == GlueQueueStatus::Failed) {
             m_entries.removeAt(i);
+            if (m_currentIndex == i) m_currentIndex = -1;
+            else if (m_currentIndex > i) m_currentIndex--;
+            emit entryRemoved(i);
+        }
     }
     emit queueChanged();
 }
 
+void GlueQueueManager::setSchedulePolicy(GlueSchedulePolicy policy)
+{
+    if (policy == m_policy) return;
+    m_policy = policy;
+    QSettings(Config::ORG_NAME, Config::SETTINGS_APP).setValue("GlueSchedulePolicy", static_cast<int>(policy));
+    emit queueChanged();
+    feed();
+}
+
+void GlueQueueManager::setPriority(int index, int priority)
+{
+    if (index < 0 || index >= m_entries.size()) return;
+    m_entries[index].priority = priority;
+    emit entryChanged(index, PriorityField);
+    emit queueChanged();
+    feed();
+}
+
+void GlueQueueManager::setResidentWorker(bool enabled)
+{
+    if (enabled == m_residentWorker) return;
+    m_residentWorker = enabled;
+    QSettings(Config::ORG_NAME, Config::SETTINGS_APP).setValue("GlueResidentWorker", enabled);
+    m_pipeline->setResidentWorker(enabled);
+}
+
+double GlueQueueManager::remainingSeconds(int index) const
+{
+    if (index < 0 || index >= m_entries.size()) return 0;
+    const GlueQueueEntry &e = m_entries[index];
+    if (e.status == GlueQueueStatus::Pending) return e.estimatedSeconds;
+    if (e.status != GlueQueueStatus::Running || !e.startedAt.isValid()) return 0;
+    double elapsed = e.startedAt.msecsTo(QDateTime::currentDateTime()) / 1000.0;
+    return qMax(0.0, e.estimatedSeconds - elapsed);
+}
+
+double GlueQueueManager::queueRemainingSeconds() const
+{
+    double total = 0;
+    for (int i = 0; i < m_entries.size(); ++i)
+        total += remainingSeconds(i);
+    return total;
+}
+
 void GlueQueueManager::start()
 {
     if (m_running) return;
     m_running = true;
-    runNext();
+    feed();
 }
 
 void GlueQueueManager::stop()
 {
     m_running = false;
-    cleanup();
+    m_pipeline->cancel("stopped");
+    for (int i = 0; i < m_entries.size(); ++i)
+        if (m_entries[i].status == GlueQueueStatus::Pending) m_entries[i].jobId = -1;
+}
+
+// ── feeding the pipeline ──────────────────────────────────────────────────────
+int GlueQueueManager::indexOfJob(int id) const
+{
+    for (int i = 0; i < m_entries.size(); ++i)
+        if (m_entries[i].jobId == id) return i;
+    return -1;
+}
+
+// Take back an entry that was handed over but has not started
+void GlueQueueManager::dropAhead(int index)
+{
+    GlueQueueEntry &entry = m_entries[index];
+    if (entry.jobId < 0 || entry.status != GlueQueueStatus::Pending) return;
+    m_pipeline->dropJob(entry.jobId);
+    entry.jobId = -1;
 }
 
-void GlueQueueManager::runNext()
+void GlueQueueManager::feed()
 {
-    // Find next pending entry
-    m_currentIndex = -1;
+    if (!m_running) return;
+
+    // Pick the next pending entry according to the scheduling policy;
+    // an identical job may have finished since it was queued
+    int next = GlueScheduler::pickNext(m_entries, m_policy);
+    while (next >= 0 && completeFromCache(next))
+        next = GlueScheduler::pickNext(m_entries, m_policy);
+
+    bool busy = false;
     for (int i = 0; i < m_entries.size(); ++i) {
-        if (m_entries[i].status == GlueQueueStatus::Pending) {
-            m_currentIndex = i;
-            break;
-        }
+        if (m_entries[i].status == GlueQueueStatus::Running) busy = true;
+        // Priorities or the policy changed: the handed-over entry is no longer next
+        else if (i != next) dropAhead(i);
     }
-
-    if (m_currentIndex < 0) {
-        m_running = false;
+    if (next < 0) {
+        if (!busy) m_running = false;
         return;
     }
 
-    GlueQueueEntry &entry = m_entries[m_currentIndex];
-    entry.status = GlueQueueStatus::Running;
-    emit queueChanged();
-    emit entryStarted(m_currentIndex);
-
-    // Write batch file
-    QString batchPath = GlueRunner::writeBatchFile(
-        entry.cropInfo, entry.cultivarId, entry.cultivarName, entry.selectedTreatments);
-    if (batchPath.isEmpty()) {
-        entry.status   = GlueQueueStatus::Failed;
-        entry.errorMsg = "Failed to write batch file";
-        emit queueChanged();
-        emit entryFinished(m_currentIndex, false, {});
-        runNext();
-        return;
+    GlueQueueEntry &entry = m_entries[next];
+    if (entry.jobId < 0) {
+        // Fingerprint the inputs as GLUE will see them
+        entry.fingerprint = GlueResultCache::fingerprint(entry);
+        GlueJobSpec spec;
+        spec.cropInfo     = entry.cropInfo;
+        spec.cultivarId   = entry.cultivarId;
+        spec.cultivarName = entry.cultivarName;
+        spec.treatments   = entry.selectedTreatments;
+        spec.runs         = entry.runs;
+        spec.glueFlag     = entry.glueFlag;
+        spec.ecoCalib     = entry.ecoCalib;
+        spec.snapshotDir  = GlueResultCache::snapshotDirFor(entry);
+        spec.log          = m_log;   // one job runs at a time; log() shows it
+        entry.jobId = m_pipeline->addJob(spec);
     }
-
-    // Update SimulationControl.csv
-    if (!GlueRunner::updateSimControl(entry.cropInfo, entry.cultivarId,
-                                      entry.runs, entry.glueFlag, entry.ecoCalib)) {
-        entry.status   = GlueQueueStatus::Failed;
-        entry.errorMsg = "Failed to update SimulationControl.csv";
-        emit queueChanged();
-        emit entryFinished(m_currentIndex, false, {});
-        runNext();
-        return;
+    if (!m_pipeline->isRunning()) {
+        QString err;
+        if (!m_pipeline->start(&err)) qWarning("GLUE queue: %s", qPrintable(err));
     }
+}
 
-    // Launch R
-    m_lastLine  = 0;
-    m_glueRound = 0;
-    m_stderrBuf.clear();
+void GlueQueueManager::onJobStarted(int id)
+{
+    const int index = indexOfJob(id);
+    if (index < 0) return;
+    m_currentIndex = index;
+    GlueQueueEntry &entry = m_entries[index];
+    entry.status    = GlueQueueStatus::Running;
+    entry.startedAt = QDateTime::currentDateTime();
+    entry.progress  = 0;
+    entry.progressLabel.clear();
+    entry.logFile   = m_log->filePath();
+    emit entryChanged(index, StatusField);
+    emit queueChanged();
+    emit entryStarted(index);
+    emit progressUpdated(index, 0, "Starting…");
+    feed();   // prepare the next entry while this one runs
+}
 
-    m_process = new QProcess(this);
-    m_process->setWorkingDirectory(GlueRunner::GLUE_DIR);
-    connect(m_process, &QProcess::readyReadStandardOutput, this, &GlueQueueManager::onGlueOutput);
-    connect(m_process, &QProcess::readyReadStandardError,  this, &GlueQueueManager::onGlueOutput);
-    connect(m_process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this, [this](int code, QProcess::ExitStatus){ onGlueFinished(code); });
+void GlueQueueManager::onJobProgress(int id, const GlueProgress &progress)
+{
+    const int index = indexOfJob(id);
+    if (index < 0) return;
+    GlueQueueEntry &entry = m_entries[index];
+    const QString label = QString("Round %1/2 — %2").arg(progress.round + 1).arg(progress.label);
+    entry.progress      = progress.percent;
+    entry.progressLabel = label;
+    entry.resources     = m_pipeline->result(id).resources;
+    emit entryChanged(index, ProgressField);
+    emit progressUpdated(index, progress.percent, label);
+}
 
-    QString rterm = GlueRunner::findRTerm();
-    m_process->start(rterm, {"--slave", GlueRunner::GLUE_DIR + "/GLUE.r"});
+void GlueQueueManager::onJobFinished(int id, const GlueJobResult &result)
+{
+    const int index = indexOfJob(id);
+    if (index < 0) return;
+    GlueQueueEntry &entry = m_entries[index];
+    const bool success  = result.ok && !result.culLine.isEmpty();
+    entry.status        = success ? GlueQueueStatus::Done : GlueQueueStatus::Failed;
+    entry.resultCulLine = result.culLine;
+    entry.finishedAt    = QDateTime::currentDateTime();
+    entry.resources     = result.resources;
+    if (!success) {
+        entry.errorMsg = result.errorMsg.isEmpty()
+            ? "GLUE wrote no calibrated line for " + entry.cultivarId.trimmed()
+            : result.errorMsg;
+    }
 
-    m_pollTimer = new QTimer(this);
-    connect(m_pollTimer, &QTimer::timeout, this, &GlueQueueManager::onPollProgress);
-    m_pollTimer->start(800);
+    if (result.launched) {
+        // Only complete runs are representative of the per-model-run cost
+        if (success && entry.startedAt.isValid())
+            GlueScheduler::recordRun(entry, entry.startedAt.msecsTo(entry.finishedAt) / 1000.0);
+        // The copy to BackUp/<cropCode>_<cultivarId>/ runs in the background
+        entry.snapshotDir = m_pipeline->spec(id).snapshotDir;
+        appendHistory(entry);
+    }
 
-    emit progressUpdated(m_currentIndex, 0, "Starting…");
+    emit entryChanged(index, StatusField | ProgressField);
+    emit queueChanged();
+    emit entryFinished(index, success, result.culLine);
+
+    // Before the pipeline launches its next job, so a stale pick can be replaced
+    feed();
 }
 
-void GlueQueueManager::cleanup()
+void GlueQueueManager::onJobAssessed(int id, const GlueJobResult &result)
 {
-    if (m_pollTimer) { m_pollTimer->stop(); m_pollTimer->deleteLater(); m_pollTimer = nullptr; }
-    if (m_process) {
-        if (m_process->state() != QProcess::NotRunning)
-            m_process->kill();
-        m_process->deleteLater();
-        m_process = nullptr;
-    }
+    const int index = indexOfJob(id);
+    if (index < 0) return;
+    GlueQueueEntry &entry = m_entries[index];
+    entry.convergence   = result.convergence;
+    entry.needsMoreRuns = result.needsMoreRuns;
+    emit entryChanged(index, StatusField);
 }
 
-void GlueQueueManager::onGlueOutput()
+void GlueQueueManager::onJobSnapshotted(int id, bool ok)
 {
-    if (!m_process) return;
-    m_process->readAllStandardOutput();  // drain stdout (DSSAT console noise)
-    m_stderrBuf += QString::fromLatin1(m_process->readAllStandardError());
+    const int index = indexOfJob(id);
+    if (index < 0) return;
+    const GlueQueueEntry &entry = m_entries[index];
+    if (ok && entry.status == GlueQueueStatus::Done)
+        GlueResultCache::store(entry);
 }
 
-void GlueQueueManager::onPollProgress()
+// ── result cache ──────────────────────────────────────────────────────────────
+bool GlueQueueManager::completeFromCache(int index)
 {
-    QString indFile = GlueRunner::GLUE_WORK + "/ModelRunIndicator.txt";
-    QFile fi(indFile);
-    if (!fi.open(QIODevice::ReadOnly | QIODevice::Text)) return;
-    QStringList lines = QString::fromLatin1(fi.readAll()).split('\n');
-    fi.close();
+    if (index < 0 || index >= m_entries.size()) return false;
+    GlueQueueEntry &entry = m_entries[index];
+    if (entry.forceRerun || entry.status != GlueQueueStatus::Pending) return false;
 
-    int phaseInRound = 0;
-    QString label;
+    entry.fingerprint = GlueResultCache::fingerprint(entry);
+    GlueCacheHit hit;
+    if (!GlueResultCache::lookup(entry, hit)) return false;
 
-    for (int i = m_lastLine; i < lines.size(); ++i) {
-        QString line = lines[i].trimmed();
-        if (line.isEmpty()) continue;
-        if (line.startsWith("GLUE Flag: 2")) { m_glueRound = 1; phaseInRound = 0; }
-        for (int p = 0; p < GLUE_PHASES.size(); ++p) {
-            if (line.contains(GLUE_PHASES[p])) { phaseInRound = p + 1; break; }
-        }
-        if (!line.startsWith("GLUE Flag") && (
-            line.startsWith("Random parameter") || line.startsWith("Model runs") ||
-            line.startsWith("Likelihood") || line.startsWith("Starting calc") ||
-            line.contains("round of GLUE")))
-            label = line;
+    entry.status        = GlueQueueStatus::Done;
+    entry.fromCache     = true;
+    entry.resultCulLine = hit.resultCulLine;
+    entry.snapshotDir   = hit.snapshotDir;
+    entry.finishedAt    = hit.finishedAt;
+    entry.convergence   = GlueConvergenceMonitor::assessRun(hit.snapshotDir, entry.runs, &entry.needsMoreRuns);
+    if (entry.jobId >= 0) {
+        m_pipeline->dropJob(entry.jobId);
+        entry.jobId = -1;
     }
-    m_lastLine = lines.size();
-
-    int pct = (int)((m_glueRound * 6 + phaseInRound) / 12.0 * 100);
-    if (!label.isEmpty())
-        emit progressUpdated(m_currentIndex, qMin(pct, 99),
-                             QString("Round %1/2 — %2").arg(m_glueRound + 1).arg(label));
+    emit entryChanged(index, StatusField);
+    emit queueChanged();
+    emit entryFinished(index, true, hit.resultCulLine);
+    return true;
 }
 
-void GlueQueueManager::onGlueFinished(int exitCode)
+// ── history ───────────────────────────────────────────────────────────────────
+QString GlueQueueManager::historyFilePath()
 {
-    cleanup();
-
-    if (m_currentIndex < 0 || m_currentIndex >= m_entries.size()) return;
-    GlueQueueEntry &entry = m_entries[m_currentIndex];
-
-    // GLUE writes <cropCode>GRO048.CUL (full crop file) with the calibrated line updated inside
-    QString culLine;
-    QString cropCulFile = GlueRunner::GLUE_WORK + "/" + entry.cropInfo.module + ".CUL";
-    QFile cf(cropCulFile);
-    if (cf.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QString varId = entry.cultivarId;
-        for (const QString &line : QString::fromLatin1(cf.readAll()).split('\n')) {
-            if (line.startsWith(varId, Qt::CaseInsensitive)) {
-                culLine = line.trimmed();
-                break;
-            }
-        }
-        cf.close();
-    }
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return dir + "/GlueRunHistory.csv";
+}
 
-    bool success = (exitCode == 0) && !culLine.isEmpty();
-    entry.status        = success ? GlueQueueStatus::Done : GlueQueueStatus::Failed;
-    entry.resultCulLine = culLine;
-    if (!success) {
-        entry.errorMsg = QString("Exit code %1").arg(exitCode);
-        if (!m_stderrBuf.isEmpty())
-            entry.errorMsg += "\n\n" + m_stderrBuf.trimmed();
-    }
+void GlueQueueManager::appendHistory(const GlueQueueEntry &entry) const
+{
+    QString path = historyFilePath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    bool isNew = !QFile::exists(path);
 
-    // Save snapshot of all GLWork files to BackUp/<cropCode>_<cultivarId>/
-    QString snapDir = GlueRunner::GLUE_WORK + "/BackUp/"
-                      + entry.cropInfo.cropCode + "_" + entry.cultivarId;
-    QDir().mkpath(snapDir);
-    // NoIteratorFlags = no recursion, avoids BackUp/BackUp nesting
-    QDirIterator it(GlueRunner::GLUE_WORK, QDir::Files | QDir::NoSymLinks,
-                    QDirIterator::NoIteratorFlags);
-    while (it.hasNext()) {
-        QString src = it.next();
-        QString dst = snapDir + "/" + QFileInfo(src).fileName();
-        QFile::remove(dst);
-        QFile::copy(src, dst);
-    }
-    entry.snapshotDir = snapDir;
+    QFile f(path);
+    if (!f.open(QIODevice::Append | QIODevice::Text)) return;
+    QTextStream out(&f);
+    if (isNew)
+        out << "Finished,Crop,Cultivar,Name,Runs,GlueFlag,ModelRuns,Status,"
+               "WallSec,CpuSec,PeakRssMB,ReadMB,WriteMB,Phases\n";
 
-    emit queueChanged();
-    emit entryFinished(m_currentIndex, success, culLine);
+    const GlueResourceUsage &r = entry.resources;
+    QStringList phases;
+    for (const auto &ph : r.phaseSeconds)
+        phases << QString("%1=%2").arg(ph.first).arg(ph.second, 0, 'f', 1);
+    auto csv = [](QString s) { return "\"" + s.replace('"', "\"\"") + "\""; };
 
-    if (m_running)
-        runNext();
+    out << entry.finishedAt.toString(Qt::ISODate) << ','
+        << entry.cropInfo.cropCode << ','
+        << entry.cultivarId << ','
+        << csv(entry.cultivarName) << ','
+        << entry.runs << ','
+        << entry.glueFlag << ','
+        << GlueScheduler::modelRunCount(entry) << ','
+        << (entry.status == GlueQueueStatus::Done ? "Done" : "Failed") << ','
+        << QString::number(r.wallSeconds, 'f', 1) << ','
+        << (r.available ? QString::number(r.cpuSeconds, 'f', 1) : QString()) << ','
+        << (r.available ? QString::number(r.peakRssKb / 1024.0, 'f', 1) : QString()) << ','
+        << (r.available ? QString::number(r.readBytes / 1048576.0, 'f', 2) : QString()) << ','
+        << (r.available ? QString::number(r.writeBytes / 1048576.0, 'f', 2) : QString()) << ','
+        << csv(phases.join("; ")) << '\n';
 }
@@ -0,0 +1,247 @@
+#include "GlueQueueModel.h"
+#include <QApplication>
+#include <QColor>
+#include <QPainter>
+#include <QStyleOptionProgressBar>
+
+GlueQueueModel::GlueQueueModel(GlueQueueManager *manager, QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_manager(manager)
+    , m_rows(manager->entries().size())
+{
+    connect(manager, &GlueQueueManager::entriesInserted, this, &GlueQueueModel::onInserted);
+    connect(manager, &GlueQueueManager::entryRemoved,    this, &GlueQueueModel::onRemoved);
+    connect(manager, &GlueQueueManager::entryChanged,    this, &GlueQueueModel::onChanged);
+}
+
+int GlueQueueModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rows;
+}
+
+int GlueQueueModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : COL_COUNT;
+}
+
+QVariant GlueQueueModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    static const char *titles[COL_COUNT] = {"VAR#", "Name", "Treatments", "Runs", "Mode",
+                                            "Status", "Progress", "ETA"};
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole ||
+        section < 0 || section >= COL_COUNT)
+        return QVariant();
+    return QString(titles[section]);
+}
+
+// ── data ──────────────────────────────────────────────────────────────────────
+static QString modeText(const GlueQueueEntry &e)
+{
+    QString mode;
+    switch (e.glueFlag) {
+        case 2:  mode = "Phenology"; break;
+        case 3:  mode = "Growth";    break;
+        default: mode = "Both";      break;
+    }
+    if (e.priority != 0)
+        mode += QString(" [prio %1%2]").arg(e.priority > 0 ? "+" : "").arg(e.priority);
+    return mode;
+}
+
+static QString statusText(const GlueQueueEntry &e)
+{
+    switch (e.status) {
+        case GlueQueueStatus::Pending: return "Pending";
+        case GlueQueueStatus::Running: return "Running…";
+        case GlueQueueStatus::Done:
+            if (e.needsMoreRuns) return "⚠ Done, needs more runs (double-click to view)";
+            return e.fromCache ? "✓ Done (cached result, double-click to view)"
+                               : "✓ Done (double-click to view)";
+        case GlueQueueStatus::Failed:
+            return "✗ Failed (double-click for log): " + e.errorMsg.section('\n', 0, 0);
+    }
+    return QString();
+}
+
+// Selected treatments over all experiment files
+static int treatmentCount(const GlueQueueEntry &e)
+{
+    int n = 0;
+    for (const auto &list : e.selectedTreatments) n += list.size();
+    return n;
+}
+
+static int progressOf(const GlueQueueEntry &e)
+{
+    return e.status == GlueQueueStatus::Done ? 100 : e.progress;
+}
+
+QVariant GlueQueueModel::data(const QModelIndex &index, int role) const
+{
+    const auto &entries = m_manager->entries();
+    if (!index.isValid() || index.row() >= m_rows || index.row() >= entries.size())
+        return QVariant();
+    const GlueQueueEntry &e = entries[index.row()];
+    const int col = index.column();
+
+    if (role == StatusRole)   return static_cast<int>(e.status);
+    if (role == ProgressRole) return progressOf(e);
+
+    if (role == SortRole) {
+        switch (col) {
+            case COL_TREATMENTS: return treatmentCount(e);
+            case COL_RUNS:       return e.runs;
+            case COL_MODE:       return e.glueFlag * 1000 - e.priority;
+            case COL_STATUS:     return static_cast<int>(e.status);
+            case COL_PROGRESS:   return progressOf(e);
+            case COL_ETA:        return m_manager->remainingSeconds(index.row());
+            default:             return data(index, Qt::DisplayRole);
+        }
+    }
+
+    if (role == Qt::DisplayRole) {
+        switch (col) {
+            case COL_VARNUM:     return e.cultivarId;
+            case COL_NAME:       return e.cultivarName;
+            case COL_TREATMENTS: return QString("%1 treatment(s)").arg(treatmentCount(e));
+            case COL_RUNS:       return QString::number(e.runs);
+            case COL_MODE:       return modeText(e);
+            case COL_STATUS:     return statusText(e);
+            case COL_PROGRESS:
+                return e.status == GlueQueueStatus::Pending ? QString()
+                                                            : QString("%1%").arg(progressOf(e));
+            case COL_ETA:
+                switch (e.status) {
+                    case GlueQueueStatus::Pending:
+                        return "~" + GlueScheduler::formatDuration(e.estimatedSeconds);
+                    case GlueQueueStatus::Running:
+                        return GlueScheduler::formatDuration(m_manager->remainingSeconds(index.row())) + " left";
+                    default:
+                        return e.startedAt.isValid() && e.finishedAt.isValid()
+                            ? "took " + GlueScheduler::formatDuration(e.startedAt.msecsTo(e.finishedAt) / 1000.0)
+                            : QString();
+                }
+        }
+        return QVariant();
+    }
+
+    if (role == Qt::ForegroundRole && col == COL_STATUS) {
+        switch (e.status) {
+            case GlueQueueStatus::Done:    return e.needsMoreRuns ? QColor("#E65100") : QColor(Qt::darkGreen);
+            case GlueQueueStatus::Failed:  return QColor(Qt::red);
+            case GlueQueueStatus::Running: return QColor("#2196F3");
+            default:                       return QVariant();
+        }
+    }
+
+    if (role == Qt::ToolTipRole) {
+        switch (col) {
+            case COL_STATUS: {
+                if (e.status == GlueQueueStatus::Failed) return e.errorMsg;
+                if (e.status != GlueQueueStatus::Done)   return QVariant();
+                QString tip = e.fromCache
+                    ? "Inputs match the run finished " + e.finishedAt.toString("yyyy-MM-dd HH:mm")
+                      + "; R was not launched"
+                    : e.resources.summary();
+                if (!e.convergence.isEmpty()) tip += "\nPosterior: " + e.convergence;
+                return tip;
+            }
+            case COL_PROGRESS:
+                return e.progressLabel.isEmpty() ? QVariant() : QVariant(e.progressLabel);
+            case COL_ETA:
+                return QString("Estimated %1 for %2 model runs")
+                    .arg(GlueScheduler::formatDuration(e.estimatedSeconds))
+                    .arg(GlueScheduler::modelRunCount(e));
+        }
+    }
+    return QVariant();
+}
+
+// ── manager signals ───────────────────────────────────────────────────────────
+void GlueQueueModel::onInserted(int first, int last)
+{
+    beginInsertRows(QModelIndex(), first, last);
+    m_rows += last - first + 1;
+    endInsertRows();
+}
+
+void GlueQueueModel::onRemoved(int index)
+{
+    beginRemoveRows(QModelIndex(), index, index);
+    --m_rows;
+    endRemoveRows();
+}
+
+void GlueQueueModel::onChanged(int row, int fields)
+{
+    if (row < 0 || row >= m_rows) return;
+    auto changed = [this, row](int firstCol, int lastCol, const QList<int> &roles) {
+        emit dataChanged(index(row, firstCol), index(row, lastCol), roles);
+    };
+    if (fields & GlueQueueManager::StatusField)
+        changed(COL_STATUS, COL_ETA, {});
+    else if (fields & GlueQueueManager::ProgressField)
+        changed(COL_PROGRESS, COL_ETA, {Qt::DisplayRole, Qt::ToolTipRole, SortRole, ProgressRole});
+    if (fields & GlueQueueManager::PriorityField)
+        changed(COL_MODE, COL_MODE, {Qt::DisplayRole, SortRole});
+}
+
+void GlueQueueModel::refreshEta()
+{
+    const auto &entries = m_manager->entries();
+    for (int i = 0; i < m_rows && i < entries.size(); ++i)
+        if (entries[i].status == GlueQueueStatus::Running)
+            emit dataChanged(index(i, COL_ETA), index(i, COL_ETA), {Qt::DisplayRole, SortRole});
+}
+
+// ── GlueQueueFilterProxy ──────────────────────────────────────────────────────
+GlueQueueFilterProxy::GlueQueueFilterProxy(QObject *parent)
+    : QSortFilterProxyModel(parent)
+{
+    setSortRole(GlueQueueModel::SortRole);
+    setDynamicSortFilter(true);
+}
+
+void GlueQueueFilterProxy::setStatusMask(int mask)
+{
+    if (mask == m_mask) return;
+    m_mask = mask;
+    invalidateFilter();
+}
+
+bool GlueQueueFilterProxy::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    if (m_mask == ALL_STATUSES) return true;
+    QModelIndex idx = sourceModel()->index(sourceRow, 0, sourceParent);
+    const int status = sourceModel()->data(idx, GlueQueueModel::StatusRole).toInt();
+    return (m_mask & (1 << status)) != 0;
+}
+
+// ── GlueProgressDelegate ──────────────────────────────────────────────────────
+void GlueProgressDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
+                                 const QModelIndex &index) const
+{
+    const auto status = static_cast<GlueQueueStatus>(index.data(GlueQueueModel::StatusRole).toInt());
+    if (status == GlueQueueStatus::Pending) {
+        QStyledItemDelegate::paint(painter, option, index);
+        return;
+    }
+
+    QStyleOptionProgressBar bar;
+    bar.rect        = option.rect.adjusted(2, 3, -2, -3);
+    bar.palette     = option.palette;
+    bar.state       = option.state | QStyle::State_Horizontal;
+    bar.minimum     = 0;
+    bar.maximum     = 100;
+    bar.progress    = index.data(GlueQueueModel::ProgressRole).toInt();
+    bar.text        = index.data(Qt::DisplayRole).toString();
+    bar.textVisible = true;
+    bar.textAlignment = Qt::AlignCenter;
+    if (status == GlueQueueStatus::Failed)
+        bar.palette.setColor(QPalette::Highlight, QColor("#E57373"));
+
+    if (option.state & QStyle::State_Selected)
+        painter->fillRect(option.rect, option.palette.highlight());
+    QStyle *style = option.widget ? option.widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_ProgressBar, &bar, painter, option.widget);
+}
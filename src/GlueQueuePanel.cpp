@@ -13,6 +13,9 @@
 #include <QFile>
 #include <QProcess>
 #include <QFont>
+#include <QFileDialog>
+#include <QMessageBox>
+#include "GluePosteriorWidget.h"
 
 GlueQueuePanel::GlueQueuePanel(GlueQueueManager *manager, QWidget *parent)
     : QWidget(parent)
@@ -22,16 +25,23 @@ GlueQueuePanel::GlueQueuePanel(GlueQueueManager *manager, QWidget *parent)
     vbox->setContentsMargins(4, 4, 4, 4);
     vbox->setSpacing(4);
 
-    // Table
-    m_table = new QTableWidget(0, 6);
-    m_table->setHorizontalHeaderLabels({"VAR#", "Name", "Treatments", "Runs", "Mode", "Status"});
-    m_table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
-    m_table->horizontalHeader()->setSectionResizeMode(1, QHeaderView::Stretch);
-    m_table->horizontalHeader()->setSectionResizeMode(2, QHeaderView::ResizeToContents);
-    m_table->horizontalHeader()->setSectionResizeMode(3, QHeaderView::ResizeToContents);
-    m_table->horizontalHeader()->setSectionResizeMode(4, QHeaderView::ResizeToContents);
-    m_table->horizontalHeader()->setSectionResizeMode(5, QHeaderView::ResizeToContents);
+    // Table: model over the manager's entries, sorted/filtered by a proxy
+    m_model = new GlueQueueModel(manager, this);
+    m_proxy = new GlueQueueFilterProxy(this);
+    m_proxy->setSourceModel(m_model);
+    m_table = new QTableView;
+    m_table->setModel(m_proxy);
+    m_table->setItemDelegateForColumn(GlueQueueModel::COL_PROGRESS, new GlueProgressDelegate(m_table));
+    m_table->setSortingEnabled(true);
+    m_table->sortByColumn(-1, Qt::AscendingOrder);   // queue order until a header is clicked
+    QHeaderView *hh = m_table->horizontalHeader();
+    for (int c = 0; c < GlueQueueModel::COL_COUNT; ++c)
+        hh->setSectionResizeMode(c, QHeaderView::ResizeToContents);
+    hh->setSectionResizeMode(GlueQueueModel::COL_NAME, QHeaderView::Stretch);
+    hh->setSectionResizeMode(GlueQueueModel::COL_PROGRESS, QHeaderView::Fixed);
+    hh->resizeSection(GlueQueueModel::COL_PROGRESS, 110);
     m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_table->setSelectionMode(QAbstractItemView::SingleSelection);
     m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
     m_table->verticalHeader()->setDefaultSectionSize(22);
     m_table->verticalHeader()->hide();
@@ -49,67 +59,111 @@ GlueQueuePanel::GlueQueuePanel(GlueQueueManager *manager, QWidget *parent)
     m_progressLabel->hide();
     vbox->addWidget(m_progressLabel);
 
+    // Live tail of the running job's console output
+    m_logView = new GlueLogView;
+    m_logView->setBuffer(manager->log());
+    m_logView->setMinimumHeight(120);
+    m_logView->hide();
+    vbox->addWidget(m_logView, 1);
+
     // Buttons
     QHBoxLayout *btnRow = new QHBoxLayout;
     m_removeBtn    = new QPushButton("Remove Selected");
     m_clearDoneBtn = new QPushButton("Clear Done");
+    m_raiseBtn     = new QPushButton("Priority +");
+    m_lowerBtn     = new QPushButton("Priority −");
+    m_raiseBtn->setToolTip("Run the selected entry earlier (Priority ordering)");
+    m_lowerBtn->setToolTip("Run the selected entry later (Priority ordering)");
     btnRow->addWidget(m_removeBtn);
     btnRow->addWidget(m_clearDoneBtn);
+    btnRow->addWidget(m_raiseBtn);
+    btnRow->addWidget(m_lowerBtn);
+    m_logBtn = new QPushButton("Show Log");
+    m_logBtn->setCheckable(true);
+    btnRow->addWidget(m_logBtn);
+    m_exportBtn = new QPushButton("Export History…");
+    m_exportBtn->setToolTip("Save wall time, CPU, memory and I/O of every finished GLUE job as CSV");
+    btnRow->addWidget(m_exportBtn);
     btnRow->addStretch();
+
+    btnRow->addWidget(new QLabel("Show:"));
+    m_statusFilter = new QComboBox;
+    m_statusFilter->addItem("All", GlueQueueFilterProxy::ALL_STATUSES);
+    m_statusFilter->addItem("Pending", GlueQueueFilterProxy::statusBit(GlueQueueStatus::Pending));
+    m_statusFilter->addItem("Running", GlueQueueFilterProxy::statusBit(GlueQueueStatus::Running));
+    m_statusFilter->addItem("Unfinished", GlueQueueFilterProxy::statusBit(GlueQueueStatus::Pending) |
+                                          GlueQueueFilterProxy::statusBit(GlueQueueStatus::Running));
+    m_statusFilter->addItem("Done", GlueQueueFilterProxy::statusBit(GlueQueueStatus::Done));
+    m_statusFilter->addItem("Failed", GlueQueueFilterProxy::statusBit(GlueQueueStatus::Failed));
+    btnRow->addWidget(m_statusFilter);
+
+    btnRow->addWidget(new QLabel("Order:"));
+    m_policyCombo = new QComboBox;
+    for (GlueSchedulePolicy p : {GlueSchedulePolicy::Fifo, GlueSchedulePolicy::ShortestFirst,
+                                 GlueSchedulePolicy::Priority})
+        m_policyCombo->addItem(GlueScheduler::policyName(p), static_cast<int>(p));
+    m_policyCombo->setCurrentIndex(m_policyCombo->findData(static_cast<int>(manager->schedulePolicy())));
+    btnRow->addWidget(m_policyCombo);
+
+    m_residentCheck = new QCheckBox("Resident R");
+    m_residentCheck->setToolTip("Keep one R process running between jobs instead of starting "
+                                "Rscript for every entry (takes effect from the next job)");
+    m_residentCheck->setChecked(manager->residentWorker());
+    btnRow->addWidget(m_residentCheck);
+
+    m_etaLabel = new QLabel;
+    btnRow->addWidget(m_etaLabel);
     vbox->addLayout(btnRow);
 
     connect(m_removeBtn,    &QPushButton::clicked, this, &GlueQueuePanel::onRemove);
     connect(m_clearDoneBtn, &QPushButton::clicked, this, &GlueQueuePanel::onClearDone);
+    connect(m_raiseBtn,     &QPushButton::clicked, this, &GlueQueuePanel::onRaisePriority);
+    connect(m_lowerBtn,     &QPushButton::clicked, this, &GlueQueuePanel::onLowerPriority);
+    connect(m_exportBtn,    &QPushButton::clicked, this, &GlueQueuePanel::onExportHistory);
+    connect(m_logBtn, &QPushButton::toggled, this, [this](bool checked) {
+        m_logView->setVisible(checked);
+        m_logBtn->setText(checked ? "Hide Log" : "Show Log");
+    });
+    connect(m_policyCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &GlueQueuePanel::onPolicyChanged);
+    connect(m_residentCheck, &QCheckBox::toggled, manager, &GlueQueueManager::setResidentWorker);
+    connect(m_statusFilter, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int i) {
+        m_proxy->setStatusMask(m_statusFilter->itemData(i).toInt());
+    });
+
+    // Running job's ETA counts down between queue events
+    m_etaTimer = new QTimer(this);
+    m_etaTimer->setInterval(5000);
+    connect(m_etaTimer, &QTimer::timeout, this, &GlueQueuePanel::updateEta);
 
     connect(manager, &GlueQueueManager::queueChanged,   this, &GlueQueuePanel::refresh);
     connect(manager, &GlueQueueManager::progressUpdated,
-            this, [this](int /*index*/, int pct, const QString &label) {
+            this, [this](int index, int pct, const QString &label) {
         m_progressBar->setValue(pct);
-        m_progressLabel->setText(label);
+        QString text = label;
+        const auto &entries = m_manager->entries();
+        if (index >= 0 && index < entries.size() && entries[index].resources.available) {
+            const GlueResourceUsage &r = entries[index].resources;
+            text += QString("   (CPU %1 s, RSS %2 MB)")
+                        .arg(r.cpuSeconds, 0, 'f', 0).arg(r.peakRssKb / 1024.0, 0, 'f', 0);
+        }
+        m_progressLabel->setText(text);
     });
 
-    connect(m_table, &QTableWidget::cellDoubleClicked, this, &GlueQueuePanel::onRowDoubleClicked);
+    connect(m_table, &QTableView::doubleClicked, this, &GlueQueuePanel::onRowDoubleClicked);
+    refresh();
 }
 
+// Rows update themselves through the model; this only tracks the running state
 void GlueQueuePanel::refresh()
 {
-    const auto &entries = m_manager->entries();
-    m_table->setRowCount(entries.size());
-
     bool anyRunning = false;
-    for (int i = 0; i < entries.size(); ++i) {
-        const GlueQueueEntry &e = entries[i];
-
-        m_table->setItem(i, 0, new QTableWidgetItem(e.cultivarId));
-        m_table->setItem(i, 1, new QTableWidgetItem(e.cultivarName));
-        m_table->setItem(i, 2, new QTableWidgetItem(
-            QString("%1 treatment(s)").arg(e.selectedTreatments.size())));
-        m_table->setItem(i, 3, new QTableWidgetItem(QString::number(e.runs)));
-
-        QString modeStr;
-        switch (e.glueFlag) {
-            case 2:  modeStr = "Phenology"; break;
-            case 3:  modeStr = "Growth";    break;
-            default: modeStr = "Both";      break;
-        }
-        m_table->setItem(i, 4, new QTableWidgetItem(modeStr));
-
-        QString statusStr;
-        switch (e.status) {
-            case GlueQueueStatus::Pending: statusStr = "Pending";  break;
-            case GlueQueueStatus::Running: statusStr = "Running…"; anyRunning = true; break;
-            case GlueQueueStatus::Done:    statusStr = "✓ Done (double-click to view)"; break;
-            case GlueQueueStatus::Failed:  statusStr = "✗ Failed (double-click for log): " + e.errorMsg; break;
-        }
-        auto *statusItem = new QTableWidgetItem(statusStr);
-        if (e.status == GlueQueueStatus::Done)
-            statusItem->setForeground(Qt::darkGreen);
-        else if (e.status == GlueQueueStatus::Failed)
-            statusItem->setForeground(Qt::red);
-        else if (e.status == GlueQueueStatus::Running)
-            statusItem->setForeground(QColor("#2196F3"));
-        m_table->setItem(i, 5, statusItem);
-    }
+    for (const GlueQueueEntry &e : m_manager->entries())
+        if (e.status == GlueQueueStatus::Running) anyRunning = true;
+    updateEta();
+
+    if (anyRunning) m_etaTimer->start();
+    else            m_etaTimer->stop();
 
     m_progressBar->setVisible(anyRunning);
     m_progressLabel->setVisible(anyRunning);
@@ -119,9 +173,69 @@ void GlueQueuePanel::refresh()
     }
 }
 
+void GlueQueuePanel::updateEta()
+{
+    m_model->refreshEta();
+    double total = m_manager->queueRemainingSeconds();
+    m_etaLabel->setText(total > 0
+        ? QString("Queue ETA: %1").arg(GlueScheduler::formatDuration(total))
+        : QString());
+}
+
+int GlueQueuePanel::currentEntry() const
+{
+    QModelIndex idx = m_proxy->mapToSource(m_table->currentIndex());
+    return idx.isValid() ? idx.row() : -1;
+}
+
+void GlueQueuePanel::selectEntry(int index)
+{
+    QModelIndex idx = m_proxy->mapFromSource(m_model->index(index, 0));
+    if (idx.isValid()) m_table->selectRow(idx.row());
+}
+
+void GlueQueuePanel::onPolicyChanged(int index)
+{
+    m_manager->setSchedulePolicy(
+        static_cast<GlueSchedulePolicy>(m_policyCombo->itemData(index).toInt()));
+}
+
+void GlueQueuePanel::onRaisePriority()
+{
+    int row = currentEntry();
+    const auto &entries = m_manager->entries();
+    if (row < 0 || row >= entries.size()) return;
+    m_manager->setPriority(row, entries[row].priority + 1);
+    selectEntry(row);
+}
+
+void GlueQueuePanel::onLowerPriority()
+{
+    int row = currentEntry();
+    const auto &entries = m_manager->entries();
+    if (row < 0 || row >= entries.size()) return;
+    m_manager->setPriority(row, entries[row].priority - 1);
+    selectEntry(row);
+}
+
+void GlueQueuePanel::onExportHistory()
+{
+    QString src = GlueQueueManager::historyFilePath();
+    if (!QFile::exists(src)) {
+        QMessageBox::information(this, "Export History", "No GLUE jobs have finished on this machine yet.");
+        return;
+    }
+    QString dst = QFileDialog::getSaveFileName(this, "Export GLUE Run History",
+                                               "GlueRunHistory.csv", "CSV files (*.csv)");
+    if (dst.isEmpty()) return;
+    QFile::remove(dst);
+    if (!QFile::copy(src, dst))
+        QMessageBox::warning(this, "Export History", "Could not write " + dst);
+}
+
 void GlueQueuePanel::onRemove()
 {
-    int row = m_table->currentRow();
+    int row = currentEntry();
     if (row < 0) return;
     const auto &entries = m_manager->entries();
     if (row >= entries.size()) return;
@@ -134,8 +248,9 @@ void GlueQueuePanel::onClearDone()
     m_manager->clearDone();
 }
 
-void GlueQueuePanel::onRowDoubleClicked(int row, int /*col*/)
+void GlueQueuePanel::onRowDoubleClicked(const QModelIndex &index)
 {
+    const int row = m_proxy->mapToSource(index).row();
     const auto &entries = m_manager->entries();
     if (row < 0 || row >= entries.size()) return;
     const GlueQueueEntry &e = entries[row];
@@ -229,6 +344,44 @@ void GlueQueuePanel::onRowDoubleClicked(int row, int /*col*/)
     if (e.status == GlueQueueStatus::Failed)
         tabs->setCurrentWidget(logEdit);
 
+    // Log: tail of the job's console output (full file via the context menu)
+    QString logPath = e.snapshotDir.isEmpty() ? QString() : e.snapshotDir + "/GlueRun.log";
+    if (logPath.isEmpty() || !QFile::exists(logPath)) logPath = e.logFile;
+    if (!logPath.isEmpty() && QFile::exists(logPath)) {
+        GlueLogBuffer *logBuf = new GlueLogBuffer(GlueLogBuffer::DEFAULT_CAPACITY, &dlg);
+        logBuf->loadTail(logPath);
+        GlueLogView *logView = new GlueLogView;
+        logView->setBuffer(logBuf);
+        tabs->addTab(logView, "Log");
+    }
+
+    // Tab 5: Resources — totals for the R process tree and wall time per phase
+    const GlueResourceUsage &r = e.resources;
+    QString resText = QString("Model runs      : %1\n").arg(GlueScheduler::modelRunCount(e));
+    resText += QString("Wall time       : %1\n").arg(GlueScheduler::formatDuration(r.wallSeconds));
+    if (r.available) {
+        resText += QString("CPU time        : %1 s\n").arg(r.cpuSeconds, 0, 'f', 1);
+        resText += QString("Peak RSS        : %1 MB\n").arg(r.peakRssKb / 1024.0, 0, 'f', 1);
+        resText += QString("Storage read    : %1 MB\n").arg(r.readBytes / 1048576.0, 0, 'f', 2);
+        resText += QString("Storage written : %1 MB\n").arg(r.writeBytes / 1048576.0, 0, 'f', 2);
+    } else {
+        resText += "(CPU, memory and I/O sampling is only available on Linux)\n";
+    }
+    if (!r.phaseSeconds.isEmpty()) {
+        resText += "\nWall time per phase:\n";
+        for (const auto &ph : r.phaseSeconds)
+            resText += QString("  %1  %2\n").arg(GlueScheduler::formatDuration(ph.second), 10).arg(ph.first);
+    }
+    QTextEdit *resEdit = new QTextEdit;
+    resEdit->setReadOnly(true);
+    resEdit->setFont(QFont("Courier New", 9));
+    resEdit->setPlainText(resText);
+    tabs->addTab(resEdit, "Resources");
+
+    // Tab 6: Posterior — per-parameter distributions streamed from the snapshot
+    if (QWidget *postTab = GluePosteriorWidget::createRoundBrowser(e.snapshotDir))
+        tabs->addTab(postTab, "Posterior");
+
     vl->addWidget(tabs, 1);
 
     QPushButton *closeBtn = new QPushButton("Close");
@@ -0,0 +1,228 @@
+#include "GlueRWorker.h"
+#include "GlueRunner.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+// Loop variables are dot-named so the clean-up ls() between jobs skips them
+static const char *WORKER_SCRIPT = R"R(# Resident GLUE worker started by the Genetics Editor queue.
+.con  <- file("stdin", open = "r")
+.home <- getwd()
+cat("@@READY\n"); flush(stdout())
+repeat {
+  .line <- readLines(.con, n = 1, warn = FALSE)
+  if (length(.line) == 0 || identical(.line, "QUIT")) break
+  .job <- strsplit(.line, "\t", fixed = TRUE)[[1]]
+  if (length(.job) < 3 || .job[1] != "JOB") next
+  .status <- tryCatch({
+    if (length(.job) >= 4) setwd(.job[4])
+    source(.job[3], local = new.env(parent = globalenv()), chdir = length(.job) < 4)
+    0L
+  }, error = function(e) {
+    message("Error: ", conditionMessage(e))
+    1L
+  })
+  setwd(.home)
+  rm(list = ls(globalenv()), envir = globalenv())
+  invisible(gc())
+  flush(stderr())
+  # Own line even when the job's last output had no newline
+  cat(sprintf("\n@@DONE\t%s\t%d\n", .job[2], .status)); flush(stdout())
+}
+)R";
+
+GlueRWorker::GlueRWorker(QObject *parent)
+    : QObject(parent)
+{
+}
+
+GlueRWorker::~GlueRWorker()
+{
+    if (m_proc) {
+        m_proc->disconnect(this);
+        if (m_proc->state() != QProcess::NotRunning) {
+            m_proc->kill();
+            m_proc->waitForFinished(2000);
+        }
+    }
+}
+
+QString GlueRWorker::scriptPath()
+{
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return dir + "/GlueWorker.R";
+}
+
+qint64 GlueRWorker::processId() const
+{
+    return m_proc ? m_proc->processId() : 0;
+}
+
+// ── submit ────────────────────────────────────────────────────────────────────
+bool GlueRWorker::submit(const QString &scriptPath, const QString &workingDir)
+{
+    if (isBusy()) return false;
+    m_script  = scriptPath;
+    m_workDir = workingDir;
+    m_sent    = false;
+    m_retried = false;
+    if (!ensureProcess()) {
+        finishJob(-1, "Cannot start R (" + GlueRunner::findRTerm() + ")");
+        return true;
+    }
+    if (m_ready) sendJob();   // otherwise sent on @@READY
+    return true;
+}
+
+bool GlueRWorker::ensureProcess()
+{
+    if (m_proc && m_proc->state() != QProcess::NotRunning) return true;
+
+    QString path = scriptPath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) return false;
+    f.write(WORKER_SCRIPT);
+    f.close();
+
+    if (m_proc) m_proc->deleteLater();
+    m_proc = new QProcess(this);
+    m_ready = false;
+    m_jobsServed = 0;
+    m_lineBuf.clear();
+    m_blankHeld = false;
+    m_proc->setWorkingDirectory(GlueRunner::GLUE_DIR);
+    connect(m_proc, &QProcess::readyReadStandardOutput, this, &GlueRWorker::onStdout);
+    connect(m_proc, &QProcess::readyReadStandardError,  this, &GlueRWorker::onStderr);
+    connect(m_proc, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, &GlueRWorker::onProcessFinished);
+    connect(m_proc, &QProcess::errorOccurred, this, [this](QProcess::ProcessError e) {
+        if (e == QProcess::FailedToStart && isBusy())
+            finishJob(-1, "Cannot start R (" + (m_program.isEmpty() ? GlueRunner::findRTerm() : m_program) + ")");
+    });
+    if (m_program.isEmpty())
+        m_proc->start(GlueRunner::findRTerm(), {"--slave", path});
+    else
+        m_proc->start(m_program, m_programArgs + QStringList{path});
+    return true;
+}
+
+void GlueRWorker::sendJob()
+{
+    if (!isBusy() || m_sent || !m_proc) return;
+    m_sent = true;
+    ++m_jobId;
+    QByteArray line = "JOB\t" + QByteArray::number(m_jobId) + '\t'
+                    + QDir::fromNativeSeparators(m_script).toUtf8();
+    if (!m_workDir.isEmpty())
+        line += '\t' + QDir::fromNativeSeparators(m_workDir).toUtf8();
+    m_proc->write(line + '\n');
+    emit jobStarted(m_proc->processId());
+}
+
+// ── process I/O ───────────────────────────────────────────────────────────────
+void GlueRWorker::onStdout()
+{
+    if (!m_proc) return;
+    // Everything except the @@ markers is DSSAT/R console output for the job log
+    m_lineBuf += m_proc->readAllStandardOutput();
+    QByteArray passOn;
+    int nl;
+    while ((nl = m_lineBuf.indexOf('\n')) >= 0) {
+        QByteArray raw = m_lineBuf.left(nl + 1);
+        m_lineBuf.remove(0, nl + 1);
+        // The marker follows a newline of its own; an empty line may be just that
+        if (raw.trimmed().isEmpty()) {
+            if (m_blankHeld) passOn += '\n';
+            m_blankHeld = true;
+            continue;
+        }
+        // Should the marker still share a line with job output, the text in
+        // front of it is the job's
+        const int done = raw.indexOf("@@DONE\t");
+        if (m_blankHeld && done != 0) passOn += '\n';
+        m_blankHeld = false;
+        QByteArray line = raw.trimmed();
+        if (line == "@@READY") {
+            m_ready = true;
+            sendJob();
+        } else if (done >= 0) {
+            passOn += raw.left(done);
+            if (isBusy() && !passOn.isEmpty()) emit outputReceived(passOn, false);
+            passOn.clear();
+            QList<QByteArray> tok = raw.mid(done).trimmed().split('\t');
+            if (tok.size() >= 3 && tok[1].toInt() == m_jobId && m_sent) {
+                ++m_jobsServed;
+                finishJob(tok[2].toInt());
+            }
+        } else {
+            passOn += raw;
+        }
+    }
+    // Long partial lines cannot be a marker; pass them on instead of holding them
+    if (m_lineBuf.size() > 4096) {
+        passOn += m_lineBuf;
+        m_lineBuf.clear();
+    }
+    if (isBusy() && !passOn.isEmpty()) emit outputReceived(passOn, false);
+}
+
+void GlueRWorker::onStderr()
+{
+    if (!m_proc) return;
+    QByteArray data = m_proc->readAllStandardError();
+    if (isBusy()) emit outputReceived(data, true);
+}
+
+void GlueRWorker::onProcessFinished(int exitCode, QProcess::ExitStatus status)
+{
+    m_ready = false;
+    if (!isBusy()) return;   // idle interpreter exited (shutdown or killed)
+
+    // A job that kills an interpreter which already served others is retried
+    // once on a fresh process, in case an earlier job left R in a bad state
+    bool abnormal = status == QProcess::CrashExit || exitCode != 0;
+    if (abnormal && m_jobsServed > 0 && !m_retried) {
+        m_retried = true;
+        m_sent = false;
+        emit outputReceived("R worker exited; retrying on a fresh interpreter\n", true);
+        if (ensureProcess()) return;
+    }
+    if (status == QProcess::CrashExit)
+        finishJob(exitCode ? exitCode : -1, "R worker crashed");
+    else
+        finishJob(exitCode);   // GLUE.r may end with quit(status = …)
+}
+
+void GlueRWorker::finishJob(int exitCode, const QString &message)
+{
+    m_script.clear();
+    m_sent = false;
+    emit jobFinished(exitCode, message);
+}
+
+// ── abort / shutdown ──────────────────────────────────────────────────────────
+void GlueRWorker::abort()
+{
+    if (!isBusy()) return;
+    m_script.clear();   // so onProcessFinished() treats the exit as idle
+    if (m_proc && m_proc->state() != QProcess::NotRunning) {
+        m_proc->kill();
+        m_proc->waitForFinished(2000);
+    }
+    m_ready = false;
+    m_sent  = false;
+    emit jobFinished(-1, "Stopped");
+}
+
+void GlueRWorker::shutdown()
+{
+    if (!m_proc || isBusy()) return;
+    if (m_proc->state() == QProcess::Running) {
+        m_proc->write("QUIT\n");
+        m_proc->closeWriteChannel();
+        if (!m_proc->waitForFinished(2000)) m_proc->kill();
+    }
+    m_ready = false;
+}
@@ -0,0 +1,167 @@
+#include "GlueResourceSampler.h"
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QMultiHash>
+#include <QStringList>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+QString GlueResourceUsage::summary() const
+{
+    if (!available) return QString("wall %1 s (resource sampling unavailable)").arg(wallSeconds, 0, 'f', 0);
+    return QString("wall %1 s, CPU %2 s, peak RSS %3 MB, read %4 MB, written %5 MB")
+        .arg(wallSeconds, 0, 'f', 0)
+        .arg(cpuSeconds, 0, 'f', 1)
+        .arg(peakRssKb / 1024.0, 0, 'f', 0)
+        .arg(readBytes / 1048576.0, 0, 'f', 1)
+        .arg(writeBytes / 1048576.0, 0, 'f', 1);
+}
+
+bool GlueResourceSampler::isSupported()
+{
+#ifdef Q_OS_LINUX
+    return QFile::exists("/proc/self/stat");
+#else
+    return false;
+#endif
+}
+
+void GlueResourceSampler::start(qint64 rootPid)
+{
+    m_rootPid = rootPid;
+    m_usage = GlueResourceUsage();
+    m_usage.available = isSupported() && rootPid > 0;
+    m_wall.start();
+    m_phase = "Startup";
+    m_phaseTimer.start();
+
+    // A resident process (GlueRWorker) has counters from earlier jobs
+    m_baseCpu = 0;
+    m_baseRead = m_baseWrite = 0;
+    qint64 rss = 0;
+    if (m_usage.available)
+        readTree(m_baseCpu, rss, m_baseRead, m_baseWrite);
+}
+
+#ifdef Q_OS_LINUX
+namespace {
+struct ProcStat {
+    qint64 ppid   = 0;
+    qint64 ticks  = 0;   // utime + stime + cutime + cstime
+    qint64 rssPages = 0;
+};
+
+bool readStat(qint64 pid, ProcStat &st)
+{
+    QFile f(QString("/proc/%1/stat").arg(pid));
+    if (!f.open(QIODevice::ReadOnly)) return false;
+    QByteArray data = f.readAll();
+    // comm may contain spaces/parens; fields resume after the last ')'
+    int close = data.lastIndexOf(')');
+    if (close < 0) return false;
+    QList<QByteArray> fields = data.mid(close + 2).split(' ');
+    // fields[0] = state (stat field 3), so stat field N is fields[N - 3]
+    if (fields.size() < 22) return false;
+    st.ppid     = fields[1].toLongLong();
+    st.ticks    = fields[11].toLongLong() + fields[12].toLongLong()
+                + fields[13].toLongLong() + fields[14].toLongLong();
+    st.rssPages = fields[21].toLongLong();
+    return true;
+}
+
+void readIo(qint64 pid, qint64 &readBytes, qint64 &writeBytes)
+{
+    QFile f(QString("/proc/%1/io").arg(pid));
+    if (!f.open(QIODevice::ReadOnly)) return;
+    for (const QByteArray &line : f.readAll().split('\n')) {
+        if (line.startsWith("read_bytes:"))
+            readBytes += line.mid(11).trimmed().toLongLong();
+        else if (line.startsWith("write_bytes:"))
+            writeBytes += line.mid(12).trimmed().toLongLong();
+    }
+}
+} // namespace
+#endif
+
+bool GlueResourceSampler::readTree(double &cpuSeconds, qint64 &rssKb,
+                                   qint64 &readBytes, qint64 &writeBytes) const
+{
+#ifdef Q_OS_LINUX
+    // Build the parent -> children map for the whole system, then walk the tree
+    QHash<qint64, ProcStat> stats;
+    QMultiHash<qint64, qint64> children;
+    const QStringList pids = QDir("/proc").entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &name : pids) {
+        bool ok = false;
+        qint64 pid = name.toLongLong(&ok);
+        if (!ok) continue;
+        ProcStat st;
+        if (!readStat(pid, st)) continue;
+        stats.insert(pid, st);
+        children.insert(st.ppid, pid);
+    }
+    if (!stats.contains(m_rootPid)) return false;  // already exited
+
+    static const double TICKS = static_cast<double>(sysconf(_SC_CLK_TCK));
+    static const qint64 PAGE_KB = sysconf(_SC_PAGESIZE) / 1024;
+
+    qint64 ticks = 0, rssPages = 0, rd = 0, wr = 0;
+    QList<qint64> stack{m_rootPid};
+    while (!stack.isEmpty()) {
+        qint64 pid = stack.takeLast();
+        const ProcStat &st = stats[pid];
+        ticks    += st.ticks;
+        rssPages += st.rssPages;
+        readIo(pid, rd, wr);
+        for (auto it = children.find(pid); it != children.end() && it.key() == pid; ++it)
+            stack.append(it.value());
+    }
+    cpuSeconds = ticks / TICKS;
+    rssKb      = rssPages * PAGE_KB;
+    readBytes  = rd;
+    writeBytes = wr;
+    return true;
+#else
+    Q_UNUSED(cpuSeconds); Q_UNUSED(rssKb); Q_UNUSED(readBytes); Q_UNUSED(writeBytes);
+    return false;
+#endif
+}
+
+void GlueResourceSampler::sample()
+{
+    if (!m_usage.available) return;
+    m_usage.wallSeconds = m_wall.elapsed() / 1000.0;
+
+    double cpu = 0;
+    qint64 rss = 0, rd = 0, wr = 0;
+    if (!readTree(cpu, rss, rd, wr)) return;  // keep last totals
+
+    // Totals are monotonic in principle; a child exiting between the directory
+    // scan and its parent's wait() can briefly drop them, so keep the maximum.
+    m_usage.cpuSeconds = qMax(m_usage.cpuSeconds, cpu - m_baseCpu);
+    m_usage.peakRssKb  = qMax(m_usage.peakRssKb, rss);
+    m_usage.readBytes  = qMax(m_usage.readBytes, rd - m_baseRead);
+    m_usage.writeBytes = qMax(m_usage.writeBytes, wr - m_baseWrite);
+}
+
+void GlueResourceSampler::markPhase(const QString &phase)
+{
+    if (phase == m_phase) return;
+    if (!m_phase.isEmpty())
+        m_usage.phaseSeconds.append({m_phase, m_phaseTimer.elapsed() / 1000.0});
+    m_phase = phase;
+    m_phaseTimer.restart();
+}
+
+GlueResourceUsage GlueResourceSampler::finish()
+{
+    sample();
+    m_usage.wallSeconds = m_wall.isValid() ? m_wall.elapsed() / 1000.0 : 0.0;
+    if (!m_phase.isEmpty())
+        m_usage.phaseSeconds.append({m_phase, m_phaseTimer.elapsed() / 1000.0});
+    m_phase.clear();
+    return m_usage;
+}
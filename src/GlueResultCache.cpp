@@ -0,0 +1,152 @@
+#include "GlueResultCache.h"
+#include "GlueQueueManager.h"
+#include "CulParser.h"
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
+#include <QSettings>
+#include <QSet>
+#include <algorithm>
+
+const char *GlueResultCache::MANIFEST_FILE = "GlueCache.ini";
+
+// Bump when the fingerprint recipe changes so old manifests stop matching
+static const char *FINGERPRINT_VERSION = "glue-cache-v1";
+
+// Feed a text file into the hash, skipping blank lines and "!" comments
+// (except the "!Calibration" line, which GLUE reads).
+static bool addTextFile(QCryptographicHash &h, const QString &path)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) return false;
+    h.addData(QFileInfo(path).fileName().toUpper().toLatin1());
+    h.addData("\n", 1);
+    for (const QByteArray &raw : f.readAll().split('\n')) {
+        QByteArray line = raw.trimmed();
+        if (line.isEmpty()) continue;
+        if (line.startsWith('!') && !line.toLower().startsWith("!calibration")) continue;
+        h.addData(line);
+        h.addData("\n", 1);
+    }
+    return true;
+}
+
+static QString paramKey(const std::optional<double> &v)
+{
+    return v.has_value() ? QString::number(*v, 'g', 10) : QStringLiteral("-");
+}
+
+// CUL file: header lines and every row, except the parameters of the target
+// cultivar that this GLUEFlag re-estimates.
+static bool addCulFile(QCryptographicHash &h, const GlueQueueEntry &entry)
+{
+    QStringList headers;
+    QVector<CulRow> rows = CulParser::parse(entry.cropInfo.culFile, headers);
+    if (rows.isEmpty()) return false;
+
+    for (const QString &hl : headers) {
+        QString t = hl.trimmed();
+        if (t.startsWith('!') && !t.startsWith("!calibration", Qt::CaseInsensitive)) continue;
+        h.addData(t.toLatin1());
+        h.addData("\n", 1);
+    }
+
+    QSet<QString> calibrated;
+    if (entry.glueFlag == 1 || entry.glueFlag == 2) calibrated << "P";
+    if (entry.glueFlag == 1 || entry.glueFlag == 3) calibrated << "G";
+    QMap<QString, QString> types = CulParser::calibrationTypes(headers);
+
+    for (const CulRow &r : rows) {
+        bool target = r.varNum.trimmed().compare(entry.cultivarId.trimmed(), Qt::CaseInsensitive) == 0;
+        QStringList parts{r.varNum.trimmed(), r.vrName.trimmed(), r.expNo.trimmed(), r.ecoNum.trimmed()};
+        for (int i = 0; i < r.params.size(); ++i) {
+            if (target && i < CUL_PARAM_NAMES.size()
+                && calibrated.contains(types.value(CUL_PARAM_NAMES[i]))) {
+                parts << "*";
+                continue;
+            }
+            parts << paramKey(r.params[i]);
+        }
+        h.addData(parts.join('|').toLatin1());
+        h.addData("\n", 1);
+    }
+    return true;
+}
+
+// ── fingerprint ───────────────────────────────────────────────────────────────
+QString GlueResultCache::fingerprint(const GlueQueueEntry &entry)
+{
+    QCryptographicHash h(QCryptographicHash::Sha256);
+    h.addData(FINGERPRINT_VERSION, int(qstrlen(FINGERPRINT_VERSION)));
+
+    QString params = QString("\n%1|%2|%3|%4|%5|%6\n")
+        .arg(entry.cropInfo.module, entry.cropInfo.modelId, entry.cultivarId.trimmed())
+        .arg(entry.runs).arg(entry.glueFlag).arg(entry.ecoCalib);
+    h.addData(params.toLatin1());
+
+    if (!addCulFile(h, entry)) return {};
+    if (!addTextFile(h, entry.cropInfo.ecoFile)) return {};
+    if (!addTextFile(h, entry.cropInfo.speFile)) return {};
+
+    // TreatmentMap is ordered by path; treatment numbers are sorted per file
+    for (auto it = entry.selectedTreatments.begin(); it != entry.selectedTreatments.end(); ++it) {
+        if (!addTextFile(h, it.key())) return {};
+        QList<int> trts;
+        for (const TreatmentEntry &t : it.value()) trts << t.number;
+        std::sort(trts.begin(), trts.end());
+        QStringList nums;
+        for (int n : trts) nums << QString::number(n);
+        h.addData(("TRT " + nums.join(',') + "\n").toLatin1());
+    }
+    return QString::fromLatin1(h.result().toHex());
+}
+
+QString GlueResultCache::snapshotDirFor(const GlueQueueEntry &entry)
+{
+    return GlueRunner::GLUE_WORK + "/BackUp/" + entry.cropInfo.cropCode + "_" + entry.cultivarId;
+}
+
+// ── lookup ────────────────────────────────────────────────────────────────────
+bool GlueResultCache::lookup(const GlueQueueEntry &entry, GlueCacheHit &hit)
+{
+    if (GlueRunner::GLUE_WORK.isEmpty()) return false;
+    QString dir = snapshotDirFor(entry);
+    QString manifest = dir + "/" + MANIFEST_FILE;
+    if (!QFile::exists(manifest)) return false;
+
+    QSettings m(manifest, QSettings::IniFormat);
+    QString stored = m.value("fingerprint").toString();
+    QString culLine = m.value("resultCulLine").toString();
+    if (stored.isEmpty() || culLine.isEmpty()) return false;
+
+    QString fp = entry.fingerprint.isEmpty() ? fingerprint(entry) : entry.fingerprint;
+    if (fp.isEmpty() || fp != stored) return false;
+
+    hit.resultCulLine = culLine;
+    hit.snapshotDir   = dir;
+    hit.finishedAt    = QDateTime::fromString(m.value("finishedAt").toString(), Qt::ISODate);
+    return true;
+}
+
+// ── store / invalidate ────────────────────────────────────────────────────────
+bool GlueResultCache::store(const GlueQueueEntry &entry)
+{
+    if (entry.fingerprint.isEmpty() || entry.resultCulLine.isEmpty() || entry.snapshotDir.isEmpty())
+        return false;
+    QSettings m(entry.snapshotDir + "/" + MANIFEST_FILE, QSettings::IniFormat);
+    m.clear();
+    m.setValue("fingerprint",   entry.fingerprint);
+    m.setValue("resultCulLine", entry.resultCulLine);
+    m.setValue("cultivarName",  entry.cultivarName);
+    m.setValue("runs",          entry.runs);
+    m.setValue("glueFlag",      entry.glueFlag);
+    m.setValue("finishedAt",    entry.finishedAt.toString(Qt::ISODate));
+    m.sync();
+    return m.status() == QSettings::NoError;
+}
+
+void GlueResultCache::invalidate(const QString &snapshotDir)
+{
+    if (!snapshotDir.isEmpty())
+        QFile::remove(snapshotDir + "/" + MANIFEST_FILE);
+}
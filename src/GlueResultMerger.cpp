@@ -0,0 +1,137 @@
+#include "GlueResultMerger.h"
+#include "BackupManager.h"
+#include "GlueQueueManager.h"
+#include "GlueResultCache.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QSettings>
+
+QString GlueMergeResult::summary() const
+{
+    QString s = QString("%1 updated, %2 added, %3 already current").arg(updated).arg(added).arg(unchanged);
+    if (!skipped.isEmpty()) s += QString(", %1 skipped").arg(skipped.size());
+    return s;
+}
+
+// ── mergeRows ─────────────────────────────────────────────────────────────────
+GlueMergeResult GlueResultMerger::mergeRows(QVector<CulRow> &rows, int numParams,
+                                            const QStringList &culLines, bool addMissing,
+                                            const IdentifierIndex *varIndex)
+{
+    GlueMergeResult result;
+    // A shared copy of the caller's index; only an added row detaches it
+    IdentifierIndex byVar;
+    if (varIndex && varIndex->rowCount() == rows.size()) {
+        byVar = *varIndex;
+    } else {
+        QVector<QString> ids;
+        ids.reserve(rows.size());
+        for (const CulRow &r : rows)
+            ids << r.varNum;
+        byVar.reset(ids);
+    }
+
+    // History comments show the rows as they were before this merge
+    const QVector<ParamFormat> fmts = CulParser::inferFormats(rows, numParams);
+    const QString ts = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm");
+
+    for (const QString &line : culLines) {
+        CulRow in = CulParser::parseLine(line);
+        if (in.varNum.isEmpty() || in.isMinMax || in.params.isEmpty()) {
+            if (!line.trimmed().isEmpty()) result.skipped << line.trimmed();
+            continue;
+        }
+        const int existing = byVar.rowOf(in.varNum);
+
+        if (existing < 0) {
+            if (!addMissing) {
+                result.skipped << line.trimmed();
+                continue;
+            }
+            in.params.resize(numParams);
+            in.paramStrs.resize(numParams);
+            byVar.insert(rows.size(), in.varNum);
+            result.changedRows << rows.size();
+            rows.append(in);
+            ++result.added;
+            continue;
+        }
+
+        CulRow &row = rows[existing];
+        bool same = true;
+        for (int p = 0; p < qMin(numParams, in.params.size()); ++p)
+            if (p >= row.params.size() || row.params[p] != in.params[p]) same = false;
+        if (same) {
+            ++result.unchanged;
+            continue;
+        }
+
+        if (!result.changedRows.contains(existing))
+            row.preComment = "! " + ts + " " + CulParser::formatRow(row, fmts, numParams).trimmed();
+        while (row.params.size() < numParams) row.params.append(std::nullopt);
+        while (row.paramStrs.size() < numParams) row.paramStrs.append(QString());
+        for (int p = 0; p < qMin(numParams, in.params.size()); ++p) {
+            row.params[p]    = in.params[p];
+            row.paramStrs[p] = in.paramStrs.value(p);   // keep GLUE's decimals
+        }
+        if (!result.changedRows.contains(existing)) {
+            result.changedRows << existing;
+            ++result.updated;
+        }
+    }
+    return result;
+}
+
+// ── mergeFile ─────────────────────────────────────────────────────────────────
+bool GlueResultMerger::mergeFile(const QString &culPath, const QStringList &culLines,
+                                 GlueMergeResult &result, QString *errorMsg)
+{
+    QStringList headers;
+    QVector<CulRow> rows = CulParser::parse(culPath, headers);
+    if (rows.isEmpty()) {
+        if (errorMsg) *errorMsg = "Cannot read cultivars from " + culPath;
+        return false;
+    }
+    QStringList paramNames = CulParser::extractParamNames(headers);
+    int numParams = paramNames.size();
+    for (const CulRow &r : rows) numParams = qMax(numParams, int(r.params.size()));
+
+    result = mergeRows(rows, numParams, culLines);
+    if (result.changes() == 0) return true;
+
+    result.backupPath = BackupManager::createBackup(culPath);
+    BackupManager::pruneBackups(culPath);
+    if (!CulParser::write(culPath, rows, headers, paramNames)) {
+        if (errorMsg) *errorMsg = "Cannot write " + culPath;
+        return false;
+    }
+    return true;
+}
+
+// ── sources ───────────────────────────────────────────────────────────────────
+QMap<QString, QStringList> GlueResultMerger::finishedResults(const QList<GlueQueueEntry> &entries)
+{
+    QMap<QString, QStringList> byFile;
+    for (const GlueQueueEntry &e : entries)
+        if (e.status == GlueQueueStatus::Done && !e.resultCulLine.isEmpty())
+            byFile[e.cropInfo.culFile] << e.resultCulLine;
+    return byFile;
+}
+
+QStringList GlueResultMerger::storedResults(const QString &cropCode, const QStringList &cultivarIds)
+{
+    QStringList lines;
+    QDir backUp(GlueRunner::GLUE_WORK + "/BackUp");
+    const QStringList dirs = backUp.entryList({cropCode + "_*"}, QDir::Dirs | QDir::NoDotAndDotDot,
+                                              QDir::Name);
+    for (const QString &d : dirs) {
+        const QString id = d.mid(cropCode.size() + 1);
+        if (!cultivarIds.isEmpty() && !cultivarIds.contains(id, Qt::CaseInsensitive)) continue;
+        const QString manifest = backUp.filePath(d + "/" + GlueResultCache::MANIFEST_FILE);
+        if (!QFileInfo::exists(manifest)) continue;
+        QString line = QSettings(manifest, QSettings::IniFormat).value("resultCulLine").toString();
+        if (!line.isEmpty()) lines << line;
+    }
+    return lines;
+}
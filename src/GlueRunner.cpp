@@ -1,4 +1,6 @@
 #include "GlueRunner.h"
+#include "SimulationControl.h"
+#include "Config.h"
 #include <QDir>
 #include <QDirIterator>
 #include <QFile>
@@ -15,7 +17,7 @@ QString GlueRunner::GLUE_WORK;
 bool GlueRunner::resolvePaths(const QString &dssatProPath)
 {
     // 1. Try QSettings (user previously set it via menu)
-    QSettings s("DSSAT", "GeneticsEditor");
+    QSettings s(Config::ORG_NAME, Config::SETTINGS_APP);
     QString saved = s.value("GlueDir").toString();
     if (!saved.isEmpty() && QFile::exists(saved + "/SimulationControl.csv")) {
         setGlueDir(saved);
@@ -84,18 +86,9 @@ void GlueRunner::setGlueDir(const QString &dir)
     GLUE_DIR = dir;
 
     // Read OutputD from SimulationControl.csv to get GLUE_WORK
-    QString simCtrl = dir + "/SimulationControl.csv";
-    QFile f(simCtrl);
-    if (f.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        QTextStream in(&f);
-        while (!in.atEnd()) {
-            QString line = in.readLine().trimmed();
-            if (line.startsWith("OutputD,")) {
-                GLUE_WORK = line.mid(8).trimmed();
-                break;
-            }
-        }
-    }
+    SimulationControl sc;
+    if (SimulationControl::cached(dir + "/SimulationControl.csv", sc) && !sc.outputDir.isEmpty())
+        GLUE_WORK = sc.outputDir;
     // Fallback if OutputD not found in file
     if (GLUE_WORK.isEmpty()) {
 #ifdef Q_OS_WIN
@@ -105,7 +98,7 @@ void GlueRunner::setGlueDir(const QString &dir)
 #endif
     }
 
-    QSettings("DSSAT", "GeneticsEditor").setValue("GlueDir", dir);
+    QSettings(Config::ORG_NAME, Config::SETTINGS_APP).setValue("GlueDir", dir);
 }
 
 // ── findRTerm ─────────────────────────────────────────────────────────────────
@@ -251,12 +244,14 @@ ScanResult GlueRunner::scanExperiments(const CropInfo &cropInfo,
 QString GlueRunner::writeBatchFile(const CropInfo &cropInfo,
                                    const QString  &cultivarId,
                                    const QString  &cultivarName,
-                                   const TreatmentMap &selected)
+                                   const TreatmentMap &selected,
+                                   const QString  &dir)
 {
+    QString outDir        = dir.isEmpty() ? GLUE_WORK : dir;
     QString batchFileName = QString("%1.%2C").arg(cultivarId, cropInfo.cropCode);
-    QString batchPath     = GLUE_WORK + "/" + batchFileName;
+    QString batchPath     = outDir + "/" + batchFileName;
 
-    QDir().mkpath(GLUE_WORK);
+    QDir().mkpath(outDir);
     QFile batchFile(batchPath);
     if (!batchFile.open(QIODevice::WriteOnly | QIODevice::Text))
         return QString();
@@ -285,33 +280,65 @@ QString GlueRunner::writeBatchFile(const CropInfo &cropInfo,
 bool GlueRunner::updateSimControl(const CropInfo &cropInfo,
                                   const QString  &cultivarId,
                                   int runs, int glueFlag,
-                                  const QString  &ecoCalib)
+                                  const QString  &ecoCalib,
+                                  const QString  &targetPath,
+                                  QString        *errorMsg)
+{
+    SimulationControl sc;
+    if (!SimulationControl::cached(GLUE_DIR + "/SimulationControl.csv", sc, errorMsg))
+        return false;
+
+    sc.configureJob(cropInfo, cultivarId, runs, glueFlag, ecoCalib);
+    if (sc.outputDir.isEmpty()) sc.outputDir = GLUE_WORK;
+    QStringList problems = sc.validate();
+    if (!problems.isEmpty()) {
+        if (errorMsg) *errorMsg = problems.join("\n");
+        return false;
+    }
+    return sc.writeTo(targetPath.isEmpty() ? GLUE_DIR + "/SimulationControl.csv" : targetPath,
+                      errorMsg);
+}
+
+// ── readProgress ──────────────────────────────────────────────────────────────
+bool GlueRunner::readProgress(const QString &indicatorFile, GlueProgress &progress)
 {
-    QString simCtrlPath = GLUE_DIR + "/SimulationControl.csv";
-    QFile sc(simCtrlPath);
-    if (!sc.open(QIODevice::ReadOnly | QIODevice::Text)) return false;
+    static const QStringList phases = {
+        "Random parameter sets have been generated",
+        "Model runs are starting",
+        "Likelihood calculation is starting",
+        "Likelihood calculation is finished",
+        "Starting calculation of posterior",
+        "round of GLUE is finished"
+    };
 
-    QStringList lines;
-    QTextStream in(&sc);
-    while (!in.atEnd()) lines << in.readLine();
-    sc.close();
+    QFile fi(indicatorFile);
+    if (!fi.open(QIODevice::ReadOnly | QIODevice::Text)) return false;
+    const QString text = QString::fromLatin1(fi.readAll());
+    fi.close();
+    // Complete lines only: a last line without its newline is still being
+    // written and is read on the next poll
+    const int end = text.lastIndexOf('\n');
+    const QStringList lines = end < 0 ? QStringList() : text.left(end).split('\n');
 
-    for (QString &line : lines) {
-        if (line.startsWith("NumberOfModelRun,"))
-            line = QString("NumberOfModelRun,%1").arg(runs);
-        else if (line.startsWith("GLUEFlag,"))
-            line = QString("GLUEFlag,%1").arg(glueFlag);
-        else if (line.startsWith("EcotypeCalibration,"))
-            line = QString("EcotypeCalibration,%1").arg(ecoCalib);
-        else if (line.startsWith("CultivarBatchFile,"))
-            line = QString("CultivarBatchFile,%1.%2C").arg(cultivarId, cropInfo.cropCode);
-        else if (line.startsWith("ModelID,"))
-            line = QString("ModelID,%1").arg(cropInfo.modelId.isEmpty() ? cropInfo.module : cropInfo.modelId);
+    int phaseInRound = 0;
+    QString label;
+    for (int i = progress.lastLine; i < lines.size(); ++i) {
+        QString line = lines[i].trimmed();
+        if (line.isEmpty()) continue;
+        if (line.startsWith("GLUE Flag: 2")) { progress.round = 1; phaseInRound = 0; }
+        for (int p = 0; p < phases.size(); ++p) {
+            if (line.contains(phases[p])) { phaseInRound = p + 1; break; }
+        }
+        if (!line.startsWith("GLUE Flag") && (
+            line.startsWith("Random parameter") || line.startsWith("Model runs") ||
+            line.startsWith("Likelihood") || line.startsWith("Starting calc") ||
+            line.contains("round of GLUE")))
+            label = line;
     }
+    progress.lastLine = lines.size();
+    if (label.isEmpty()) return false;
 
-    QFile scOut(simCtrlPath);
-    if (!scOut.open(QIODevice::WriteOnly | QIODevice::Text)) return false;
-    QTextStream out(&scOut);
-    for (const QString &l : lines) out << l << "\n";
+    progress.percent = qMin(99, (int)((progress.round * 6 + phaseInRound) / 12.0 * 100));
+    progress.label   = label;
     return true;
 }
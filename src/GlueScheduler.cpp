@@ -0,0 +1,100 @@
+#include "GlueScheduler.h"
+#include "GlueQueueManager.h"
+#include "Config.h"
+#include <QSettings>
+#include <QtMath>
+
+// Used until at least one run of any kind has been recorded on this machine
+static const double DEFAULT_SEC_PER_RUN = 0.5;
+// Weight of the newest measurement in the moving average
+static const double EMA_ALPHA = 0.3;
+
+static QString historyKey(const QString &module, int glueFlag)
+{
+    return QString("GlueHistory/%1_F%2").arg(module.isEmpty() ? "UNKNOWN" : module).arg(glueFlag);
+}
+
+// ── modelRunCount ─────────────────────────────────────────────────────────────
+qint64 GlueScheduler::modelRunCount(const GlueQueueEntry &entry)
+{
+    qint64 treatments = 0;
+    for (const auto &list : entry.selectedTreatments) treatments += list.size();
+    int rounds = (entry.glueFlag == 1) ? 2 : 1;
+    return qMax<qint64>(1, treatments) * qMax(1, entry.runs) * rounds;
+}
+
+// ── secondsPerModelRun ────────────────────────────────────────────────────────
+double GlueScheduler::secondsPerModelRun(const CropInfo &cropInfo, int glueFlag)
+{
+    QSettings s(Config::ORG_NAME, Config::SETTINGS_APP);
+    double v = s.value(historyKey(cropInfo.module, glueFlag) + "/secPerRun").toDouble();
+    if (v > 0) return v;
+    v = s.value("GlueHistory/all/secPerRun").toDouble();
+    return v > 0 ? v : DEFAULT_SEC_PER_RUN;
+}
+
+// ── estimateSeconds ───────────────────────────────────────────────────────────
+double GlueScheduler::estimateSeconds(const GlueQueueEntry &entry)
+{
+    return modelRunCount(entry) * secondsPerModelRun(entry.cropInfo, entry.glueFlag);
+}
+
+// ── recordRun ─────────────────────────────────────────────────────────────────
+void GlueScheduler::recordRun(const GlueQueueEntry &entry, double wallSeconds)
+{
+    if (wallSeconds <= 0) return;
+    double perRun = wallSeconds / modelRunCount(entry);
+
+    QSettings s(Config::ORG_NAME, Config::SETTINGS_APP);
+    for (const QString &key : {historyKey(entry.cropInfo.module, entry.glueFlag),
+                               QString("GlueHistory/all")}) {
+        int n = s.value(key + "/samples", 0).toInt();
+        double old = s.value(key + "/secPerRun").toDouble();
+        double upd = (n == 0 || old <= 0) ? perRun : old + EMA_ALPHA * (perRun - old);
+        s.setValue(key + "/secPerRun", upd);
+        s.setValue(key + "/samples", n + 1);
+    }
+}
+
+// ── pickNext ──────────────────────────────────────────────────────────────────
+int GlueScheduler::pickNext(const QList<GlueQueueEntry> &entries, GlueSchedulePolicy policy)
+{
+    int best = -1;
+    for (int i = 0; i < entries.size(); ++i) {
+        const GlueQueueEntry &e = entries[i];
+        if (e.status != GlueQueueStatus::Pending) continue;
+        if (best < 0) { best = i; if (policy == GlueSchedulePolicy::Fifo) break; continue; }
+
+        const GlueQueueEntry &b = entries[best];
+        // Priority breaks ties by estimated cost, shortest first; remaining
+        // ties keep the earlier entry so equal jobs stay in FIFO order
+        if (policy == GlueSchedulePolicy::ShortestFirst) {
+            if (e.estimatedSeconds < b.estimatedSeconds) best = i;
+        } else if (policy == GlueSchedulePolicy::Priority) {
+            if (e.priority > b.priority ||
+                (e.priority == b.priority && e.estimatedSeconds < b.estimatedSeconds))
+                best = i;
+        }
+    }
+    return best;
+}
+
+// ── formatDuration ────────────────────────────────────────────────────────────
+QString GlueScheduler::formatDuration(double seconds)
+{
+    qint64 s = qMax<qint64>(0, qRound64(seconds));
+    if (s < 60) return QString("%1 s").arg(s);
+    // Rounded before the unit is picked, so 59.5 min and up reads as an hour
+    qint64 m = (s + 30) / 60;
+    if (m < 60) return QString("%1 min").arg(m);
+    return QString("%1 h %2 min").arg(m / 60).arg(m % 60, 2, 10, QChar('0'));
+}
+
+QString GlueScheduler::policyName(GlueSchedulePolicy policy)
+{
+    switch (policy) {
+    case GlueSchedulePolicy::ShortestFirst: return "Shortest job first";
+    case GlueSchedulePolicy::Priority:      return "Priority, then shortest";
+    default:                                return "First in, first out";
+    }
+}
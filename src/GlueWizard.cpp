@@ -1,5 +1,6 @@
 #include "GlueWizard.h"
 #include "GlueRunner.h"
+#include "GluePosteriorWidget.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGridLayout>
@@ -33,6 +34,7 @@ GlueWizard::GlueWizard(const CropInfo &cropInfo,
     , m_cropInfo(cropInfo)
     , m_cultivarId(cultivarId)
     , m_cultivarName(cultivarName)
+    , m_pipeline(new GlueJobPipeline(this))
 {
     setWindowTitle(QString("Run GLUE — %1 / %2 %3")
                    .arg(cropInfo.cropCode, cultivarId, cultivarName));
@@ -48,6 +50,12 @@ GlueWizard::GlueWizard(const CropInfo &cropInfo,
     setupBackupPage();
     setupRunPage();
 
+    // The wizard works in the shared GLWork its output buttons read from
+    m_pipeline->setLayout(GlueJobPipeline::SharedLayout);
+    connect(m_pipeline, &GlueJobPipeline::jobStarted,  this, &GlueWizard::onGlueStarted);
+    connect(m_pipeline, &GlueJobPipeline::jobProgress, this, &GlueWizard::onGlueProgress);
+    connect(m_pipeline, &GlueJobPipeline::jobFinished, this, &GlueWizard::onGlueFinished);
+
     m_stack->setCurrentIndex(0);
     scanExperiments();
 }
@@ -229,15 +237,16 @@ void GlueWizard::setupRunPage()
     showLogBtn->setChecked(false);
     centerCol->addWidget(showLogBtn);
 
-    m_logEdit = new QTextEdit;
-    m_logEdit->setReadOnly(true);
-    m_logEdit->setFont(QFont("Courier New", 8));
-    m_logEdit->setVisible(false);
-    m_logEdit->setMinimumHeight(150);
-    centerCol->addWidget(m_logEdit, 1);
+    m_log = new GlueLogBuffer(GlueLogBuffer::DEFAULT_CAPACITY, this);
+    m_log->setWatchPatterns({"error occurred", "cannot open", "Error in "});
+    m_logView = new GlueLogView;
+    m_logView->setBuffer(m_log);
+    m_logView->setVisible(false);
+    m_logView->setMinimumHeight(150);
+    centerCol->addWidget(m_logView, 1);
 
     connect(showLogBtn, &QPushButton::toggled, this, [this, showLogBtn](bool checked) {
-        m_logEdit->setVisible(checked);
+        m_logView->setVisible(checked);
         showLogBtn->setText(checked ? "Hide Log" : "Show Log");
         adjustSize();
     });
@@ -252,7 +261,9 @@ void GlueWizard::setupRunPage()
     m_outCoeffBtn = new QPushButton("Cultivar Coefficients");
     m_outDevBtn   = new QPushButton("Development");
     m_outYieldBtn = new QPushButton("Growth and Yield");
-    for (auto *b : {m_outCoeffBtn, m_outDevBtn, m_outYieldBtn}) {
+    m_outPostBtn  = new QPushButton("Posterior");
+    m_outPostBtn->setToolTip("Prior and posterior distribution of every calibrated parameter");
+    for (auto *b : {m_outCoeffBtn, m_outDevBtn, m_outYieldBtn, m_outPostBtn}) {
         b->setEnabled(false);
         b->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
         outCol->addWidget(b);
@@ -337,6 +348,11 @@ void GlueWizard::setupRunPage()
 #endif
     });
 
+    connect(m_outPostBtn, &QPushButton::clicked, this, [this]() {
+        GluePosteriorWidget::showForDir(this, GLUE_WORK,
+            QString("GLUE Posterior — %1 %2").arg(m_cultivarId, m_cultivarName));
+    });
+
     m_stack->addWidget(page);
 }
 
@@ -444,14 +460,8 @@ void GlueWizard::onGoFromTreatments()
         return;
     }
 
-    QString batchPath = GlueRunner::writeBatchFile(
-        m_cropInfo, m_cultivarId, m_cultivarName, selected);
-    if (batchPath.isEmpty()) {
-        QMessageBox::critical(this, "Error",
-            "Cannot write batch file to:\n" + GlueRunner::GLUE_WORK);
-        return;
-    }
-
+    // The batch file is written when GLUE starts
+    m_selected = selected;
     m_selectedFiles = selected.keys();
     m_stack->setCurrentIndex(1);
 }
@@ -479,158 +489,91 @@ void GlueWizard::onBrowseBackup()
 // ── Slot: Run GLUE ────────────────────────────────────────────────────────────
 void GlueWizard::onRunGlue()
 {
-    int glueFlag  = m_modeCombo->currentData().toInt();
-    QString ecoCalib = m_ecoCheck->isChecked() ? "Y" : "N";
-    int runs = m_runsSpin->value();
-
-    if (!GlueRunner::updateSimControl(m_cropInfo, m_cultivarId, runs, glueFlag, ecoCalib)) {
-        QMessageBox::critical(this, "Error",
-            "Cannot open/write SimulationControl.csv:\n" + GlueRunner::GLUE_DIR);
+    GlueJobSpec spec;
+    spec.cropInfo     = m_cropInfo;
+    spec.cultivarId   = m_cultivarId;
+    spec.cultivarName = m_cultivarName;
+    spec.treatments   = m_selected;
+    spec.runs         = m_runsSpin->value();
+    spec.glueFlag     = m_modeCombo->currentData().toInt();
+    spec.ecoCalib     = m_ecoCheck->isChecked() ? "Y" : "N";
+    spec.log          = m_log;
+    m_pipeline->addJob(spec);
+
+    QString err;
+    if (!m_pipeline->start(&err)) {
+        QMessageBox::critical(this, "Error", "Cannot start GLUE:\n" + err);
         return;
     }
 
-    m_logEdit->clear();
-    m_logEdit->append("Starting GLUE calibration...");
-    m_logEdit->append(QString("Cultivar: %1 %2").arg(m_cultivarId, m_cultivarName));
-    m_logEdit->append(QString("Runs: %1  Mode: %2  ECO: %3")
-                      .arg(runs).arg(m_modeCombo->currentText()).arg(ecoCalib));
-    m_logEdit->append("---");
-
-    m_glueProcess = new QProcess(this);
-    m_glueProcess->setWorkingDirectory(GlueRunner::GLUE_DIR);
-    connect(m_glueProcess, &QProcess::readyReadStandardOutput, this, &GlueWizard::onGlueOutput);
-    connect(m_glueProcess, &QProcess::readyReadStandardError,  this, &GlueWizard::onGlueOutput);
-    connect(m_glueProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this, [this](int code, QProcess::ExitStatus){ onGlueFinished(code); });
-
-    QString rterm = GlueRunner::findRTerm();
-    m_glueProcess->start(rterm, {"--slave", "--file=" + GlueRunner::GLUE_DIR + "/GLUE.r"});
-
     // Reset progress tracking
-    m_totalRuns = m_runsSpin->value();
-    m_glueRound = 0;
-    m_lastIndicatorLine = 0;
+    m_totalRuns = spec.runs;
     m_progressBar->setRange(0, 0); // indeterminate (animated) until we get phase info
     m_progressBar->setValue(0);
     m_progressLabel->setText("Starting GLUE...");
 
-    // Poll ModelRunIndicator.txt every 800ms for phase-based progress
-    m_pollTimer = new QTimer(this);
-    connect(m_pollTimer, &QTimer::timeout, this, &GlueWizard::onPollProgress);
-    m_pollTimer->start(800);
-
     m_runGlueBtn->setEnabled(false);
     m_stopGlueBtn->setEnabled(true);
 }
 
 void GlueWizard::onStopGlue()
 {
-    if (m_pollTimer) { m_pollTimer->stop(); m_pollTimer->deleteLater(); m_pollTimer = nullptr; }
-    if (m_glueProcess && m_glueProcess->state() != QProcess::NotRunning) {
-        m_glueProcess->kill();
-        m_logEdit->append("\n[Stopped by user]");
-        m_progressLabel->setText("Stopped");
-    }
+    if (!m_pipeline->isRunning()) return;
+    m_pipeline->cancel("stopped");
+    m_log->appendLine("\n[Stopped by user]");
+    m_progressLabel->setText("Stopped");
 }
 
 void GlueWizard::onStartOver()
 {
     onStopGlue();
-    m_logEdit->clear();
+    m_log->reset();
     m_runGlueBtn->setEnabled(true);
     m_stopGlueBtn->setEnabled(false);
-    for (auto *b : {m_outCoeffBtn, m_outDevBtn, m_outYieldBtn})
+    for (auto *b : {m_outCoeffBtn, m_outDevBtn, m_outYieldBtn, m_outPostBtn})
         b->setEnabled(false);
     m_stack->setCurrentIndex(0);
     scanExperiments();
 }
 
-void GlueWizard::onGlueOutput()
+// The pipeline has reset the log to this run's file
+void GlueWizard::onGlueStarted()
 {
-    if (!m_glueProcess) return;
-    QByteArray out = m_glueProcess->readAllStandardOutput();
-    QByteArray err = m_glueProcess->readAllStandardError();
-    if (!out.isEmpty()) m_logEdit->append(QString::fromLocal8Bit(out).trimmed());
-    if (!err.isEmpty()) m_logEdit->append(QString::fromLocal8Bit(err).trimmed());
+    m_log->appendLine("Starting GLUE calibration...");
+    m_log->appendLine(QString("Cultivar: %1 %2").arg(m_cultivarId, m_cultivarName));
+    m_log->appendLine(QString("Runs: %1  Mode: %2  ECO: %3")
+                      .arg(m_totalRuns).arg(m_modeCombo->currentText())
+                      .arg(m_ecoCheck->isChecked() ? "Y" : "N"));
+    m_log->appendLine("---");
 }
 
-void GlueWizard::onPollProgress()
+void GlueWizard::onGlueProgress(int, const GlueProgress &progress)
 {
-    // Phase-based progress from ModelRunIndicator.txt
-    // Each round has 6 phases mapped to 0-50% (round 1) and 50-100% (round 2):
-    //   "Random parameter sets have been generated..."  -> 1/6
-    //   "Model runs are starting..."                    -> 2/6
-    //   "Likelihood calculation is starting..."         -> 3/6
-    //   "Likelihood calculation is finished..."         -> 4/6
-    //   "Starting calculation of posterior..."          -> 5/6
-    //   "round of GLUE is finished"                     -> 6/6
-    static const QStringList phases = {
-        "Random parameter sets have been generated",
-        "Model runs are starting",
-        "Likelihood calculation is starting",
-        "Likelihood calculation is finished",
-        "Starting calculation of posterior",
-        "round of GLUE is finished"
-    };
-
-    QString indFile = GLUE_WORK + "/ModelRunIndicator.txt";
-    QFile fi(indFile);
-    if (!fi.open(QIODevice::ReadOnly | QIODevice::Text)) return;
-    QStringList lines = QString::fromLatin1(fi.readAll()).split('\n');
-    fi.close();
-
-    int phaseInRound = 0; // 0-6 within current round
-
-    for (int i = m_lastIndicatorLine; i < lines.size(); ++i) {
-        QString line = lines[i].trimmed();
-        if (line.isEmpty()) continue;
-
-        if (line.startsWith("GLUE Flag: 2")) {
-            m_glueRound = 1;
-            phaseInRound = 0;
-        }
-
-        for (int p = 0; p < phases.size(); ++p) {
-            if (line.contains(phases[p])) {
-                phaseInRound = p + 1;
-                break;
-            }
-        }
-
-        // Update label with meaningful phase text
-        if (line.startsWith("Random parameter") || line.startsWith("Model runs") ||
-            line.startsWith("Likelihood") || line.startsWith("Starting calc") ||
-            line.contains("round of GLUE") || line.startsWith("GLUE Flag")) {
-            int overall = (int)((m_glueRound * 6 + phaseInRound) / 12.0 * 100);
-            m_progressBar->setRange(0, 100);
-            m_progressBar->setValue(qMin(overall, 99));
-            m_progressLabel->setText(QString("Round %1/2 — %2")
-                .arg(m_glueRound + 1).arg(line));
-        }
-    }
-    m_lastIndicatorLine = lines.size();
+    m_progressBar->setRange(0, 100);
+    m_progressBar->setValue(qMin(progress.percent, 99));
+    m_progressLabel->setText(QString("Round %1/2 — %2").arg(progress.round + 1).arg(progress.label));
 }
 
-void GlueWizard::onGlueFinished(int exitCode)
+void GlueWizard::onGlueFinished(int, const GlueJobResult &result)
 {
-    if (m_pollTimer) { m_pollTimer->stop(); m_pollTimer->deleteLater(); m_pollTimer = nullptr; }
     m_runGlueBtn->setEnabled(true);
     m_stopGlueBtn->setEnabled(false);
+    if (result.cancelled) return;
 
-    QString log = m_logEdit->toPlainText();
-    bool hasError = log.contains("error occurred", Qt::CaseInsensitive) ||
-                    log.contains("cannot open", Qt::CaseInsensitive) ||
-                    log.contains("Error in ", Qt::CaseInsensitive) ||
-                    exitCode != 0;
-
-    if (!hasError) {
+    if (result.ok) {
         m_progressBar->setValue(100);
         m_progressLabel->setText(QString("Done — %1 simulations complete").arg(m_totalRuns));
-        m_logEdit->append("\n✓ GLUE calibration finished successfully.");
-        for (auto *b : {m_outCoeffBtn, m_outDevBtn, m_outYieldBtn})
+        m_log->appendLine("\n✓ GLUE calibration finished successfully.");
+        for (auto *b : {m_outCoeffBtn, m_outDevBtn, m_outYieldBtn, m_outPostBtn})
             b->setEnabled(true);
     } else {
+        m_progressBar->setRange(0, 100);
         m_progressLabel->setText("Failed — see log");
-        m_logEdit->append(QString("\n✗ GLUE encountered errors (exit code %1). Check log above.").arg(exitCode));
+        if (!result.launched) {
+            QMessageBox::critical(this, "Error", "Cannot start GLUE in:\n" + GLUE_DIR + "\n\n" + result.errorMsg);
+            return;
+        }
+        m_log->appendLine(QString("\n✗ GLUE encountered errors (exit code %1). Check log above.")
+                          .arg(result.exitCode));
     }
 }
@@ -0,0 +1,121 @@
+#include "IdentifierIndex.h"
+#include <algorithm>
+
+bool IdentifierIndex::split(const QString &key, QString *prefix, int *suffix) const
+{
+    if (key.size() < m_prefixLength + 4) return false;
+    bool ok = false;
+    *suffix = key.right(4).toInt(&ok);
+    if (!ok || *suffix < 0) return false;
+    *prefix = key.left(m_prefixLength);
+    return true;
+}
+
+void IdentifierIndex::addKey(int row)
+{
+    QVector<int> &rows = m_rows[m_ids[row]];
+    rows.insert(std::lower_bound(rows.begin(), rows.end(), row), row);
+    QString prefix;
+    int suffix;
+    if (m_numbered[row] && split(m_ids[row], &prefix, &suffix))
+        ++m_suffixes[prefix][suffix];
+}
+
+void IdentifierIndex::dropKey(int row)
+{
+    auto it = m_rows.find(m_ids[row]);
+    if (it != m_rows.end()) {
+        it->removeOne(row);
+        if (it->isEmpty()) m_rows.erase(it);
+    }
+    QString prefix;
+    int suffix;
+    if (!m_numbered[row] || !split(m_ids[row], &prefix, &suffix)) return;
+    auto p = m_suffixes.find(prefix);
+    if (p == m_suffixes.end()) return;
+    auto s = p->find(suffix);
+    if (s != p->end() && --s.value() == 0) p->erase(s);
+    if (p->isEmpty()) m_suffixes.erase(p);
+}
+
+// ── maintenance ───────────────────────────────────────────────────────────────
+void IdentifierIndex::reset(const QVector<QString> &ids, const QVector<bool> &numbered)
+{
+    m_ids.clear();
+    m_numbered.clear();
+    m_rows.clear();
+    m_suffixes.clear();
+    m_ids.reserve(ids.size());
+    m_numbered.reserve(ids.size());
+    for (int r = 0; r < ids.size(); ++r) {
+        m_ids.append(normalize(ids[r]));
+        m_numbered.append(numbered.isEmpty() || numbered.value(r));
+        addKey(r);
+    }
+}
+
+void IdentifierIndex::insert(int row, const QString &id, bool numbered)
+{
+    row = qBound(0, row, int(m_ids.size()));
+    if (row < m_ids.size()) {
+        for (QVector<int> &rows : m_rows)
+            for (int &r : rows)
+                if (r >= row) ++r;
+    }
+    m_ids.insert(row, normalize(id));
+    m_numbered.insert(row, numbered);
+    addKey(row);
+}
+
+void IdentifierIndex::remove(int row)
+{
+    if (row < 0 || row >= m_ids.size()) return;
+    dropKey(row);
+    m_ids.remove(row);
+    m_numbered.remove(row);
+    if (row < m_ids.size()) {
+        for (QVector<int> &rows : m_rows)
+            for (int &r : rows)
+                if (r > row) --r;
+    }
+}
+
+void IdentifierIndex::rename(int row, const QString &id, bool numbered)
+{
+    if (row < 0 || row >= m_ids.size()) return;
+    const QString key = normalize(id);
+    if (key == m_ids[row] && numbered == m_numbered[row]) return;
+    dropKey(row);
+    m_ids[row] = key;
+    m_numbered[row] = numbered;
+    addKey(row);
+}
+
+// ── lookup ────────────────────────────────────────────────────────────────────
+int IdentifierIndex::rowOf(const QString &id) const
+{
+    auto it = m_rows.constFind(normalize(id));
+    return it == m_rows.constEnd() ? -1 : it->first();
+}
+
+int IdentifierIndex::maxSuffix(const QString &prefix) const
+{
+    auto it = m_suffixes.constFind(prefix.toUpper());
+    return it == m_suffixes.constEnd() ? 0 : it->lastKey();
+}
+
+QString IdentifierIndex::nextId(const QString &fallbackPrefix) const
+{
+    // The last rows are nearly always numbered, so this stops at once
+    QString prefix = fallbackPrefix;
+    for (int r = m_ids.size() - 1; r >= 0; --r) {
+        QString p;
+        int suffix;
+        if (m_numbered[r] && split(m_ids[r], &p, &suffix)) { prefix = p; break; }
+    }
+    int next = maxSuffix(prefix) + 1;
+    QString id = QString("%1%2").arg(prefix).arg(next, 4, 10, QChar('0'));
+    while (m_rows.contains(id))
+        id = QString("%1%2").arg(prefix).arg(++next, 4, 10, QChar('0'));
+    return id;
+}
@@ -0,0 +1,384 @@
+#include "IndexedFilterProxy.h"
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <numeric>
+
+// Replace `removed` bits at `first` with `inserted`
+static void spliceBits(QBitArray &bits, int first, int removed, const QBitArray &inserted)
+{
+    const int oldSize = bits.size();
+    const int newSize = oldSize - removed + inserted.size();
+    QBitArray out(newSize);
+    for (int i = 0; i < first; ++i)
+        if (bits.testBit(i)) out.setBit(i);
+    for (int i = 0; i < inserted.size(); ++i)
+        if (inserted.testBit(i)) out.setBit(first + i);
+    for (int i = first + removed; i < oldSize; ++i)
+        if (bits.testBit(i)) out.setBit(i - removed + inserted.size());
+    bits.swap(out);
+}
+
+// Sorts runs of a large array on a local pool, then merges them pairwise
+template <typename Less>
+static void parallelSort(QVector<int> &order, Less less)
+{
+    const int n = order.size();
+    const int runs = n >= 50000 ? qBound(1, QThread::idealThreadCount(), 8) : 1;
+    int *data = order.data();
+    if (runs == 1) {
+        std::sort(data, data + n, less);
+        return;
+    }
+    QVector<int> bounds;
+    for (int r = 0; r <= runs; ++r)
+        bounds << int(qint64(n) * r / runs);
+    QThreadPool pool;
+    pool.setMaxThreadCount(runs);
+    for (int r = 0; r < runs; ++r)
+        pool.start([=] { std::sort(data + bounds[r], data + bounds[r + 1], less); });
+    pool.waitForDone();
+    for (int width = 1; width < runs; width *= 2)
+        for (int r = 0; r + width < runs; r += 2 * width)
+            std::inplace_merge(data + bounds[r], data + bounds[r + width],
+                               data + bounds[qMin(r + 2 * width, runs)], less);
+}
+
+IndexedFilterProxy::IndexedFilterProxy(QObject *parent)
+    : QSortFilterProxyModel(parent)
+{
+    m_debounce.setSingleShot(true);
+    m_debounce.setInterval(150);
+    connect(&m_debounce, &QTimer::timeout, this, &IndexedFilterProxy::applySearch);
+}
+
+void IndexedFilterProxy::setSourceModel(QAbstractItemModel *model)
+{
+    for (const QMetaObject::Connection &c : std::as_const(m_sourceConnections))
+        disconnect(c);
+    m_sourceConnections.clear();
+
+    // Connected before the base class hooks the model, so the index and the
+    // selection are current by the time it re-filters a changed row
+    if (model) {
+        m_sourceConnections
+            << connect(model, &QAbstractItemModel::modelReset, this, [this] { rebuildIndex(); })
+            << connect(model, &QAbstractItemModel::layoutChanged, this, [this] { rebuildIndex(); })
+            << connect(model, &QAbstractItemModel::rowsInserted, this,
+                       [this](const QModelIndex &, int first, int last) { onRowsInserted(first, last); })
+            << connect(model, &QAbstractItemModel::rowsRemoved, this,
+                       [this](const QModelIndex &, int first, int last) { onRowsRemoved(first, last); })
+            << connect(model, &QAbstractItemModel::dataChanged, this,
+                       [this](const QModelIndex &tl, const QModelIndex &br) { onDataChanged(tl, br); });
+    }
+    QSortFilterProxyModel::setSourceModel(model);
+    rebuildIndex();
+    invalidateFilter();
+}
+
+QString IndexedFilterProxy::rowKey(int row) const
+{
+    QStringList fields;
+    for (int col : m_columns)
+        fields << sourceModel()->data(sourceModel()->index(row, col)).toString();
+    // '\n' never appears in a query, so no match spans two fields
+    return fields.join('\n');
+}
+
+// ── selection ─────────────────────────────────────────────────────────────────
+QBitArray IndexedFilterProxy::select(int first, int count) const
+{
+    QBitArray rows;
+    if (m_structured)
+        rows = m_query.isValid() ? m_query.evaluate(*this, first, count) : QBitArray(count, true);
+    else if (!m_text.isEmpty())
+        rows = readSearch(m_text, first, count);
+    else
+        rows = QBitArray(count, true);
+    restrictRows(first, count, &rows);
+    return rows;
+}
+
+void IndexedFilterProxy::reselect()
+{
+    m_selection = select(0, m_index.rowCount());
+    invalidateFilter();
+}
+
+void IndexedFilterProxy::compileQuery()
+{
+    m_error.clear();
+    m_structured = !m_text.isEmpty() && TableQuery::isStructured(m_text, querySchema());
+    if (m_structured && !m_query.compile(m_text, querySchema(), &m_error))
+        m_error = "query: " + m_error;
+}
+
+bool IndexedFilterProxy::filterAcceptsRow(int sourceRow, const QModelIndex &) const
+{
+    return sourceRow < m_selection.size() && m_selection.testBit(sourceRow);
+}
+
+TableQuery::Schema IndexedFilterProxy::querySchema() const
+{
+    TableQuery::Schema schema;
+    if (!sourceModel()) return schema;
+    for (int c = 0; c < sourceModel()->columnCount(); ++c)
+        schema.columns << sourceModel()->headerData(c, Qt::Horizontal).toString();
+    schema.firstNumeric = schema.columns.size();
+    return schema;
+}
+
+void IndexedFilterProxy::restrictRows(int, int, QBitArray *) const
+{
+}
+
+// ── index maintenance ─────────────────────────────────────────────────────────
+void IndexedFilterProxy::rebuildIndex()
+{
+    const int rows = sourceModel() ? sourceModel()->rowCount() : 0;
+    QVector<QString> keys;
+    keys.reserve(rows);
+    for (int r = 0; r < rows; ++r)
+        keys.append(rowKey(r));
+    m_index.reset(keys);
+    // Column names may have changed with the reset
+    compileQuery();
+    m_selection = select(0, rows);
+    rebuildRanks(sortColumn());
+}
+
+void IndexedFilterProxy::onRowsInserted(int first, int last)
+{
+    QVector<QString> keys;
+    for (int r = first; r <= last; ++r)
+        keys.append(rowKey(r));
+    m_index.insertRows(first, keys);
+    spliceBits(m_selection, first, 0, select(first, last - first + 1));
+    // The new rows compare by key until the queued rebuild ranks them
+    if (m_rankColumn >= 0 && first <= m_rank.size()) {
+        const int count = last - first + 1;
+        m_rank.insert(first, count, -1);
+        spliceBits(m_pinned, first, 0, pinnedRows(first, count));
+        scheduleRanks();
+    } else {
+        rebuildRanks(sortColumn());
+    }
+}
+
+void IndexedFilterProxy::onRowsRemoved(int first, int last)
+{
+    m_index.removeRows(first, last - first + 1);
+    if (last < m_selection.size())
+        spliceBits(m_selection, first, last - first + 1, QBitArray());
+    // Removing rows leaves gaps between ranks but keeps their order
+    if (m_rankColumn >= 0 && last < m_rank.size()) {
+        m_rank.remove(first, last - first + 1);
+        spliceBits(m_pinned, first, last - first + 1, QBitArray());
+    } else {
+        rebuildRanks(sortColumn());
+    }
+}
+
+void IndexedFilterProxy::onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    const int first = topLeft.row(), count = bottomRight.row() - first + 1;
+    for (int col : m_columns) {
+        if (col < topLeft.column() || col > bottomRight.column()) continue;
+        for (int r = first; r < first + count; ++r)
+            m_index.setKey(r, rowKey(r));
+        break;
+    }
+    // Any column may feed a query or a restriction
+    const QBitArray rows = select(first, count);
+    for (int i = 0; i < count && first + i < m_selection.size(); ++i)
+        m_selection.setBit(first + i, rows.testBit(i));
+
+    const int sortCol = sortColumn();
+    const bool keyChanged = sortCol >= topLeft.column() && sortCol <= bottomRight.column();
+    const bool pinChanged = m_pinColumn >= topLeft.column() && m_pinColumn <= bottomRight.column();
+    if (!keyChanged && !pinChanged) return;
+    if (m_rankColumn != sortCol || first + count > m_rank.size()) {
+        rebuildRanks(sortCol);
+        return;
+    }
+    if (keyChanged) {
+        for (int r = first; r < first + count; ++r) m_rank[r] = -1;
+        scheduleRanks();
+    }
+    if (pinChanged) {
+        const QBitArray pins = pinnedRows(first, count);
+        for (int i = 0; i < count; ++i) m_pinned.setBit(first + i, pins.testBit(i));
+    }
+}
+
+// ── sort keys ─────────────────────────────────────────────────────────────────
+void IndexedFilterProxy::rebuildRanks(int column)
+{
+    m_rankColumn = -1;
+    m_rank.clear();
+    m_pinned.clear();
+    const int n = m_index.rowCount();
+    if (column < 0 || !sourceModel() || column >= sourceModel()->columnCount()) return;
+
+    m_pinned = pinnedRows(0, n);
+
+    QVector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    m_rank = QVector<int>(n);
+    auto assignRanks = [&](auto less) {
+        parallelSort(order, less);
+        for (int i = 0; i < n; ++i)
+            m_rank[order[i]] = i > 0 && !less(order[i - 1], order[i]) ? m_rank[order[i - 1]] : i;
+    };
+
+    m_rankNumeric = column >= querySchema().firstNumeric;
+    if (m_rankNumeric) {
+        QVector<double> values;
+        QBitArray present;
+        readNumbers(column, 0, n, &values, &present);
+        // Empty cells sort before every number
+        QVector<char> has(n);
+        for (int r = 0; r < n; ++r) has[r] = present.testBit(r);
+        const double *v = values.constData();
+        const char *h = has.constData();
+        assignRanks([v, h](int a, int b) { return h[a] != h[b] ? h[a] < h[b] : v[a] < v[b]; });
+    } else {
+        QVector<QString> text;
+        readText(column, 0, n, &text);
+        if (sortCaseSensitivity() == Qt::CaseInsensitive)
+            for (QString &t : text) t = t.toCaseFolded();
+        const QString *t = text.constData();
+        assignRanks([t](int a, int b) { return t[a] < t[b]; });
+    }
+    m_rankColumn = column;
+}
+
+// One rebuild per event-loop pass, however many rows were inserted or edited
+void IndexedFilterProxy::scheduleRanks()
+{
+    if (m_ranksQueued) return;
+    m_ranksQueued = true;
+    QMetaObject::invokeMethod(this, [this] {
+        m_ranksQueued = false;
+        if (m_rankColumn != sortColumn() || m_rank.contains(-1))
+            rebuildRanks(sortColumn());
+    }, Qt::QueuedConnection);
+}
+
+QBitArray IndexedFilterProxy::pinnedRows(int first, int count) const
+{
+    QBitArray rows(count);
+    if (m_pinColumn < 0 || m_pinValues.isEmpty()) return rows;
+    QVector<QString> pins;
+    readText(m_pinColumn, first, count, &pins);
+    for (int i = 0; i < count; ++i)
+        if (m_pinValues.contains(pins[i].trimmed())) rows.setBit(i);
+    return rows;
+}
+
+// The comparison rebuildRanks() sorts by, for rows not ranked yet
+bool IndexedFilterProxy::keyLess(int a, int b) const
+{
+    if (m_rankNumeric) {
+        QVector<double> va, vb;
+        QBitArray pa, pb;
+        readNumbers(m_rankColumn, a, 1, &va, &pa);
+        readNumbers(m_rankColumn, b, 1, &vb, &pb);
+        return pa.testBit(0) != pb.testBit(0) ? pb.testBit(0) : va[0] < vb[0];
+    }
+    QVector<QString> ta, tb;
+    readText(m_rankColumn, a, 1, &ta);
+    readText(m_rankColumn, b, 1, &tb);
+    if (sortCaseSensitivity() == Qt::CaseInsensitive)
+        return ta[0].toCaseFolded() < tb[0].toCaseFolded();
+    return ta[0] < tb[0];
+}
+
+void IndexedFilterProxy::sort(int column, Qt::SortOrder order)
+{
+    if (column != m_rankColumn)
+        rebuildRanks(column);
+    QSortFilterProxyModel::sort(column, order);
+}
+
+bool IndexedFilterProxy::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    const int a = left.row(), b = right.row();
+    if (left.column() != m_rankColumn || a >= m_rank.size() || b >= m_rank.size())
+        return QSortFilterProxyModel::lessThan(left, right);
+    const bool aPin = m_pinned.testBit(a), bPin = m_pinned.testBit(b);
+    if (aPin != bPin) {
+        // Qt swaps the arguments for a descending sort, so flip to stay on top
+        return sortOrder() == Qt::AscendingOrder ? aPin : !aPin;
+    }
+    if (m_rank[a] < 0 || m_rank[b] < 0)
+        return keyLess(a, b);
+    return m_rank[a] < m_rank[b];
+}
+
+// ── search ────────────────────────────────────────────────────────────────────
+void IndexedFilterProxy::setSearchText(const QString &text)
+{
+    m_pending = text.trimmed();
+    if (m_pending.isEmpty())
+        applySearch();
+    else
+        m_debounce.start();
+}
+
+void IndexedFilterProxy::flushSearch()
+{
+    if (m_debounce.isActive())
+        applySearch();
+}
+
+void IndexedFilterProxy::applySearch()
+{
+    m_debounce.stop();
+    if (m_pending == m_text) return;
+    m_text = m_pending;
+    compileQuery();
+    reselect();
+    emit searchApplied(m_selection.count(true), m_error);
+}
+
+// ── TableQuery::Reader ────────────────────────────────────────────────────────
+void IndexedFilterProxy::readText(int col, int first, int count, QVector<QString> *out) const
+{
+    out->resize(count);
+    for (int i = 0; i < count; ++i)
+        (*out)[i] = sourceModel()->data(sourceModel()->index(first + i, col)).toString();
+}
+
+void IndexedFilterProxy::readNumbers(int col, int first, int count,
+                                     QVector<double> *values, QBitArray *present) const
+{
+    QVector<QString> text;
+    readText(col, first, count, &text);
+    values->resize(count);
+    *present = QBitArray(count);
+    for (int i = 0; i < count; ++i) {
+        bool ok = false;
+        (*values)[i] = text[i].toDouble(&ok);
+        if (ok) present->setBit(i);
+    }
+}
+
+QBitArray IndexedFilterProxy::readFlag(const QString &, int, int count) const
+{
+    return QBitArray(count);
+}
+
+QBitArray IndexedFilterProxy::readSearch(const QString &text, int first, int count) const
+{
+    QBitArray rows(count);
+    if (first == 0 && count == m_index.rowCount()) {
+        for (int r : m_index.find(text))
+            rows.setBit(r);
+    } else {
+        const QString lowered = text.toLower();
+        for (int i = 0; i < count; ++i)
+            if (m_index.matches(first + i, lowered)) rows.setBit(i);
+    }
+    return rows;
+}
@@ -28,9 +28,13 @@ public:
 #include "GlueQueueDialog.h"
 #include "GlueQueueManager.h"
 #include "GlueQueuePanel.h"
+#include "CulViolationPanel.h"
+#include "GlueResultMerger.h"
+#include "IndexedFilterProxy.h"
 #include <QApplication>
 #include <QMenuBar>
 #include <QStatusBar>
+#include <QDockWidget>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QGridLayout>
@@ -52,6 +56,8 @@ public:
 #include <QShortcut>
 #include <QScrollBar>
 #include <QMenu>
+#include <QUndoGroup>
+#include <QUndoStack>
 #include <QAbstractTextDocumentLayout>
 #include <QTimer>
 #include <QDebug>
@@ -63,70 +69,95 @@ public:
 #include <QRegularExpression>
 
 // ─── Proxy: pins MINIMA/MAXIMA rows to the top during any sort ───────────────
-class CulSortProxy : public QSortFilterProxyModel {
+class CulSortProxy : public IndexedFilterProxy {
 public:
     explicit CulSortProxy(QObject *parent = nullptr)
-        : QSortFilterProxyModel(parent) {}
+        : IndexedFilterProxy(parent)
+    {
+        setSearchColumns({CulTableModel::COL_VARNUM, CulTableModel::COL_VRNAME, CulTableModel::COL_ECONUM});
+        setPinnedRows(CulTableModel::COL_VARNUM, {"999991", "999992"});
+    }
 
     void setUsedFilter(const QSet<QString> &usedVarNums) {
         m_usedVarNums = usedVarNums;
         m_filterActive = !usedVarNums.isEmpty();
-        invalidateFilter();
+        reselect();
     }
 
+    // Shows every row again; the set stays available to the `used` query flag
     void clearUsedFilter() {
-        m_usedVarNums.clear();
         m_filterActive = false;
-        invalidateFilter();
+        reselect();
     }
 
 protected:
-    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override {
-        if (m_filterActive) {
-            QString varNum = sourceModel()->data(sourceModel()->index(sourceRow, 0, sourceParent)).toString().trimmed();
-            if (varNum != "999991" && varNum != "999992" && !m_usedVarNums.contains(varNum))
-                return false;
-        }
-        return QSortFilterProxyModel::filterAcceptsRow(sourceRow, sourceParent);
+    TableQuery::Schema querySchema() const override {
+        TableQuery::Schema schema;
+        if (!culModel()) return schema;
+        for (int c = 0; c < culModel()->columnCount(); ++c)
+            schema.columns << culModel()->columnName(c);
+        schema.firstNumeric = CulTableModel::COL_PARAM0;
+        schema.flags << "used";
+        return schema;
     }
 
-    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override {
-        // VAR# is always column 0 in the source model
-        const QString lv = sourceModel()->data(sourceModel()->index(left.row(),  0)).toString();
-        const QString rv = sourceModel()->data(sourceModel()->index(right.row(), 0)).toString();
-        const bool lPin = (lv == "999991" || lv == "999992");
-        const bool rPin = (rv == "999991" || rv == "999992");
-        if (lPin != rPin) {
-            // Keep pinned rows above all regular rows regardless of sort direction.
-            // For ascending:  pinned < normal  → return lPin
-            // For descending: Qt reverses lessThan, so returning !lPin keeps them on top too
-            return (sortOrder() == Qt::AscendingOrder) ? lPin : !lPin;
+    void restrictRows(int first, int count, QBitArray *selection) const override {
+        if (m_filterActive)
+            *selection &= readFlag("used", first, count);
+    }
+
+    void readText(int col, int first, int count, QVector<QString> *out) const override {
+        culModel()->textColumn(col, first, count, out);
+    }
+    void readNumbers(int col, int first, int count, QVector<double> *values, QBitArray *present) const override {
+        culModel()->numberColumn(col, first, count, values, present);
+    }
+    // `used`: VAR# found in the experiment files; MINIMA/MAXIMA always count
+    QBitArray readFlag(const QString &flag, int first, int count) const override {
+        QBitArray rows(count);
+        if (flag != "used") return rows;
+        QVector<QString> varNums;
+        culModel()->textColumn(CulTableModel::COL_VARNUM, first, count, &varNums);
+        for (int i = 0; i < count; ++i) {
+            const QString v = varNums[i].trimmed();
+            if (v == "999991" || v == "999992" || m_usedVarNums.contains(v)) rows.setBit(i);
         }
-        return QSortFilterProxyModel::lessThan(left, right);
+        return rows;
     }
 
 private:
+    const CulTableModel *culModel() const { return static_cast<const CulTableModel *>(sourceModel()); }
+
     QSet<QString> m_usedVarNums;
     bool          m_filterActive = false;
 };
 
-class EcoSortProxy : public QSortFilterProxyModel {
+class EcoSortProxy : public IndexedFilterProxy {
 public:
     explicit EcoSortProxy(QObject *parent = nullptr)
-        : QSortFilterProxyModel(parent) {}
+        : IndexedFilterProxy(parent)
+    {
+        setSearchColumns({EcoTableModel::COL_ECONUM, EcoTableModel::COL_ECONAME});
+        setPinnedRows(EcoTableModel::COL_ECONUM, {"999991", "999992"});
+    }
 protected:
-    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override {
-        // ECO# is always column 0 in the source model
-        const QString lv = sourceModel()->data(sourceModel()->index(left.row(),  0)).toString();
-        const QString rv = sourceModel()->data(sourceModel()->index(right.row(), 0)).toString();
-        const bool lPin = (lv == "999991" || lv == "999992");
-        const bool rPin = (rv == "999991" || rv == "999992");
-        if (lPin != rPin) {
-            // Keep pinned rows (MINIMA/MAXIMA) above all regular rows regardless of sort direction
-            return (sortOrder() == Qt::AscendingOrder) ? lPin : !lPin;
-        }
-        return QSortFilterProxyModel::lessThan(left, right);
+    TableQuery::Schema querySchema() const override {
+        TableQuery::Schema schema;
+        for (int c = 0; c < EcoTableModel::TOTAL_COLS; ++c)
+            schema.columns << EcoTableModel::columnName(c);
+        schema.firstNumeric = EcoTableModel::COL_REFS;
+        return schema;
+    }
+
+    void readText(int col, int first, int count, QVector<QString> *out) const override {
+        ecoModel()->textColumn(col, first, count, out);
+    }
+    void readNumbers(int col, int first, int count, QVector<double> *values, QBitArray *present) const override {
+        ecoModel()->numberColumn(col, first, count, values, present);
     }
+
+private:
+    const EcoTableModel *ecoModel() const { return static_cast<const EcoTableModel *>(sourceModel()); }
 };
 
 // ─── constructor ────────────────────────────────────────────────────────────
@@ -135,6 +166,13 @@ MainWindow::MainWindow(QWidget *parent)
     , m_culModel(new CulTableModel(this))
     , m_ecoModel(new EcoTableModel(this))
 {
+    m_savePool.setMaxThreadCount(1);   // saves of one file must land in order
+    m_undoGroup = new QUndoGroup(this);
+    m_culUndo = new QUndoStack(m_undoGroup);
+    m_ecoUndo = new QUndoStack(m_undoGroup);
+    m_culModel->setUndoStack(m_culUndo);
+    m_ecoModel->setUndoStack(m_ecoUndo);
+    m_undoGroup->setActiveStack(m_culUndo);
     setWindowTitle(QString("%1 v%2 — DSSAT Genetics Editor")
                    .arg(Config::APP_NAME, Config::APP_VERSION));
     setMinimumSize(Config::WIN_MIN_W, Config::WIN_MIN_H);
@@ -196,10 +234,13 @@ MainWindow::~MainWindow() {}
 // ─── close event ────────────────────────────────────────────────────────────
 void MainWindow::closeEvent(QCloseEvent *event)
 {
-    // Flush any pending auto-save before closing
+    // Flush any pending auto-save before closing, on this thread
+    m_savePool.waitForDone();
     if (m_autoSaveTimer && m_autoSaveTimer->isActive()) {
         m_autoSaveTimer->stop();
-        autoSaveAll();
+        if (m_culDirty) onCulSave();
+        if (m_ecoDirty) onEcoSave();
+        if (m_speDirty) onSpeSave();
     }
     event->accept();
 }
@@ -285,6 +326,47 @@ void MainWindow::setupUI()
     // ── Status bar ───────────────────────────────────────────────────────────
     m_statusLabel = new QLabel("Ready");
     statusBar()->addPermanentWidget(m_statusLabel, 1);
+
+    setupViolationDock();
+}
+
+// Out-of-range CUL values: dockable list plus a count in the status bar,
+// both fed by the model's violation index
+void MainWindow::setupViolationDock()
+{
+    m_violationLabel = new QLabel;
+    m_violationLabel->setStyleSheet("color: #C62828; font-weight: bold;");
+    m_violationLabel->setVisible(false);
+    statusBar()->addPermanentWidget(m_violationLabel);
+
+    CulViolationPanel *panel = new CulViolationPanel(m_culModel);
+    m_violationDock = new QDockWidget("Range Violations", this);
+    m_violationDock->setObjectName("violationDock");
+    m_violationDock->setWidget(panel);
+    addDockWidget(Qt::RightDockWidgetArea, m_violationDock);
+    m_violationDock->hide();
+
+    QMenu *viewMenu = new QMenu("&View", this);
+    QAction *toggle = m_violationDock->toggleViewAction();
+    toggle->setShortcut(QKeySequence("Ctrl+Shift+V"));
+    viewMenu->addAction(toggle);
+    menuBar()->insertMenu(menuBar()->actions().last(), viewMenu);   // before Help
+
+    connect(m_culModel, &CulTableModel::violationsChanged, this, [this](int count) {
+        m_violationLabel->setText(QString("⚠ %1 out of range").arg(count));
+        m_violationLabel->setVisible(count > 0);
+    });
+    connect(panel, &CulViolationPanel::cellActivated, this, [this](int row, int column) {
+        m_tabWidget->setCurrentIndex(0);
+        QModelIndex idx = m_culProxy->mapFromSource(m_culModel->index(row, column));
+        if (!idx.isValid()) {
+            setStatus("That cultivar is hidden by the current filter", true);
+            return;
+        }
+        m_culView->scrollTo(idx, QAbstractItemView::PositionAtCenter);
+        m_culView->setCurrentIndex(idx);
+        m_culView->setFocus();
+    });
 }
 
 void MainWindow::setupMenuBar()
@@ -295,6 +377,15 @@ void MainWindow::setupMenuBar()
     fileMenu->addSeparator();
     fileMenu->addAction("E&xit", qApp, &QApplication::quit);
 
+    // Undo/redo of the CUL or ECO table on screen; text editors keep their own
+    QMenu *editMenu = menuBar()->addMenu("&Edit");
+    QAction *undoAction = m_undoGroup->createUndoAction(this, "&Undo");
+    undoAction->setShortcut(QKeySequence::Undo);
+    QAction *redoAction = m_undoGroup->createRedoAction(this, "&Redo");
+    redoAction->setShortcut(QKeySequence::Redo);
+    editMenu->addAction(undoAction);
+    editMenu->addAction(redoAction);
+
     QMenu *helpMenu = menuBar()->addMenu("&Help");
     helpMenu->addAction("&About", this, &MainWindow::onAbout);
 }
@@ -319,7 +410,10 @@ void MainWindow::setupCulTab(QWidget *tab)
     QHBoxLayout *toolbar = new QHBoxLayout;
     toolbar->addWidget(new QLabel("Search:"));
     m_culSearch = new QLineEdit;
-    m_culSearch->setPlaceholderText("Filter by VAR# or VRNAME…");
+    m_culSearch->setPlaceholderText("Filter by VAR#, VRNAME or ECO#…");
+    m_culSearch->setToolTip("Plain text matches VAR#, VRNAME or ECO#.\n"
+                            "Queries: ECO#=IB0001 AND PPSEN>0.3 AND used\n"
+                            "Operators = != < <= > >= ~ (contains); AND, OR, NOT, ( ); quote values with spaces");
     m_culSearch->setMaximumWidth(260);
     toolbar->addWidget(m_culSearch);
     toolbar->addStretch();
@@ -327,6 +421,9 @@ void MainWindow::setupCulTab(QWidget *tab)
     m_culAddBtn      = makeBtn("Add");
     m_culDelBtn      = makeBtn("Delete",    "dangerBtn");
     m_culDupBtn      = makeBtn("Duplicate");
+    QPushButton *culFormulaBtn = makeBtn("Formula");
+    culFormulaBtn->setToolTip("Apply a formula such as *1.05 to the current parameter of the selected rows");
+    connect(culFormulaBtn, &QPushButton::clicked, this, [this]() { onCulApplyFormula(); });
     m_culSaveBtn     = makeBtn("Save",      "saveBtn");
     m_culRefreshBtn = makeBtn("Refresh");
     m_culShowUsedBtn = makeBtn("Show Used");
@@ -335,6 +432,9 @@ void MainWindow::setupCulTab(QWidget *tab)
     QPushButton *culGlueBtn = makeBtn("Paste GLUE");
     culGlueBtn->setToolTip("Paste a GLUE-calibrated cultivar line to update or add a row");
     connect(culGlueBtn, &QPushButton::clicked, this, &MainWindow::onCulPasteGlue);
+    QPushButton *culMergeBtn = makeBtn("Merge GLUE");
+    culMergeBtn->setToolTip("Write every finished GLUE result in the queue to its CUL file (one backup, one save)");
+    connect(culMergeBtn, &QPushButton::clicked, this, &MainWindow::onCulMergeGlue);
 
     m_culGlueQueueBtn = makeBtn("Run GLUE");
     QPushButton *addQueueBtn = m_culGlueQueueBtn;
@@ -360,8 +460,8 @@ void MainWindow::setupCulTab(QWidget *tab)
         }
     });
 
-    for (auto *b : {m_culAddBtn, m_culDelBtn, m_culDupBtn, m_culSaveBtn,
-                    m_culRefreshBtn, m_culShowUsedBtn, culGlueBtn, addQueueBtn})
+    for (auto *b : {m_culAddBtn, m_culDelBtn, m_culDupBtn, culFormulaBtn, m_culSaveBtn,
+                    m_culRefreshBtn, m_culShowUsedBtn, culGlueBtn, culMergeBtn, addQueueBtn})
         toolbar->addWidget(b);
 
     vbox->addLayout(toolbar);
@@ -369,8 +469,6 @@ void MainWindow::setupCulTab(QWidget *tab)
     // Table view with sort/filter proxy
     m_culProxy = new CulSortProxy(this);
     m_culProxy->setSourceModel(m_culModel);
-    m_culProxy->setFilterKeyColumn(-1);
-    m_culProxy->setFilterCaseSensitivity(Qt::CaseInsensitive);
 
     m_culView = new QTableView;
     m_culView->setModel(m_culProxy);
@@ -404,45 +502,29 @@ void MainWindow::setupCulTab(QWidget *tab)
             setStatus(QString("GLUE failed for entry %1").arg(index + 1), true);
             return;
         }
-        const GlueQueueEntry &entry = m_glueQueue->entries().at(index);
-        QString varNum = entry.cultivarId;
-
-        // Find the row in the model
-        int culRow = -1;
-        const auto &rows = m_culModel->rows();
-        for (int i = 0; i < rows.size(); ++i) {
-            if (rows[i].varNum.trimmed() == varNum) { culRow = i; break; }
-        }
-        if (culRow < 0) {
-            setStatus(QString("GLUE done for %1 but cultivar not found in table").arg(varNum), true);
+        const QString varNum = m_glueQueue->entries().at(index).cultivarId;
+
+        // Same path as "Merge GLUE": stamps the old line as a dated comment,
+        // applies all parameters in one model update
+        int numParams = m_culModel->columnCount() - CulTableModel::COL_PARAM0;
+        QVector<CulRow> rows = m_culModel->rows();
+        GlueMergeResult merged = GlueResultMerger::mergeRows(rows, numParams, {culLine}, false,
+                                                             &m_culModel->varNumIndex());
+        if (merged.changes() == 0) {
+            if (merged.unchanged > 0)
+                setStatus(QString("GLUE result for %1 already in table").arg(varNum));
+            else
+                setStatus(QString("GLUE done for %1 but cultivar not found in table").arg(varNum), true);
             return;
         }
-
-        // Inline history comment: stamp the old line with date before overwriting
-        {
-            int numParams = m_culModel->columnCount() - CulTableModel::COL_PARAM0;
-            QVector<ParamFormat> fmts = CulParser::inferFormats(m_culModel->rows(), numParams);
-            QString oldLine = CulParser::formatRow(m_culModel->rows().at(culRow), fmts, numParams);
-            QString ts = QDateTime::currentDateTime().toString("yyyy-MM-dd HH:mm");
-            m_culModel->setRowPreComment(culRow, "! " + ts + " " + oldLine.trimmed());
-        }
-
-        // Parse and apply params — fixed-width: VARNUM(6) SP VRNAME(16) EXPNO(7) ECO(6) SP params
-        QString paramStr = culLine.mid(37).trimmed();
-        QStringList vals = paramStr.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
-        int nParams = m_culModel->columnCount() - CulTableModel::COL_PARAM0;
-        for (int i = 0; i < qMin(vals.size(), nParams); ++i) {
-            bool ok = false;
-            double v = vals[i].toDouble(&ok);
-            if (ok)
-                m_culModel->setData(m_culModel->index(culRow, CulTableModel::COL_PARAM0 + i), v);
-        }
+        m_culModel->applyMerged(rows, merged.changedRows);
 
         // Auto-save directly — no .bak file, inline comment already written above
         if (!m_currentCulPath.isEmpty()) {
+            m_autoSaveTimer->stop();
+            m_savePool.waitForDone();
             QStringList pNames;
-            int n = m_culModel->columnCount() - CulTableModel::COL_PARAM0;
-            for (int i = 0; i < n; ++i)
+            for (int i = 0; i < numParams; ++i)
                 pNames << m_culModel->columnName(CulTableModel::COL_PARAM0 + i);
             CulParser::write(m_currentCulPath, m_culModel->rows(), m_culHeaderLines, pNames);
             m_culDirty = false;
@@ -464,6 +546,9 @@ void MainWindow::setupEcoTab(QWidget *tab)
     toolbar->addWidget(new QLabel("Search:"));
     m_ecoSearch = new QLineEdit;
     m_ecoSearch->setPlaceholderText("Filter by ECO# or ECONAME…");
+    m_ecoSearch->setToolTip("Plain text matches ECO# or ECONAME.\n"
+                            "Queries: R1PPO>0 AND NOT ECONAME~generic\n"
+                            "Operators = != < <= > >= ~ (contains); AND, OR, NOT, ( ); quote values with spaces");
     m_ecoSearch->setMaximumWidth(260);
     toolbar->addWidget(m_ecoSearch);
     toolbar->addStretch();
@@ -471,17 +556,17 @@ void MainWindow::setupEcoTab(QWidget *tab)
     m_ecoAddBtn  = makeBtn("Add");
     m_ecoDelBtn  = makeBtn("Delete",    "dangerBtn");
     m_ecoDupBtn  = makeBtn("Duplicate");
+    m_ecoUsersBtn = makeBtn("Cultivars");
+    m_ecoUsersBtn->setToolTip("List the cultivars using the selected ecotype");
     m_ecoSaveBtn = makeBtn("Save",      "saveBtn");
 
-    for (auto *b : {m_ecoAddBtn, m_ecoDelBtn, m_ecoDupBtn, m_ecoSaveBtn})
+    for (auto *b : {m_ecoAddBtn, m_ecoDelBtn, m_ecoDupBtn, m_ecoUsersBtn, m_ecoSaveBtn})
         toolbar->addWidget(b);
 
     vbox->addLayout(toolbar);
 
     m_ecoProxy = new EcoSortProxy(this);
     m_ecoProxy->setSourceModel(m_ecoModel);
-    m_ecoProxy->setFilterKeyColumn(-1);
-    m_ecoProxy->setFilterCaseSensitivity(Qt::CaseInsensitive);
 
     m_ecoView = new QTableView;
     m_ecoView->setModel(m_ecoProxy);
@@ -565,6 +650,7 @@ void MainWindow::connectSignals()
     connect(m_cropCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
             this, &MainWindow::onCropChanged);
     connect(m_tabWidget, &QTabWidget::currentChanged, this, [this](int index){
+        m_undoGroup->setActiveStack(index == 0 ? m_culUndo : index == 1 ? m_ecoUndo : nullptr);
         if (m_currentCropCode.isEmpty()) return;
         if (index == 0 && !m_currentCulPath.isEmpty()) loadFileType("CUL");
         else if (index == 1 && !m_currentEcoPath.isEmpty()) loadFileType("ECO");
@@ -579,15 +665,32 @@ void MainWindow::connectSignals()
     connect(m_culRefreshBtn,  &QPushButton::clicked, this, &MainWindow::onCulRefresh);
     connect(m_culShowUsedBtn, &QPushButton::toggled, this, &MainWindow::onCulShowUsed);
     connect(m_culSearch,      &QLineEdit::textChanged, this, &MainWindow::onCulSearch);
+    connect(m_culProxy, &IndexedFilterProxy::searchApplied, this, [this](int matches, const QString &error) {
+        if (!error.isEmpty()) setStatus("Filter " + error, true);
+        else if (!m_culSearch->text().trimmed().isEmpty())
+            setStatus(QString("%1 of %2 cultivar rows match").arg(matches).arg(m_culModel->rowCount()));
+    });
     connect(m_culModel,       &CulTableModel::dataModified,
             [this](){ m_culDirty = true; setStatus("CUL modified…"); m_autoSaveTimer->start(); });
+    // ECO tab REFS column: recounted in full on a CUL reload, per ECO# on edits
+    connect(m_culModel, &QAbstractItemModel::modelReset, this, &MainWindow::refreshEcoCrossRef);
+    connect(m_culModel, &CulTableModel::ecoRefsChanged, this, [this](const QStringList &ecoNums) {
+        for (const QString &ecoNum : ecoNums)
+            m_ecoModel->setCulRefCount(ecoNum, m_culModel->ecoRefCount(ecoNum));
+    });
 
     // ECO
     connect(m_ecoAddBtn,  &QPushButton::clicked, this, &MainWindow::onEcoAdd);
     connect(m_ecoDelBtn,  &QPushButton::clicked, this, &MainWindow::onEcoDelete);
     connect(m_ecoDupBtn,  &QPushButton::clicked, this, &MainWindow::onEcoDuplicate);
+    connect(m_ecoUsersBtn, &QPushButton::clicked, this, &MainWindow::onEcoShowCultivars);
     connect(m_ecoSaveBtn, &QPushButton::clicked, this, &MainWindow::onEcoSave);
     connect(m_ecoSearch,  &QLineEdit::textChanged, this, &MainWindow::onEcoSearch);
+    connect(m_ecoProxy, &IndexedFilterProxy::searchApplied, this, [this](int matches, const QString &error) {
+        if (!error.isEmpty()) setStatus("Filter " + error, true);
+        else if (!m_ecoSearch->text().trimmed().isEmpty())
+            setStatus(QString("%1 of %2 ecotype rows match").arg(matches).arg(m_ecoModel->rowCount()));
+    });
     connect(m_ecoModel,   &EcoTableModel::dataModified,
             [this](){ m_ecoDirty = true; setStatus("ECO modified…"); m_autoSaveTimer->start(); });
 
@@ -689,7 +792,7 @@ void MainWindow::loadCrop(const QString &cropCode)
     m_culShowUsedBtn->setChecked(false);
     m_culShowUsedBtn->setText("Show Used");
     m_culShowUsedBtn->blockSignals(false);
-    m_culProxy->clearUsedFilter();
+    m_culProxy->setUsedFilter({});
     if (m_culGlueQueueBtn) m_culGlueQueueBtn->setText("Run GLUE");
 
     setStatus(QString("Selected crop: %1 (%2)").arg(info.cropCode, cropCode));
@@ -707,6 +810,7 @@ void MainWindow::loadFileType(const QString &fileType)
 {
     if (m_currentCropCode.isEmpty() || !m_crops.contains(m_currentCropCode)) return;
     const CropInfo &info = m_crops[m_currentCropCode];
+    m_savePool.waitForDone();   // never parse a file an auto-save is writing
 
     if (fileType == "CUL") {
         m_culHeaderLines.clear();
@@ -725,7 +829,6 @@ void MainWindow::loadFileType(const QString &fileType)
             m_ecoModel->setRows(EcoParser::parse(m_currentEcoPath, m_ecoHeaderLines));
             m_ecoModel->setColumnTooltips(CulParser::tooltipsFromHeader(m_ecoHeaderLines));
             m_ecoDirty = false;
-            refreshEcoCrossRef();
         }
 
         // Default to "Show Used" filter — silently, only if experiment files exist
@@ -779,7 +882,6 @@ void MainWindow::loadFileType(const QString &fileType)
         m_ecoModel->setRows(ecoRows);
         m_ecoModel->setColumnTooltips(CulParser::tooltipsFromHeader(m_ecoHeaderLines));
         m_ecoDirty = false;
-        refreshEcoCrossRef();
         m_tabWidget->setCurrentIndex(1);
         setStatus(QString("Loaded ECO: %1 — %2 ecotypes").arg(QFileInfo(m_currentEcoPath).fileName()).arg(ecoRows.size()));
     } else if (fileType == "SPE") {
@@ -803,13 +905,8 @@ void MainWindow::loadFileType(const QString &fileType)
 
 void MainWindow::refreshEcoCrossRef()
 {
-    QMap<QString, int> refs;
-    const auto &culRows = m_culModel->rows();
-    for (const auto &r : culRows) {
-        if (!r.isMinMax)
-            refs[r.ecoNum]++;
-    }
-    m_ecoModel->setCulCrossRef(refs);
+    // Counts are keyed by ECO#, so they stay valid across ECO reloads
+    m_ecoModel->setCulCrossRef(m_culModel->ecoRefCounts());
 }
 
 void MainWindow::buildSpeNavigator()
@@ -922,6 +1019,7 @@ void MainWindow::onCulDuplicate()
 void MainWindow::onCulSave()
 {
     if (m_currentCulPath.isEmpty()) return;
+    m_savePool.waitForDone();   // an older auto-save must not land after this one
 
     // Backup
     BackupManager::createBackup(m_currentCulPath);
@@ -945,7 +1043,7 @@ void MainWindow::onCulCopyRow()
 {
     QModelIndex idx = m_culProxy->mapToSource(m_culView->currentIndex());
     if (!idx.isValid()) return;
-    const CulRow &row = m_culModel->rows().at(idx.row());
+    const CulRow &row = m_culModel->rowAt(idx.row());
     int numParams = m_culModel->columnCount() - CulTableModel::COL_PARAM0;
     QVector<ParamFormat> fmts = CulParser::inferFormats(m_culModel->rows(), numParams);
     QApplication::clipboard()->setText(CulParser::formatRow(row, fmts, numParams));
@@ -956,7 +1054,7 @@ void MainWindow::onEcoCopyRow()
 {
     QModelIndex idx = m_ecoProxy->mapToSource(m_ecoView->currentIndex());
     if (!idx.isValid()) return;
-    const EcoRow &row = m_ecoModel->rows().at(idx.row());
+    const EcoRow &row = m_ecoModel->rowAt(idx.row());
     QApplication::clipboard()->setText(EcoParser::formatRow(row));
     setStatus(QString("Copied ecotype %1 to clipboard").arg(row.ecoNum));
 }
@@ -979,12 +1077,7 @@ void MainWindow::onCulPasteGlue()
         return;
     }
 
-    // Search for an existing row with the same VAR#
-    const QVector<CulRow> &rows = m_culModel->rows();
-    int existingRow = -1;
-    for (int i = 0; i < rows.size(); ++i) {
-        if (rows[i].varNum == newRow.varNum) { existingRow = i; break; }
-    }
+    const int existingRow = m_culModel->rowOfVarNum(newRow.varNum);
 
     if (existingRow >= 0) {
         auto btn = QMessageBox::question(this, "Paste GLUE",
@@ -993,7 +1086,8 @@ void MainWindow::onCulPasteGlue()
             QMessageBox::Yes | QMessageBox::No, QMessageBox::Yes);
         if (btn != QMessageBox::Yes) return;
 
-        // Update each parameter column via setData so dataModified is emitted
+        // Update each column via setData, announced as one change and one save
+        CulTableModel::EditBatch batch(m_culModel);
         QAbstractItemModel *src = m_culModel;
         auto idx = [&](int col){ return src->index(existingRow, col); };
         src->setData(idx(CulTableModel::COL_VRNAME), newRow.vrName);
@@ -1012,7 +1106,8 @@ void MainWindow::onCulPasteGlue()
     } else {
         // Add as a new row
         newRow.isMinMax = false;
-        int newIdx = m_culModel->rows().size();
+        int newIdx = m_culModel->rowCount();
+        CulTableModel::EditBatch batch(m_culModel);
         m_culModel->addRow();  // appends a blank row
         // Now overwrite it with parsed values
         QAbstractItemModel *src = m_culModel;
@@ -1034,8 +1129,49 @@ void MainWindow::onCulPasteGlue()
 }
 
 
+void MainWindow::onCulMergeGlue()
+{
+    const QMap<QString, QStringList> byFile = GlueResultMerger::finishedResults(m_glueQueue->entries());
+    if (byFile.isEmpty()) {
+        QMessageBox::information(this, "Merge GLUE Results", "No finished GLUE runs in the queue.");
+        return;
+    }
+
+    const QString openCul = QFileInfo(m_currentCulPath).canonicalFilePath();
+    QStringList report;
+    bool failed = false;
+    for (auto it = byFile.constBegin(); it != byFile.constEnd(); ++it) {
+        GlueMergeResult merged;
+        if (!openCul.isEmpty() && QFileInfo(it.key()).canonicalFilePath() == openCul) {
+            // Open file: one model update, then a single backup + write
+            int numParams = m_culModel->columnCount() - CulTableModel::COL_PARAM0;
+            QVector<CulRow> rows = m_culModel->rows();
+            merged = GlueResultMerger::mergeRows(rows, numParams, it.value(), true,
+                                                 &m_culModel->varNumIndex());
+            if (merged.changes() > 0) {
+                m_culModel->applyMerged(rows, merged.changedRows);
+                m_autoSaveTimer->stop();
+                onCulSave();
+            }
+        } else {
+            QString err;
+            if (!GlueResultMerger::mergeFile(it.key(), it.value(), merged, &err)) {
+                report << QFileInfo(it.key()).fileName() + ": " + err;
+                failed = true;
+                continue;
+            }
+        }
+        report << QFileInfo(it.key()).fileName() + ": " + merged.summary();
+    }
+
+    setStatus("GLUE results merged — " + report.join("; "), failed);
+    QMessageBox::information(this, "Merge GLUE Results", report.join("\n"));
+}
+
 void MainWindow::onCulRefresh()
 {
+    m_savePool.waitForDone();
+
     // Reload CUL
     if (!m_currentCulPath.isEmpty()) {
         m_culHeaderLines.clear();
@@ -1054,7 +1190,6 @@ void MainWindow::onCulRefresh()
         m_ecoModel->setRows(EcoParser::parse(m_currentEcoPath, m_ecoHeaderLines));
         m_ecoModel->setColumnTooltips(CulParser::tooltipsFromHeader(m_ecoHeaderLines));
         m_ecoDirty = false;
-        refreshEcoCrossRef();
     }
 
     setStatus("Refreshed CUL and ECO from disk.");
@@ -1064,7 +1199,7 @@ void MainWindow::onCulRefresh()
     QStringList issues;
 
     QStringList ecoNums;
-    for (const auto &er : m_ecoModel->rows())
+    for (const EcoRow &er : *m_ecoModel)
         if (!er.isMinMax) ecoNums << er.ecoNum;
 
     for (const auto &row : rows) {
@@ -1099,7 +1234,7 @@ void MainWindow::onCulRefresh()
 void MainWindow::onCulSearch(const QString &text)
 {
     if (m_culProxy)
-        m_culProxy->setFilterFixedString(text);
+        m_culProxy->setSearchText(text);
 }
 
 void MainWindow::onCulShowUsed(bool checked)
@@ -1250,10 +1385,8 @@ void MainWindow::onEcoDelete()
     QModelIndex idx = m_ecoProxy->mapToSource(m_ecoView->currentIndex());
     if (!idx.isValid()) return;
 
-    QString ecoNum = m_ecoModel->rows()[idx.row()].ecoNum;
-    int refs = 0;
-    for (const auto &cr : m_culModel->rows())
-        if (cr.ecoNum == ecoNum) ++refs;
+    const QString ecoNum = m_ecoModel->rowAt(idx.row()).ecoNum;
+    const int refs = m_culModel->ecoRefCount(ecoNum);
 
     if (refs > 0) {
         auto btn = QMessageBox::warning(this, "Delete ecotype",
@@ -1265,6 +1398,37 @@ void MainWindow::onEcoDelete()
     m_ecoModel->deleteRow(idx.row());
 }
 
+void MainWindow::onEcoShowCultivars()
+{
+    QModelIndex idx = m_ecoProxy->mapToSource(m_ecoView->currentIndex());
+    if (!idx.isValid()) return;
+
+    const QString ecoNum = m_ecoModel->rowAt(idx.row()).ecoNum.trimmed();
+    const QVector<int> rows = m_culModel->rowsUsingEco(ecoNum);
+    if (rows.isEmpty()) {
+        setStatus(QString("No cultivar uses ECO# %1").arg(ecoNum));
+        return;
+    }
+    QStringList lines;
+    for (int r : rows) {
+        const CulRow &cr = m_culModel->rowAt(r);
+        lines << QString("%1  %2").arg(cr.varNum, cr.vrName.trimmed());
+    }
+
+    QMessageBox box(this);
+    box.setWindowTitle("Cultivars using " + ecoNum);
+    box.setText(QString("%1 cultivar(s) use ECO# %2:\n\n%3")
+                    .arg(rows.size()).arg(ecoNum).arg(lines.mid(0, 20).join('\n')));
+    if (lines.size() > 20) box.setDetailedText(lines.join('\n'));
+    QPushButton *showBtn = box.addButton("Show in CUL tab", QMessageBox::ActionRole);
+    box.addButton(QMessageBox::Close);
+    box.exec();
+    if (box.clickedButton() != showBtn) return;
+
+    m_tabWidget->setCurrentIndex(0);
+    m_culSearch->setText(QString("ECO#=%1").arg(ecoNum));
+}
+
 void MainWindow::onEcoDuplicate()
 {
     QModelIndex idx = m_ecoProxy->mapToSource(m_ecoView->currentIndex());
@@ -1274,6 +1438,7 @@ void MainWindow::onEcoDuplicate()
 void MainWindow::onEcoSave()
 {
     if (m_currentEcoPath.isEmpty()) return;
+    m_savePool.waitForDone();
     BackupManager::createBackup(m_currentEcoPath);
     BackupManager::pruneBackups(m_currentEcoPath);
     if (EcoParser::write(m_currentEcoPath, m_ecoModel->rows(), m_ecoHeaderLines)) {
@@ -1287,17 +1452,67 @@ void MainWindow::onEcoSave()
 void MainWindow::onEcoSearch(const QString &text)
 {
     if (m_ecoProxy)
-        m_ecoProxy->setFilterFixedString(text);
+        m_ecoProxy->setSearchText(text);
 }
 
 // ─── Auto-save ───────────────────────────────────────────────────────────────
 void MainWindow::autoSaveAll()
 {
-    if (m_culDirty) onCulSave();
-    if (m_ecoDirty) onEcoSave();
+    if (m_culDirty) saveCulInBackground();
+    if (m_ecoDirty) saveEcoInBackground();
     if (m_speDirty) onSpeSave();
 }
 
+void MainWindow::saveCulInBackground()
+{
+    if (m_currentCulPath.isEmpty()) return;
+    const CulTableModel::Snapshot snap = m_culModel->snapshot();
+    const QString path = m_currentCulPath;
+    const QStringList header = m_culHeaderLines;
+    m_savePool.start([this, snap, path, header] {
+        BackupManager::createBackup(path);
+        BackupManager::pruneBackups(path);
+        const bool ok = CulParser::write(path, snap.rows(), header, snap.paramNames());
+        const quint64 generation = snap.generation();
+        QMetaObject::invokeMethod(this, [this, path, generation, ok] {
+            onBackgroundSaved(path, generation, ok);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MainWindow::saveEcoInBackground()
+{
+    if (m_currentEcoPath.isEmpty()) return;
+    const EcoTableModel::Snapshot snap = m_ecoModel->snapshot();
+    const QString path = m_currentEcoPath;
+    const QStringList header = m_ecoHeaderLines;
+    m_savePool.start([this, snap, path, header] {
+        BackupManager::createBackup(path);
+        BackupManager::pruneBackups(path);
+        const bool ok = EcoParser::write(path, snap.rows(), header);
+        const quint64 generation = snap.generation();
+        QMetaObject::invokeMethod(this, [this, path, generation, ok] {
+            onBackgroundSaved(path, generation, ok);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void MainWindow::onBackgroundSaved(const QString &path, quint64 generation, bool ok)
+{
+    if (!ok) {
+        setStatus("Failed to save: " + path, true);
+        return;
+    }
+    // An edit made while writing keeps the file dirty; its timer saves again
+    if (path == m_currentCulPath) {
+        if (generation == m_culModel->generation()) m_culDirty = false;
+        setStatus("CUL saved: " + path);
+    } else if (path == m_currentEcoPath) {
+        if (generation == m_ecoModel->generation()) m_ecoDirty = false;
+        setStatus("ECO saved: " + path);
+    }
+}
+
 // ─── SPE actions ─────────────────────────────────────────────────────────────
 void MainWindow::onSpeSave()
 {
@@ -1930,9 +2145,15 @@ void MainWindow::onCulHeaderContextMenu(const QPoint &pos)
     pAct->setCheckable(true); pAct->setChecked(current == "P");
     gAct->setCheckable(true); gAct->setChecked(current == "G");
     nAct->setCheckable(true); nAct->setChecked(current == "N");
+    menu.addSeparator();
+    QAction *formulaAct = menu.addAction(QString("Apply formula to %1 of selected rows…").arg(paramName));
 
     QAction *chosen = menu.exec(m_culView->horizontalHeader()->mapToGlobal(pos));
     if (!chosen) return;
+    if (chosen == formulaAct) {
+        onCulApplyFormula(col);
+        return;
+    }
 
     QString newType;
     if (chosen == pAct) newType = "P";
@@ -1947,6 +2168,40 @@ void MainWindow::onCulHeaderContextMenu(const QPoint &pos)
     setStatus(QString("Calibration type for %1 set to %2 — click Save to write to file.").arg(paramName, newType));
 }
 
+void MainWindow::onCulApplyFormula(int column)
+{
+    if (column < 0) column = m_culView->currentIndex().column();
+    if (column < CulTableModel::COL_PARAM0) {
+        QMessageBox::warning(this, "Apply Formula", "Select a cell in a parameter column first.");
+        return;
+    }
+    QVector<int> rows;
+    for (const QModelIndex &idx : m_culView->selectionModel()->selectedRows())
+        rows << m_culProxy->mapToSource(idx).row();
+    if (rows.isEmpty()) {
+        QMessageBox::warning(this, "Apply Formula", "Select the cultivar rows to change first.");
+        return;
+    }
+
+    const QString paramName = m_culModel->columnName(column);
+    bool ok;
+    const QString text = QInputDialog::getText(this, "Apply Formula",
+        QString("Formula for %1 on %2 selected row(s)\n"
+                "(*1.05 scale, /2 divide, +0.1 / -0.1 shift, =4.5 set):")
+            .arg(paramName).arg(rows.size()),
+        QLineEdit::Normal, "*1.05", &ok).trimmed();
+    if (!ok || text.isEmpty()) return;
+
+    CulTableModel::Formula formula;
+    QString err;
+    if (!CulTableModel::Formula::parse(text, &formula, &err)) {
+        QMessageBox::warning(this, "Apply Formula", "Invalid formula: " + err);
+        return;
+    }
+    const int changed = m_culModel->applyFormula(column - CulTableModel::COL_PARAM0, rows, formula);
+    setStatus(QString("%1 %2 applied to %3 cultivar(s)").arg(paramName, text).arg(changed));
+}
+
 void MainWindow::updateCalibrationHeaderLine()
 {
     QStringList paramNames = CulParser::extractParamNames(m_culHeaderLines);
@@ -0,0 +1,181 @@
+#include "SimulationControl.h"
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+static const char *KEY_RUNS   = "NumberOfModelRun";
+static const char *KEY_FLAG   = "GLUEFlag";
+static const char *KEY_ECO    = "EcotypeCalibration";
+static const char *KEY_BATCH  = "CultivarBatchFile";
+static const char *KEY_MODEL  = "ModelID";
+static const char *KEY_OUTPUT = "OutputD";
+
+namespace {
+struct CacheEntry {
+    QDateTime modified;
+    qint64    size = -1;
+    SimulationControl sc;
+};
+QMutex s_cacheMutex;
+QHash<QString, CacheEntry> s_cache;
+
+QString keyOf(const QString &line)
+{
+    int comma = line.indexOf(',');
+    return comma > 0 ? line.left(comma).trimmed() : QString();
+}
+
+QString valueOf(const QString &line)
+{
+    int comma = line.indexOf(',');
+    return comma >= 0 ? line.mid(comma + 1).trimmed() : QString();
+}
+} // namespace
+
+// ── load / cache ──────────────────────────────────────────────────────────────
+bool SimulationControl::load(const QString &filePath, SimulationControl &sc, QString *errorMsg)
+{
+    sc = SimulationControl();
+    QFile f(filePath);
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (errorMsg) *errorMsg = "Cannot open " + filePath;
+        return false;
+    }
+    QStringList lines = QString::fromUtf8(f.readAll()).split('\n');
+    if (!lines.isEmpty() && lines.last().isEmpty()) lines.removeLast();
+
+    for (const QString &raw : lines) {
+        Line line{keyOf(raw), raw};
+        const QString v = valueOf(raw);
+        const QString &k = line.key;
+        if      (k.compare(KEY_RUNS,   Qt::CaseInsensitive) == 0) sc.numberOfModelRun   = v.section(',', 0, 0).toInt();
+        else if (k.compare(KEY_FLAG,   Qt::CaseInsensitive) == 0) sc.glueFlag           = v.section(',', 0, 0).toInt();
+        else if (k.compare(KEY_ECO,    Qt::CaseInsensitive) == 0) sc.ecotypeCalibration = v;
+        else if (k.compare(KEY_BATCH,  Qt::CaseInsensitive) == 0) sc.cultivarBatchFile  = v;
+        else if (k.compare(KEY_MODEL,  Qt::CaseInsensitive) == 0) sc.modelId            = v;
+        else if (k.compare(KEY_OUTPUT, Qt::CaseInsensitive) == 0) sc.outputDir          = v;
+        sc.m_lines << line;
+    }
+    return true;
+}
+
+bool SimulationControl::cached(const QString &filePath, SimulationControl &sc, QString *errorMsg)
+{
+    QFileInfo fi(filePath);
+    const QString key = fi.absoluteFilePath();
+    {
+        QMutexLocker lock(&s_cacheMutex);
+        auto it = s_cache.constFind(key);
+        if (it != s_cache.constEnd() && fi.exists() &&
+            it->size == fi.size() && it->modified == fi.lastModified()) {
+            sc = it->sc;
+            return true;
+        }
+    }
+    if (!load(filePath, sc, errorMsg)) return false;
+    QMutexLocker lock(&s_cacheMutex);
+    s_cache.insert(key, CacheEntry{fi.lastModified(), fi.size(), sc});
+    return true;
+}
+
+// ── fields ────────────────────────────────────────────────────────────────────
+void SimulationControl::configureJob(const CropInfo &cropInfo, const QString &cultivarId,
+                                     int runs, int flag, const QString &ecoCalib)
+{
+    numberOfModelRun   = runs;
+    glueFlag           = flag;
+    ecotypeCalibration = ecoCalib;
+    cultivarBatchFile  = QString("%1.%2C").arg(cultivarId, cropInfo.cropCode);
+    modelId            = cropInfo.modelId.isEmpty() ? cropInfo.module : cropInfo.modelId;
+}
+
+QString SimulationControl::value(const QString &key) const
+{
+    for (const Line &l : m_lines)
+        if (l.key.compare(key, Qt::CaseInsensitive) == 0) return valueOf(l.text);
+    return QString();
+}
+
+void SimulationControl::setValue(const QString &key, const QString &value)
+{
+    for (Line &l : m_lines) {
+        if (l.key.compare(key, Qt::CaseInsensitive) == 0) {
+            l.text = l.key + "," + value;
+            return;
+        }
+    }
+    m_lines << Line{key, key + "," + value};
+}
+
+QStringList SimulationControl::validate() const
+{
+    QStringList problems;
+    if (numberOfModelRun <= 0)
+        problems << QString("%1 must be a positive number of runs").arg(KEY_RUNS);
+    if (glueFlag < 1 || glueFlag > 3)
+        problems << QString("%1 must be 1, 2 or 3 (got %2)").arg(KEY_FLAG).arg(glueFlag);
+    if (ecotypeCalibration != "Y" && ecotypeCalibration != "N")
+        problems << QString("%1 must be Y or N (got \"%2\")").arg(KEY_ECO, ecotypeCalibration);
+    if (cultivarBatchFile.isEmpty() || !cultivarBatchFile.contains('.'))
+        problems << QString("%1 is not a cultivar batch file name").arg(KEY_BATCH);
+    if (modelId.size() != 8)
+        problems << QString("%1 \"%2\" is not an 8-character DSSAT model").arg(KEY_MODEL, modelId);
+    if (outputDir.isEmpty())
+        problems << QString("%1 (GLUE work directory) is not set").arg(KEY_OUTPUT);
+    return problems;
+}
+
+// ── render / write ────────────────────────────────────────────────────────────
+QString SimulationControl::render() const
+{
+    const QList<QPair<const char *, QString>> typed = {
+        {KEY_RUNS,   QString::number(numberOfModelRun)},
+        {KEY_FLAG,   QString::number(glueFlag)},
+        {KEY_ECO,    ecotypeCalibration},
+        {KEY_BATCH,  cultivarBatchFile},
+        {KEY_MODEL,  modelId},
+        {KEY_OUTPUT, outputDir},
+    };
+    QVector<bool> written(typed.size(), false);
+
+    QString out;
+    for (const Line &l : m_lines) {
+        int t = -1;
+        for (int i = 0; i < typed.size() && t < 0; ++i)
+            if (l.key.compare(typed[i].first, Qt::CaseInsensitive) == 0) t = i;
+        if (t < 0) {
+            out += l.text + "\n";
+        } else {
+            out += l.key + "," + typed[t].second + "\n";
+            written[t] = true;
+        }
+    }
+    // Keys the template lacked, when they have a value
+    for (int i = 0; i < typed.size(); ++i)
+        if (!written[i] && !typed[i].second.isEmpty() && typed[i].second != "0")
+            out += QString("%1,%2\n").arg(typed[i].first, typed[i].second);
+    return out;
+}
+
+bool SimulationControl::writeTo(const QString &filePath, QString *errorMsg) const
+{
+    QSaveFile f(filePath);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        if (errorMsg) *errorMsg = "Cannot write " + filePath;
+        return false;
+    }
+    f.write(render().toUtf8());
+    if (!f.commit()) {
+        if (errorMsg) *errorMsg = "Cannot write " + filePath;
+        return false;
+    }
+
+    QFileInfo fi(filePath);
+    QMutexLocker lock(&s_cacheMutex);
+    s_cache.insert(fi.absoluteFilePath(), CacheEntry{fi.lastModified(), fi.size(), *this});
+    return true;
+}
@@ -0,0 +1,308 @@
+#include "TableQuery.h"
+#include <functional>
+
+namespace {
+
+struct Token {
+    enum Type { Word, Op, Open, Close, End } type = End;
+    QString text;
+    bool    quoted = false;
+};
+
+bool isOpChar(QChar c)
+{
+    return c == '=' || c == '!' || c == '<' || c == '>' || c == '~';
+}
+
+QVector<Token> tokenize(const QString &text, QString *errorMsg)
+{
+    QVector<Token> tokens;
+    int i = 0;
+    const int n = text.size();
+    while (i < n) {
+        const QChar c = text[i];
+        if (c.isSpace()) { ++i; continue; }
+        Token t;
+        if (c == '(' || c == ')') {
+            t.type = c == '(' ? Token::Open : Token::Close;
+            t.text = c;
+            ++i;
+        } else if (c == '"') {
+            const int end = text.indexOf('"', i + 1);
+            if (end < 0) {
+                if (errorMsg) *errorMsg = "unterminated quote";
+                return {};
+            }
+            t.type = Token::Word;
+            t.text = text.mid(i + 1, end - i - 1);
+            t.quoted = true;
+            i = end + 1;
+        } else if (isOpChar(c)) {
+            int j = i;
+            while (j < n && isOpChar(text[j])) ++j;
+            t.type = Token::Op;
+            t.text = text.mid(i, j - i);
+            i = j;
+        } else {
+            int j = i;
+            while (j < n && !text[j].isSpace() && text[j] != '(' && text[j] != ')' &&
+                   text[j] != '"' && !isOpChar(text[j]))
+                ++j;
+            t.type = Token::Word;
+            t.text = text.mid(i, j - i);
+            i = j;
+        }
+        tokens.append(t);
+    }
+    tokens.append(Token());
+    return tokens;
+}
+
+bool isKeyword(const Token &t, const char *word)
+{
+    return t.type == Token::Word && !t.quoted && t.text == QLatin1String(word);
+}
+
+} // namespace
+
+// ── parser ────────────────────────────────────────────────────────────────────
+class TableQueryParser
+{
+public:
+    TableQueryParser(TableQuery &query, const QVector<Token> &tokens, const TableQuery::Schema &schema)
+        : q(query), m_tokens(tokens), m_schema(schema) {}
+
+    int parse()
+    {
+        const int root = parseOr();
+        if (root >= 0 && peek().type != Token::End)
+            return fail(QString("unexpected '%1'").arg(peek().text));
+        return root;
+    }
+    QString error;
+
+private:
+    const Token &peek() const { return m_tokens[m_pos]; }
+    const Token &next() { return m_tokens[m_pos++]; }
+    int fail(const QString &message) { if (error.isEmpty()) error = message; return -1; }
+
+    int add(const TableQuery::Node &node)
+    {
+        q.m_nodes.append(node);
+        return q.m_nodes.size() - 1;
+    }
+    int combine(TableQuery::Kind kind, int lhs, int rhs)
+    {
+        TableQuery::Node node;
+        node.kind = kind;
+        node.lhs  = lhs;
+        node.rhs  = rhs;
+        return add(node);
+    }
+
+    int parseOr()
+    {
+        int lhs = parseAnd();
+        while (lhs >= 0 && isKeyword(peek(), "OR")) {
+            next();
+            const int rhs = parseAnd();
+            if (rhs < 0) return -1;
+            lhs = combine(TableQuery::Or, lhs, rhs);
+        }
+        return lhs;
+    }
+
+    int parseAnd()
+    {
+        int lhs = parseUnary();
+        while (lhs >= 0) {
+            const Token &t = peek();
+            if (t.type == Token::End || t.type == Token::Close || isKeyword(t, "OR")) break;
+            if (isKeyword(t, "AND")) next();
+            const int rhs = parseUnary();
+            if (rhs < 0) return -1;
+            lhs = combine(TableQuery::And, lhs, rhs);
+        }
+        return lhs;
+    }
+
+    int parseUnary()
+    {
+        const Token &t = peek();
+        if (isKeyword(t, "NOT")) {
+            next();
+            const int operand = parseUnary();
+            return operand < 0 ? -1 : combine(TableQuery::Not, operand, -1);
+        }
+        if (t.type == Token::Open) {
+            next();
+            const int inner = parseOr();
+            if (inner < 0) return -1;
+            if (next().type != Token::Close) return fail("missing ')'");
+            return inner;
+        }
+        return parseTerm();
+    }
+
+    int parseTerm()
+    {
+        const Token word = next();
+        if (word.type != Token::Word || word.text.isEmpty())
+            return fail(word.type == Token::End ? QString("query ends too early")
+                                                : QString("unexpected '%1'").arg(word.text));
+        TableQuery::Node node;
+        if (peek().type != Token::Op) {
+            if (!word.quoted && m_schema.flags.contains(word.text, Qt::CaseInsensitive)) {
+                node.kind = TableQuery::Flag;
+                node.text = word.text.toLower();
+            } else {
+                node.kind = TableQuery::Search;
+                node.text = word.text;
+            }
+            return add(node);
+        }
+
+        const QString op = next().text;
+        const Token value = next();
+        if (value.type != Token::Word)
+            return fail(QString("'%1 %2' needs a value").arg(word.text, op));
+
+        node.kind = TableQuery::Compare;
+        node.column = -1;
+        for (int c = 0; c < m_schema.columns.size(); ++c)
+            if (m_schema.columns[c].compare(word.text, Qt::CaseInsensitive) == 0) { node.column = c; break; }
+        if (node.column < 0)
+            return fail(QString("unknown column '%1'").arg(word.text));
+
+        if      (op == "=" || op == "==") node.op = TableQuery::Eq;
+        else if (op == "!=")              node.op = TableQuery::Ne;
+        else if (op == "<")               node.op = TableQuery::Lt;
+        else if (op == "<=")              node.op = TableQuery::Le;
+        else if (op == ">")               node.op = TableQuery::Gt;
+        else if (op == ">=")              node.op = TableQuery::Ge;
+        else if (op == "~")               node.op = TableQuery::Contains;
+        else return fail(QString("unknown operator '%1'").arg(op));
+
+        node.numeric = node.column >= m_schema.firstNumeric;
+        if (node.numeric) {
+            if (node.op == TableQuery::Contains)
+                return fail(QString("'~' needs a text column, %1 holds numbers").arg(word.text));
+            bool ok = false;
+            node.number = value.text.toDouble(&ok);
+            if (!ok) return fail(QString("%1 holds numbers, '%2' is not one").arg(word.text, value.text));
+        } else {
+            node.text = value.text.trimmed().toLower();
+        }
+        return add(node);
+    }
+
+    TableQuery &q;
+    const QVector<Token> &m_tokens;
+    const TableQuery::Schema &m_schema;
+    int m_pos = 0;
+};
+
+// ── TableQuery ────────────────────────────────────────────────────────────────
+bool TableQuery::isStructured(const QString &text, const Schema &schema)
+{
+    const QVector<Token> tokens = tokenize(text, nullptr);
+    for (const Token &t : tokens) {
+        if (t.type == Token::Op || t.type == Token::Open || t.type == Token::Close || t.quoted)
+            return true;
+        if (isKeyword(t, "AND") || isKeyword(t, "OR") || isKeyword(t, "NOT"))
+            return true;
+        if (t.type == Token::Word && !t.quoted && schema.flags.contains(t.text, Qt::CaseInsensitive))
+            return true;
+    }
+    return false;
+}
+
+bool TableQuery::compile(const QString &text, const Schema &schema, QString *errorMsg)
+{
+    m_nodes.clear();
+    m_root = -1;
+    QString err;
+    const QVector<Token> tokens = tokenize(text, &err);
+    if (tokens.isEmpty()) {
+        if (errorMsg) *errorMsg = err;
+        return false;
+    }
+    if (tokens.size() == 1) {
+        if (errorMsg) *errorMsg = "empty query";
+        return false;
+    }
+    TableQueryParser parser(*this, tokens, schema);
+    const int root = parser.parse();
+    if (root < 0) {
+        m_nodes.clear();
+        if (errorMsg) *errorMsg = parser.error;
+        return false;
+    }
+    m_root = root;
+    return true;
+}
+
+QBitArray TableQuery::evaluate(const Reader &reader, int first, int count) const
+{
+    if (m_root < 0 || count <= 0) return QBitArray(qMax(0, count), true);
+    return eval(m_root, reader, first, count);
+}
+
+QBitArray TableQuery::eval(int index, const Reader &reader, int first, int count) const
+{
+    const Node &node = m_nodes[index];
+    switch (node.kind) {
+    case And:    return eval(node.lhs, reader, first, count) & eval(node.rhs, reader, first, count);
+    case Or:     return eval(node.lhs, reader, first, count) | eval(node.rhs, reader, first, count);
+    case Not:    return ~eval(node.lhs, reader, first, count);
+    case Flag:   return reader.readFlag(node.text, first, count);
+    case Search: return reader.readSearch(node.text, first, count);
+    case Compare: break;
+    }
+
+    QBitArray out(count);
+    if (node.numeric) {
+        QVector<double> values;
+        QBitArray present;
+        reader.readNumbers(node.column, first, count, &values, &present);
+        const double x = node.number;
+        const double *v = values.constData();
+        // One tight loop per operator, no branching on the op per cell
+        auto scan = [&](auto cmp) {
+            for (int i = 0; i < count; ++i)
+                if (cmp(v[i], x)) out.setBit(i);
+        };
+        switch (node.op) {
+        case Eq: scan(std::equal_to<double>());      break;
+        case Ne: scan(std::not_equal_to<double>());  break;
+        case Lt: scan(std::less<double>());          break;
+        case Le: scan(std::less_equal<double>());    break;
+        case Gt: scan(std::greater<double>());       break;
+        default: scan(std::greater_equal<double>()); break;
+        }
+        // Empty cells match nothing
+        return out & present;
+    }
+
+    QVector<QString> cells;
+    reader.readText(node.column, first, count, &cells);
+    for (int i = 0; i < count; ++i) {
+        const QString cell = cells[i].trimmed();
+        bool hit;
+        if (node.op == Contains) {
+            hit = cell.contains(node.text, Qt::CaseInsensitive);
+        } else {
+            const int cmp = cell.compare(node.text, Qt::CaseInsensitive);
+            switch (node.op) {
+            case Eq: hit = cmp == 0; break;
+            case Ne: hit = cmp != 0; break;
+            case Lt: hit = cmp <  0; break;
+            case Le: hit = cmp <= 0; break;
+            case Gt: hit = cmp >  0; break;
+            default: hit = cmp >= 0; break;
+            }
+        }
+        if (hit) out.setBit(i);
+    }
+    return out;
+}
@@ -0,0 +1,128 @@
+#include "TextSearchIndex.h"
+#include <algorithm>
+#include <iterator>
+
+QVector<TextSearchIndex::Trigram> TextSearchIndex::trigrams(const QString &lowered)
+{
+    QVector<Trigram> grams;
+    if (lowered.size() < 3) return grams;
+    grams.reserve(lowered.size() - 2);
+    const QChar *c = lowered.constData();
+    for (int i = 0; i + 2 < lowered.size(); ++i)
+        grams.append(Trigram(c[i].unicode()) << 32 | Trigram(c[i + 1].unicode()) << 16 | c[i + 2].unicode());
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+    return grams;
+}
+
+void TextSearchIndex::addPostings(int row)
+{
+    for (Trigram g : trigrams(m_keys[row])) {
+        QVector<int> &list = m_postings[g];
+        list.insert(std::lower_bound(list.begin(), list.end(), row), row);
+    }
+}
+
+void TextSearchIndex::dropPostings(int row)
+{
+    for (Trigram g : trigrams(m_keys[row])) {
+        auto it = m_postings.find(g);
+        if (it == m_postings.end()) continue;
+        QVector<int> &list = it.value();
+        auto pos = std::lower_bound(list.begin(), list.end(), row);
+        if (pos != list.end() && *pos == row) list.erase(pos);
+        if (list.isEmpty()) m_postings.erase(it);
+    }
+}
+
+// ── maintenance ───────────────────────────────────────────────────────────────
+void TextSearchIndex::reset(const QVector<QString> &keys)
+{
+    m_keys.clear();
+    m_keys.reserve(keys.size());
+    m_postings.clear();
+    for (int r = 0; r < keys.size(); ++r) {
+        m_keys.append(keys[r].toLower());
+        // Rows arrive in order, so appending keeps every list sorted
+        for (Trigram g : trigrams(m_keys[r]))
+            m_postings[g].append(r);
+    }
+}
+
+void TextSearchIndex::setKey(int row, const QString &key)
+{
+    if (row < 0 || row >= m_keys.size()) return;
+    const QString lowered = key.toLower();
+    if (lowered == m_keys[row]) return;
+    dropPostings(row);
+    m_keys[row] = lowered;
+    addPostings(row);
+}
+
+void TextSearchIndex::insertRows(int first, const QVector<QString> &keys)
+{
+    first = qBound(0, first, int(m_keys.size()));
+    const int count = keys.size();
+    if (count == 0) return;
+    if (first < m_keys.size()) {
+        for (QVector<int> &list : m_postings)
+            for (int &r : list)
+                if (r >= first) r += count;
+    }
+    for (int i = 0; i < count; ++i)
+        m_keys.insert(first + i, keys[i].toLower());
+    for (int i = 0; i < count; ++i)
+        addPostings(first + i);
+}
+
+void TextSearchIndex::removeRows(int first, int count)
+{
+    if (first < 0 || count <= 0 || first + count > m_keys.size()) return;
+    for (int r = first; r < first + count; ++r)
+        dropPostings(r);
+    m_keys.remove(first, count);
+    if (first < m_keys.size()) {
+        for (QVector<int> &list : m_postings)
+            for (int &r : list)
+                if (r >= first) r -= count;
+    }
+}
+
+// ── lookup ────────────────────────────────────────────────────────────────────
+bool TextSearchIndex::matches(int row, const QString &loweredText) const
+{
+    return row >= 0 && row < m_keys.size() && m_keys[row].contains(loweredText);
+}
+
+QVector<int> TextSearchIndex::find(const QString &text) const
+{
+    const QString q = text.toLower();
+    QVector<int> rows;
+    if (q.size() < 3) {
+        for (int r = 0; r < m_keys.size(); ++r)
+            if (q.isEmpty() || m_keys[r].contains(q)) rows.append(r);
+        return rows;
+    }
+
+    QVector<const QVector<int> *> lists;
+    for (Trigram g : trigrams(q)) {
+        auto it = m_postings.constFind(g);
+        if (it == m_postings.constEnd()) return rows;
+        lists.append(&it.value());
+    }
+    // Intersect from the rarest trigram up
+    std::sort(lists.begin(), lists.end(),
+              [](const QVector<int> *a, const QVector<int> *b) { return a->size() < b->size(); });
+    QVector<int> candidates = *lists.first();
+    QVector<int> next;
+    for (int i = 1; i < lists.size() && !candidates.isEmpty(); ++i) {
+        next.clear();
+        std::set_intersection(candidates.cbegin(), candidates.cend(),
+                              lists[i]->cbegin(), lists[i]->cend(), std::back_inserter(next));
+        candidates.swap(next);
+    }
+    // Shared trigrams do not guarantee the substring
+    for (int r : std::as_const(candidates))
+        if (m_keys[r].contains(q)) rows.append(r);
+    return rows;
+}